@@ -45,3 +45,62 @@ static void AccidentallyQuadratic(benchmark::State& state)
 
 // Register the function as a benchmark
 BENCHMARK(AccidentallyQuadratic);
+
+enum class CopyDefense
+{
+    None,     // Watchdog off, seed 0 in both maps
+    Watchdog, // The default: reseed once probes get long
+    Seeded,   // Random seed drawn before the copy
+};
+
+// The pattern from the article: copying a map into a new one by iterating it. Iteration yields
+// the keys in slot order, sorted by the low bits of their hash. While the new map is smaller than
+// the source, the keys it receives under the same hash all land in the front of its table and
+// every insertion walks the same growing cluster. With range(0) = 1.5M keys, the table without a
+// defense takes over a second per 100K keys; a different seed in the new map removes it
+static void AccidentallyQuadratic_CopyIntoNewMap(benchmark::State& state, CopyDefense defense)
+{
+    using M = optimap::HashMap<uint64_t, uint64_t>;
+    std::mt19937_64 rng(12345);
+    M source;
+    for (int64_t n = 0; n < state.range(0); ++n)
+    {
+        source[rng()] = n;
+    }
+
+    for (auto _ : state)
+    {
+        M copy;
+        if (defense == CopyDefense::None)
+        {
+            copy.set_probe_limit(0);
+        }
+        else if (defense == CopyDefense::Seeded)
+        {
+            copy.reseed();
+        }
+
+        for (const auto& entry : source)
+        {
+            copy[entry.first] = entry.second;
+        }
+        benchmark::DoNotOptimize(copy);
+
+        state.PauseTiming();
+        state.counters["reseeded"] = copy.seed() != 0;
+        state.counters["max_probe_length"] = static_cast<double>(copy.stats().max_probe_length);
+        state.ResumeTiming();
+    }
+}
+
+// The unprotected copy of 1.5M keys runs for over ten seconds, so it gets a single iteration
+BENCHMARK_CAPTURE(AccidentallyQuadratic_CopyIntoNewMap, None, CopyDefense::None)
+        ->Arg(1'500'000)
+        ->Iterations(1)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(AccidentallyQuadratic_CopyIntoNewMap, Watchdog, CopyDefense::Watchdog)
+        ->Arg(1'500'000)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(AccidentallyQuadratic_CopyIntoNewMap, Seeded, CopyDefense::Seeded)
+        ->Arg(1'500'000)
+        ->Unit(benchmark::kMillisecond);
@@ -1,12 +1,21 @@
 #include "absl/container/flat_hash_map.h"
+#include "frozen_hashmap.hpp"
 #include "hashmap.hpp"
+#include "hashset.hpp"
+#include "huge_page_allocator.hpp"
+#include "indirect_hashmap.hpp"
+#include "small_hashmap.hpp"
+#include "string_hashmap.hpp"
 
 #include <algorithm>
 #include <array>
 #include <benchmark/benchmark.h>
 #include <cstdint>
+#include <fstream>
 #include <random>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -62,6 +71,27 @@ struct Murmur3_64
     }
 };
 
+// Reports the table's shape next to the timings: load factor, share of occupied groups and mean
+// probe length from stats(). Build with -DOPTIMAP_ENABLE_COUNTERS to also get the probes, key
+// comparisons and h2 false positives per lookup made inside the timed loop
+template <typename Map> static void report_table(benchmark::State& state, Map& map)
+{
+    const optimap::TableStats stats = map.stats();
+    state.counters["load_factor"] = stats.load_factor;
+    state.counters["occupied_groups"] =
+            stats.groups ? static_cast<double>(stats.occupied_groups) / stats.groups : 0.0;
+    state.counters["mean_probe_length"] = stats.mean_probe_length;
+    state.counters["max_probe_length"] = static_cast<double>(stats.max_probe_length);
+
+#if defined(OPTIMAP_ENABLE_COUNTERS)
+    const optimap::OperationCounters counters = map.counters();
+    const double lookups = counters.lookups ? static_cast<double>(counters.lookups) : 1.0;
+    state.counters["probes_per_lookup"] = counters.probes / lookups;
+    state.counters["compares_per_lookup"] = counters.key_comparisons / lookups;
+    state.counters["h2_false_positives_per_lookup"] = counters.h2_false_positives / lookups;
+#endif
+}
+
 // Benchmark fixture for 32-bit integer key, 32-bit value
 class Int32Int32Fixture : public benchmark::Fixture
 {
@@ -139,6 +169,54 @@ BENCHMARK_REGISTER_F(Int32Int32Fixture, StdUnorderedMap_Insert)
 BENCHMARK_REGISTER_F(Int32Int32Fixture, AbslFlatHashMap_Insert)
         ->DenseRange(100000, 1000000, 100000);
 
+// Total time to insert N nonexisting keys into a map reserved for N elements up front
+BENCHMARK_DEFINE_F(Int32Int32Fixture, OptiMap_InsertReserved)(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        optimap::HashMap<uint32_t, uint32_t, Murmur3_32> map;
+        map.reserve(state.range(0));
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            map.insert(keys[i], keys[i]);
+        }
+    }
+}
+
+BENCHMARK_DEFINE_F(Int32Int32Fixture, StdUnorderedMap_InsertReserved)(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        std::unordered_map<uint32_t, uint32_t, Murmur3_32> map;
+        map.max_load_factor(0.875);
+        map.reserve(state.range(0));
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            map.insert({keys[i], keys[i]});
+        }
+    }
+}
+
+BENCHMARK_DEFINE_F(Int32Int32Fixture, AbslFlatHashMap_InsertReserved)(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        absl::flat_hash_map<uint32_t, uint32_t, Murmur3_32> map;
+        map.reserve(state.range(0));
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            map.insert({keys[i], keys[i]});
+        }
+    }
+}
+
+BENCHMARK_REGISTER_F(Int32Int32Fixture, OptiMap_InsertReserved)
+        ->DenseRange(100000, 1000000, 100000);
+BENCHMARK_REGISTER_F(Int32Int32Fixture, StdUnorderedMap_InsertReserved)
+        ->DenseRange(100000, 1000000, 100000);
+BENCHMARK_REGISTER_F(Int32Int32Fixture, AbslFlatHashMap_InsertReserved)
+        ->DenseRange(100000, 1000000, 100000);
+
 // Time to erase 1,000 existing keys with N keys in the table
 BENCHMARK_DEFINE_F(Int32Int32Fixture, OptiMap_EraseExisting)(benchmark::State& state)
 {
@@ -338,6 +416,7 @@ BENCHMARK_DEFINE_F(Int32Int32Fixture, OptiMap_LookupExisting)(benchmark::State&
     {
         map.insert(key, key);
     }
+    map.reset_counters();
     for (auto _ : state)
     {
         for (int i = 0; i < 1000; ++i)
@@ -345,6 +424,7 @@ BENCHMARK_DEFINE_F(Int32Int32Fixture, OptiMap_LookupExisting)(benchmark::State&
             map.find(keys[i]);
         }
     }
+    report_table(state, map);
 }
 
 BENCHMARK_DEFINE_F(Int32Int32Fixture, StdUnorderedMap_LookupExisting)(benchmark::State& state)
@@ -396,6 +476,7 @@ BENCHMARK_DEFINE_F(Int32Int32Fixture, OptiMap_LookupNonExisting)(benchmark::Stat
     {
         map.insert(key, key);
     }
+    map.reset_counters();
     for (auto _ : state)
     {
         for (int i = 0; i < 1000; ++i)
@@ -403,6 +484,7 @@ BENCHMARK_DEFINE_F(Int32Int32Fixture, OptiMap_LookupNonExisting)(benchmark::Stat
             map.find(non_existing_keys[i]);
         }
     }
+    report_table(state, map);
 }
 
 BENCHMARK_DEFINE_F(Int32Int32Fixture, StdUnorderedMap_LookupNonExisting)(benchmark::State& state)
@@ -503,6 +585,60 @@ BENCHMARK_REGISTER_F(Int32Int32Fixture, StdUnorderedMap_Iterate)
 BENCHMARK_REGISTER_F(Int32Int32Fixture, AbslFlatHashMap_Iterate)
         ->DenseRange(100000, 1000000, 100000);
 
+// Insert and lookup with the default GxHash instead of the Murmur3 finalizer, to track the cost of
+// the library's own integer hash
+BENCHMARK_DEFINE_F(Int32Int32Fixture, OptiMap_InsertGxHash)(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        optimap::HashMap<uint32_t, uint32_t> map;
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            map.insert(keys[i], keys[i]);
+        }
+        benchmark::DoNotOptimize(map);
+    }
+}
+
+BENCHMARK_DEFINE_F(Int32Int32Fixture, OptiMap_LookupExistingGxHash)(benchmark::State& state)
+{
+    optimap::HashMap<uint32_t, uint32_t> map;
+    for (uint32_t key : keys)
+    {
+        map.insert(key, key);
+    }
+    for (auto _ : state)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            benchmark::DoNotOptimize(map.find(keys[i]));
+        }
+    }
+}
+
+BENCHMARK_DEFINE_F(Int32Int32Fixture, OptiMap_LookupNonExistingGxHash)(benchmark::State& state)
+{
+    optimap::HashMap<uint32_t, uint32_t> map;
+    for (uint32_t key : keys)
+    {
+        map.insert(key, key);
+    }
+    for (auto _ : state)
+    {
+        for (uint32_t key : non_existing_keys)
+        {
+            benchmark::DoNotOptimize(map.find(key));
+        }
+    }
+}
+
+BENCHMARK_REGISTER_F(Int32Int32Fixture, OptiMap_InsertGxHash)
+        ->DenseRange(100000, 1000000, 300000);
+BENCHMARK_REGISTER_F(Int32Int32Fixture, OptiMap_LookupExistingGxHash)
+        ->DenseRange(100000, 1000000, 300000);
+BENCHMARK_REGISTER_F(Int32Int32Fixture, OptiMap_LookupNonExistingGxHash)
+        ->DenseRange(100000, 1000000, 300000);
+
 // ----------------------------------------------------------------------------
 
 // Benchmark fixture for 64-bit integer key, 448-bit value
@@ -1400,4 +1536,1164 @@ BENCHMARK_REGISTER_F(String16Value64Fixture, StdUnorderedMap_Iterate)
 BENCHMARK_REGISTER_F(String16Value64Fixture, AbslFlatHashMap_Iterate)
         ->DenseRange(100000, 1000000, 100000);
 
+// ----------------------------------------------------------------------------
+
+// Time to look up 1,000 nonexisting keys in a steady-size table of 100,000 keys after
+// range(0) full rounds of insert/erase churn. Misses probe until they hit an empty slot, so
+// this tracks probe length: it stays flat when tombstones are reclaimed
+template <typename Map> static void LookupNonExistingAfterChurn(benchmark::State& state)
+{
+    const uint64_t live = 100000;
+    const uint64_t churned = static_cast<uint64_t>(state.range(0)) * live;
+
+    Map map;
+    for (uint64_t key = 0; key < live; ++key)
+    {
+        map.insert({key, key});
+    }
+    for (uint64_t key = live; key < live + churned; ++key)
+    {
+        map.erase(key - live);
+        map.insert({key, key});
+    }
+
+    const uint64_t first_missing = live + churned;
+    for (auto _ : state)
+    {
+        for (uint64_t i = 0; i < 1000; ++i)
+        {
+            benchmark::DoNotOptimize(map.find(first_missing + i));
+        }
+    }
+
+    state.counters["capacity"] = static_cast<double>(map.bucket_count());
+}
+
+// Adapts optimap::HashMap to the std-style calls used by the generic churn benchmark
+struct OptiMapChurnAdapter : optimap::HashMap<uint64_t, uint64_t, Murmur3_64>
+{
+    void insert(const std::pair<uint64_t, uint64_t>& kv)
+    {
+        optimap::HashMap<uint64_t, uint64_t, Murmur3_64>::insert(kv.first, kv.second);
+    }
+
+    size_t bucket_count() const
+    {
+        return capacity();
+    }
+};
+
+BENCHMARK_TEMPLATE(LookupNonExistingAfterChurn, OptiMapChurnAdapter)
+        ->Arg(0)
+        ->Arg(1)
+        ->Arg(4)
+        ->Arg(16)
+        ->Arg(64);
+BENCHMARK_TEMPLATE(
+        LookupNonExistingAfterChurn,
+        absl::flat_hash_map<uint64_t, uint64_t, Murmur3_64>
+)
+        ->Arg(0)
+        ->Arg(1)
+        ->Arg(4)
+        ->Arg(16)
+        ->Arg(64);
+
+// ----------------------------------------------------------------------------
+
+// RandomFind-style fixture: N random 64-bit keys in the table, probed with 100,000 random queries
+// of which about half hit. Large N makes the table much bigger than the last-level cache
+class RandomFindFixture : public benchmark::Fixture
+{
+  public:
+    void SetUp(const ::benchmark::State& state)
+    {
+        const size_t num_keys = static_cast<size_t>(state.range(0));
+        std::mt19937_64 rng(123);
+
+        std::vector<uint64_t> keys(num_keys);
+        for (auto& key : keys)
+        {
+            key = rng();
+        }
+
+        map = optimap::HashMap<uint64_t, uint64_t>();
+        map.reserve(num_keys);
+        for (uint64_t key : keys)
+        {
+            map.insert(key, key);
+        }
+
+        queries.resize(100000);
+        for (auto& query : queries)
+        {
+            query = (rng() % 2 == 0) ? keys[rng() % num_keys] : rng();
+        }
+    }
+
+    optimap::HashMap<uint64_t, uint64_t> map;
+    std::vector<uint64_t> queries;
+};
+
+BENCHMARK_DEFINE_F(RandomFindFixture, OptiMap_FindScalar)(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        size_t found = 0;
+        for (uint64_t query : queries)
+        {
+            found += map.find(query) != map.end();
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK_DEFINE_F(RandomFindFixture, OptiMap_FindMany)(benchmark::State& state)
+{
+    std::vector<optimap::HashMap<uint64_t, uint64_t>::iterator> results(queries.size());
+    for (auto _ : state)
+    {
+        map.find_many(queries, results.begin());
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK_DEFINE_F(RandomFindFixture, OptiMap_ContainsScalar)(benchmark::State& state)
+{
+    std::vector<bool> results(queries.size());
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            results[i] = map.contains(queries[i]);
+        }
+        benchmark::DoNotOptimize(results);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK_DEFINE_F(RandomFindFixture, OptiMap_ContainsMany)(benchmark::State& state)
+{
+    std::vector<bool> results(queries.size());
+    for (auto _ : state)
+    {
+        map.contains_many(queries, results.begin());
+        benchmark::DoNotOptimize(results);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK_REGISTER_F(RandomFindFixture, OptiMap_FindScalar)->Arg(500000)->Arg(16000000);
+BENCHMARK_REGISTER_F(RandomFindFixture, OptiMap_FindMany)->Arg(500000)->Arg(16000000);
+BENCHMARK_REGISTER_F(RandomFindFixture, OptiMap_ContainsScalar)->Arg(500000)->Arg(16000000);
+BENCHMARK_REGISTER_F(RandomFindFixture, OptiMap_ContainsMany)->Arg(500000)->Arg(16000000);
+
+// ----------------------------------------------------------------------------
+
+// Time to look up 1,000 existing 16-char keys given as const char*. The temporary variant pays
+// for a std::string per query (16 chars is past the small-string buffer), the transparent variant
+// hashes and compares the c-string directly
+BENCHMARK_DEFINE_F(String16Value64Fixture, OptiMap_LookupCStringTemporary)(benchmark::State& state)
+{
+    optimap::HashMap<std::string, uint64_t> map;
+    for (const auto& key : keys)
+    {
+        map.insert(key, 0);
+    }
+    for (auto _ : state)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            benchmark::DoNotOptimize(map.find(std::string(keys[i].c_str())));
+        }
+    }
+}
+
+BENCHMARK_DEFINE_F(String16Value64Fixture, OptiMap_LookupCStringTransparent)
+(benchmark::State& state)
+{
+    optimap::HashMap<std::string, uint64_t> map;
+    for (const auto& key : keys)
+    {
+        map.insert(key, 0);
+    }
+    for (auto _ : state)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            benchmark::DoNotOptimize(map.find(keys[i].c_str()));
+        }
+    }
+}
+
+BENCHMARK_REGISTER_F(String16Value64Fixture, OptiMap_LookupCStringTemporary)
+        ->DenseRange(100000, 1000000, 300000);
+BENCHMARK_REGISTER_F(String16Value64Fixture, OptiMap_LookupCStringTransparent)
+        ->DenseRange(100000, 1000000, 300000);
+
+// ----------------------------------------------------------------------------
+
+// Total time to insert N nonexisting 64-char keys without reserving, so every doubling rehashes the
+// live keys. StoreHash reuses the cached hash instead of hashing the key bytes again
+template <bool StoreHash> static void OptiMap_InsertLongStrings(benchmark::State& state)
+{
+    const size_t num_keys = static_cast<size_t>(state.range(0));
+    std::vector<std::string> keys(num_keys);
+    for (size_t i = 0; i < num_keys; ++i)
+    {
+        keys[i] = std::to_string(i);
+        keys[i].resize(64, '#');
+    }
+
+    for (auto _ : state)
+    {
+        optimap::HashMap<std::string, uint64_t, optimap::GxHash<std::string>, StoreHash> map;
+        for (const auto& key : keys)
+        {
+            map.insert(key, 0);
+        }
+        benchmark::DoNotOptimize(map);
+    }
+}
+
+BENCHMARK_TEMPLATE(OptiMap_InsertLongStrings, false)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(OptiMap_InsertLongStrings, true)->Arg(100000)->Arg(1000000);
+
+// ----------------------------------------------------------------------------
+
+// Lookups in a table of 2^20 slots filled to range(0) percent, close to the 87.5% max load. Long
+// probe sequences dominate here, so this is the benchmark for choosing OPTIMAP_GROUP_WIDTH; the
+// width of the current build is reported in the label
+class HighLoadFixture : public benchmark::Fixture
+{
+  public:
+    static constexpr size_t kSlots = size_t{1} << 20;
+
+    void SetUp(const ::benchmark::State& state)
+    {
+        const size_t num_keys = kSlots * static_cast<size_t>(state.range(0)) / 100;
+
+        std::mt19937_64 rng(42);
+        keys.resize(num_keys);
+        for (auto& key : keys)
+        {
+            key = rng();
+        }
+        missing_keys.resize(1000);
+        for (auto& key : missing_keys)
+        {
+            key = rng();
+        }
+
+        map = optimap::HashMap<uint64_t, uint64_t>(kSlots);
+        for (const auto key : keys)
+        {
+            map.insert(key, key);
+        }
+        std::shuffle(keys.begin(), keys.end(), rng);
+        map.reset_counters();
+    }
+
+    void TearDown(const ::benchmark::State&)
+    {
+        map = optimap::HashMap<uint64_t, uint64_t>();
+    }
+
+    std::vector<uint64_t> keys;
+    std::vector<uint64_t> missing_keys;
+    optimap::HashMap<uint64_t, uint64_t> map;
+};
+
+// Time to look up 1,000 existing keys
+BENCHMARK_DEFINE_F(HighLoadFixture, OptiMap_LookupExisting)(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            benchmark::DoNotOptimize(map.find(keys[i]));
+        }
+    }
+    state.SetLabel("group width " + std::to_string(OPTIMAP_GROUP_WIDTH));
+    report_table(state, map);
+}
+
+// Time to look up 1,000 nonexisting keys. Every miss walks its probe sequence to an empty slot
+BENCHMARK_DEFINE_F(HighLoadFixture, OptiMap_LookupNonExisting)(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        for (const auto key : missing_keys)
+        {
+            benchmark::DoNotOptimize(map.find(key));
+        }
+    }
+    state.SetLabel("group width " + std::to_string(OPTIMAP_GROUP_WIDTH));
+    report_table(state, map);
+}
+
+BENCHMARK_REGISTER_F(HighLoadFixture, OptiMap_LookupExisting)->Arg(80)->Arg(85)->Arg(87);
+BENCHMARK_REGISTER_F(HighLoadFixture, OptiMap_LookupNonExisting)->Arg(80)->Arg(85)->Arg(87);
+
+// ----------------------------------------------------------------------------
+
+// Large tables on the default allocator against HugePageAllocator. Random probes into tables of
+// hundreds of MB are bound by TLB misses, which huge pages reduce; zero-filled mappings also
+// skip the control byte initialization pass on every growth step. The InsertHugeInt and
+// RandomFind_500000 shapes at sizes where the table outgrows the TLB reach of 4K pages
+using DefaultAllocatorMap = optimap::HashMap<uint64_t, uint64_t>;
+using HugePageMap = optimap::HashMap<
+        uint64_t,
+        uint64_t,
+        optimap::GxHash<uint64_t>,
+        false,
+        optimap::HugePageAllocator<std::pair<const uint64_t, uint64_t>>>;
+
+// Inserts range(0) random keys into an empty map, growing through every capacity
+template <typename Map> static void OptiMap_InsertHugeInt(benchmark::State& state)
+{
+    const size_t num_keys = static_cast<size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        std::mt19937_64 rng(123);
+        Map map;
+        for (size_t i = 0; i < num_keys; ++i)
+        {
+            map.emplace(rng(), i);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * num_keys);
+}
+
+// Looks up 500,000 random keys, half of them present, in a map of range(0) entries
+template <typename Map> static void OptiMap_RandomFind_500000(benchmark::State& state)
+{
+    const size_t num_keys = static_cast<size_t>(state.range(0));
+    std::mt19937_64 rng(321);
+    Map map;
+    map.reserve(num_keys);
+    std::vector<uint64_t> queries;
+    queries.reserve(500000);
+    for (size_t i = 0; i < num_keys; ++i)
+    {
+        const uint64_t key = rng();
+        map.emplace(key, i);
+        if (queries.size() < 250000)
+        {
+            queries.push_back(key);
+        }
+    }
+    while (queries.size() < 500000)
+    {
+        queries.push_back(rng());
+    }
+    std::shuffle(queries.begin(), queries.end(), rng);
+
+    for (auto _ : state)
+    {
+        size_t found = 0;
+        for (const auto key : queries)
+        {
+            found += map.contains(key);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK_TEMPLATE(OptiMap_InsertHugeInt, DefaultAllocatorMap)
+        ->Arg(size_t{1} << 24)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(OptiMap_InsertHugeInt, HugePageMap)
+        ->Arg(size_t{1} << 24)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(OptiMap_RandomFind_500000, DefaultAllocatorMap)
+        ->Arg(size_t{1} << 20)
+        ->Arg(size_t{1} << 24)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(OptiMap_RandomFind_500000, HugePageMap)
+        ->Arg(size_t{1} << 20)
+        ->Arg(size_t{1} << 24)
+        ->Unit(benchmark::kMillisecond);
+
+// ----------------------------------------------------------------------------
+
+// Copying and clearing small maps, as a per-request map does. int -> int entries take the
+// block copy and in-place clear paths; std::string values take the per-entry ones
+template <typename Value> static Value make_value(int i)
+{
+    if constexpr (std::is_same_v<Value, std::string>)
+    {
+        return std::to_string(i);
+    }
+    else
+    {
+        return i;
+    }
+}
+
+template <typename Value> static void OptiMap_CopySmall(benchmark::State& state)
+{
+    optimap::HashMap<int, Value> map;
+    for (int i = 0; i < state.range(0); ++i)
+    {
+        map.emplace(i, make_value<Value>(i));
+    }
+
+    for (auto _ : state)
+    {
+        optimap::HashMap<int, Value> copy(map);
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+template <typename Value> static void OptiMap_RefillAfterClear(benchmark::State& state)
+{
+    optimap::HashMap<int, Value> map;
+    for (auto _ : state)
+    {
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            map.emplace(i, make_value<Value>(i));
+        }
+        map.clear();
+        benchmark::DoNotOptimize(map);
+    }
+}
+
+BENCHMARK_TEMPLATE(OptiMap_CopySmall, int)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(OptiMap_CopySmall, std::string)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(OptiMap_RefillAfterClear, int)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(OptiMap_RefillAfterClear, std::string)->Arg(16)->Arg(256)->Arg(4096);
+
+// ----------------------------------------------------------------------------
+
+// Cold start of a saved 4M-entry table: rebuilding it from its keys, reading the saved file into
+// memory, and mapping the file in place
+static constexpr uint64_t kSavedTableSize = uint64_t{1} << 22;
+
+static const std::string& saved_table_path()
+{
+    static const std::string path = [] {
+        std::string file = "/tmp/optimap_benchmark_table.bin";
+        optimap::HashMap<uint64_t, uint64_t> map;
+        for (uint64_t key = 0; key < kSavedTableSize; ++key)
+        {
+            map.insert(key, key);
+        }
+        map.save(file);
+        return file;
+    }();
+    return path;
+}
+
+static void OptiMap_ColdStartRebuild(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        optimap::HashMap<uint64_t, uint64_t> map;
+        map.reserve(kSavedTableSize);
+        for (uint64_t key = 0; key < kSavedTableSize; ++key)
+        {
+            map.insert(key, key);
+        }
+        benchmark::DoNotOptimize(map.find(kSavedTableSize / 2));
+    }
+}
+
+static void OptiMap_ColdStartReadFrom(benchmark::State& state)
+{
+    const std::string& path = saved_table_path();
+    for (auto _ : state)
+    {
+        std::ifstream in(path, std::ios::binary);
+        auto map = optimap::HashMap<uint64_t, uint64_t>::read_from(in);
+        benchmark::DoNotOptimize(map.find(kSavedTableSize / 2));
+    }
+}
+
+static void OptiMap_ColdStartOpenMapped(benchmark::State& state)
+{
+    const std::string& path = saved_table_path();
+    for (auto _ : state)
+    {
+        auto map = optimap::HashMap<uint64_t, uint64_t>::open_mapped(path);
+        benchmark::DoNotOptimize(map->find(kSavedTableSize / 2));
+    }
+}
+
+BENCHMARK(OptiMap_ColdStartRebuild)->Unit(benchmark::kMillisecond);
+BENCHMARK(OptiMap_ColdStartReadFrom)->Unit(benchmark::kMillisecond);
+BENCHMARK(OptiMap_ColdStartOpenMapped)->Unit(benchmark::kMicrosecond);
+
+// ----------------------------------------------------------------------------
+
+// Read-only lookups: FrozenHashMap (one group probe, packed groups, separate key and value
+// arrays) against the HashMap it was built from. Half of the queries miss
+template <bool Frozen> static void OptiMap_ReadOnlyLookup(benchmark::State& state)
+{
+    const size_t num_keys = static_cast<size_t>(state.range(0));
+    std::mt19937_64 rng(99);
+    optimap::HashMap<uint64_t, uint64_t> map;
+    std::vector<uint64_t> queries;
+    for (size_t i = 0; i < num_keys; ++i)
+    {
+        const uint64_t key = rng();
+        map.insert(key, i);
+        queries.push_back(i % 2 == 0 ? key : rng());
+    }
+    std::shuffle(queries.begin(), queries.end(), rng);
+    const optimap::FrozenHashMap<uint64_t, uint64_t> frozen(map);
+
+    for (auto _ : state)
+    {
+        size_t found = 0;
+        for (const auto key : queries)
+        {
+            if constexpr (Frozen)
+            {
+                found += frozen.contains(key);
+            }
+            else
+            {
+                found += map.contains(key);
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+    state.counters["load"] = Frozen ? static_cast<double>(frozen.size()) / frozen.capacity()
+                                    : static_cast<double>(map.size()) / map.capacity();
+}
+
+BENCHMARK_TEMPLATE(OptiMap_ReadOnlyLookup, false)->Arg(10000)->Arg(1000000);
+BENCHMARK_TEMPLATE(OptiMap_ReadOnlyLookup, true)->Arg(10000)->Arg(1000000);
+
+// ----------------------------------------------------------------------------
+
+// URL cache: N URL-like keys of 40-70 characters. StringHashMap keeps 16-byte keys in the slots
+// and the characters in its arena; HashMap<std::string> stores 32-byte strings, each with its
+// own heap block. Lookups are half hits
+static std::vector<std::string> make_urls(size_t n, std::mt19937_64& rng)
+{
+    std::vector<std::string> urls(n);
+    for (auto& url : urls)
+    {
+        url = "https://cdn.example.com/assets/" + std::to_string(rng()) + "/index.html";
+    }
+    return urls;
+}
+
+template <typename Map> static void OptiMap_UrlCacheInsert(benchmark::State& state)
+{
+    std::mt19937_64 rng(7);
+    const auto urls = make_urls(static_cast<size_t>(state.range(0)), rng);
+
+    for (auto _ : state)
+    {
+        Map map;
+        for (const auto& url : urls)
+        {
+            map.insert(url, 0);
+        }
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * urls.size());
+}
+
+template <typename Map> static void OptiMap_UrlCacheLookup(benchmark::State& state)
+{
+    std::mt19937_64 rng(7);
+    const auto urls = make_urls(static_cast<size_t>(state.range(0)), rng);
+    const auto misses = make_urls(urls.size(), rng);
+
+    Map map;
+    std::vector<std::string_view> queries;
+    for (size_t i = 0; i < urls.size(); ++i)
+    {
+        map.insert(urls[i], i);
+        queries.push_back(i % 2 == 0 ? std::string_view(urls[i]) : std::string_view(misses[i]));
+    }
+    std::shuffle(queries.begin(), queries.end(), rng);
+
+    for (auto _ : state)
+    {
+        size_t found = 0;
+        for (const auto query : queries)
+        {
+            found += map.find(query) != map.end();
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+using StdStringUrlMap = optimap::HashMap<std::string, uint64_t, optimap::GxHash<std::string>>;
+using ArenaUrlMap = optimap::StringHashMap<uint64_t>;
+
+BENCHMARK_TEMPLATE(OptiMap_UrlCacheInsert, StdStringUrlMap)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(OptiMap_UrlCacheInsert, ArenaUrlMap)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(OptiMap_UrlCacheLookup, StdStringUrlMap)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(OptiMap_UrlCacheLookup, ArenaUrlMap)->Arg(100000)->Arg(1000000);
+
+// ----------------------------------------------------------------------------
+
+// Large values inline (HashMap) or in IndirectHashMap's value slab. Growth moves whole entries
+// in the first and only keys and 32-bit indices in the second. Lookups of random existing keys
+// read the first byte of the value
+struct Value3584
+{
+    std::array<uint8_t, 448> data;
+};
+
+template <typename Value> using InlineLargeMap = optimap::HashMap<uint64_t, Value>;
+template <typename Value> using IndirectLargeMap = optimap::IndirectHashMap<uint64_t, Value>;
+
+template <typename Map> static void OptiMap_LargeValueInsert(benchmark::State& state)
+{
+    const uint64_t num_keys = static_cast<uint64_t>(state.range(0));
+    for (auto _ : state)
+    {
+        Map map;
+        for (uint64_t key = 0; key < num_keys; ++key)
+        {
+            map.try_emplace(key);
+        }
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * num_keys);
+}
+
+template <typename Map> static void OptiMap_LargeValueLookup(benchmark::State& state)
+{
+    const uint64_t num_keys = static_cast<uint64_t>(state.range(0));
+    Map map;
+    for (uint64_t key = 0; key < num_keys; ++key)
+    {
+        map.try_emplace(key);
+    }
+    std::vector<uint64_t> queries(1000);
+    std::mt19937_64 rng(3);
+    for (auto& query : queries)
+    {
+        query = rng() % num_keys;
+    }
+
+    for (auto _ : state)
+    {
+        uint64_t sum = 0;
+        for (const auto key : queries)
+        {
+            sum += map.find(key)->second.data[0];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK_TEMPLATE(OptiMap_LargeValueInsert, InlineLargeMap<Value448>)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(OptiMap_LargeValueInsert, IndirectLargeMap<Value448>)
+        ->Arg(100000)
+        ->Arg(1000000);
+BENCHMARK_TEMPLATE(OptiMap_LargeValueInsert, InlineLargeMap<Value3584>)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(OptiMap_LargeValueInsert, IndirectLargeMap<Value3584>)
+        ->Arg(100000)
+        ->Arg(1000000);
+BENCHMARK_TEMPLATE(OptiMap_LargeValueLookup, InlineLargeMap<Value448>)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(OptiMap_LargeValueLookup, IndirectLargeMap<Value448>)
+        ->Arg(100000)
+        ->Arg(1000000);
+BENCHMARK_TEMPLATE(OptiMap_LargeValueLookup, InlineLargeMap<Value3584>)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(OptiMap_LargeValueLookup, IndirectLargeMap<Value3584>)
+        ->Arg(100000)
+        ->Arg(1000000);
+
+// ----------------------------------------------------------------------------
+
+// Counting workload: 1M increments over range(0) distinct keys, drawn at random. FindThenInsert
+// is the pattern the bool-returning emplace forced: a lookup, then a second probe to insert a
+// missing key. TryEmplace does one probe per update and returns the entry either way
+enum class CountUpdate
+{
+    FindThenInsert,
+    TryEmplace,
+    Subscript,
+};
+
+static void OptiMap_CountUpdates(benchmark::State& state, CountUpdate update)
+{
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> events(1000000);
+    for (auto& event : events)
+    {
+        event = rng() % static_cast<uint64_t>(state.range(0));
+    }
+
+    for (auto _ : state)
+    {
+        optimap::HashMap<uint64_t, uint64_t> counts;
+        for (const auto key : events)
+        {
+            switch (update)
+            {
+            case CountUpdate::FindThenInsert:
+                if (auto it = counts.find(key); it != counts.end())
+                {
+                    ++it->second;
+                }
+                else
+                {
+                    counts.insert(key, 1);
+                }
+                break;
+            case CountUpdate::TryEmplace:
+                ++counts.try_emplace(key, 0).first->second;
+                break;
+            case CountUpdate::Subscript:
+                ++counts[key];
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(counts);
+    }
+    state.SetItemsProcessed(state.iterations() * events.size());
+}
+
+BENCHMARK_CAPTURE(OptiMap_CountUpdates, FindThenInsert, CountUpdate::FindThenInsert)
+        ->Arg(1000)
+        ->Arg(100000)
+        ->Arg(1000000);
+BENCHMARK_CAPTURE(OptiMap_CountUpdates, TryEmplace, CountUpdate::TryEmplace)
+        ->Arg(1000)
+        ->Arg(100000)
+        ->Arg(1000000);
+BENCHMARK_CAPTURE(OptiMap_CountUpdates, Subscript, CountUpdate::Subscript)
+        ->Arg(1000)
+        ->Arg(100000)
+        ->Arg(1000000);
+
+// TTL sweep: every entry holds an expiry time and a sweep erases the ~10% that have expired.
+// ByKey is the lookup-per-erase cost of erasing each expired key by name, WhileIterating erases
+// through the iterator, and EraseIf retires whole groups at once
+enum class Sweep
+{
+    ByKey,
+    WhileIterating,
+    EraseIf,
+};
+
+static void OptiMap_ExpirySweep(benchmark::State& state, Sweep sweep)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::mt19937_64 rng(11);
+    optimap::HashMap<uint64_t, uint64_t> prototype;
+    prototype.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        prototype.insert(rng(), rng() % 100);
+    }
+    const uint64_t now = 10;
+    const auto expired = [now](const auto& entry) { return entry.second < now; };
+
+    std::vector<uint64_t> expired_keys;
+    size_t erased = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto map = prototype;
+        state.ResumeTiming();
+
+        switch (sweep)
+        {
+        case Sweep::ByKey:
+            expired_keys.clear();
+            for (const auto& entry : map)
+            {
+                if (expired(entry))
+                {
+                    expired_keys.push_back(entry.first);
+                }
+            }
+            for (const auto key : expired_keys)
+            {
+                map.erase(key);
+            }
+            break;
+        case Sweep::WhileIterating:
+            for (auto it = map.begin(); it != map.end();)
+            {
+                if (expired(*it))
+                {
+                    it = map.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            break;
+        case Sweep::EraseIf:
+            map.erase_if(expired);
+            break;
+        }
+        erased = n - map.size();
+        benchmark::DoNotOptimize(map);
+    }
+    state.counters["erased"] = static_cast<double>(erased);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_CAPTURE(OptiMap_ExpirySweep, ByKey, Sweep::ByKey)
+        ->Arg(1000000)
+        ->Arg(10000000)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(OptiMap_ExpirySweep, WhileIterating, Sweep::WhileIterating)
+        ->Arg(1000000)
+        ->Arg(10000000)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(OptiMap_ExpirySweep, EraseIf, Sweep::EraseIf)
+        ->Arg(1000000)
+        ->Arg(10000000)
+        ->Unit(benchmark::kMillisecond);
+
+// ----------------------------------------------------------------------------
+
+// Linear against aligned triangular probing, with absl::flat_hash_map (which probes
+// triangularly too) as the reference. range(0) keys per 100 slots of a 2^20-slot table: lookups
+// of present and absent keys, and building the table with its capacity reserved. All three
+// use GxHash, so only the table layout and probing differ
+template <typename Policy>
+using ProbePolicyMap = optimap::HashMap<
+        uint64_t,
+        uint64_t,
+        optimap::GxHash<uint64_t>,
+        false,
+        AlignedAllocator<std::pair<const uint64_t, uint64_t>, 64>,
+        Policy>;
+using LinearProbeMap = ProbePolicyMap<optimap::LinearProbing>;
+using TriangularProbeMap = ProbePolicyMap<optimap::TriangularProbing>;
+using AbslProbeMap = absl::flat_hash_map<uint64_t, uint64_t, optimap::GxHash<uint64_t>>;
+
+static constexpr size_t kProbePolicySlots = size_t{1} << 20;
+
+template <typename Map> static Map build_probe_policy_map(const std::vector<uint64_t>& keys)
+{
+    Map map;
+    map.reserve(keys.size());
+    for (const auto key : keys)
+    {
+        map.emplace(key, key);
+    }
+    return map;
+}
+
+static std::vector<uint64_t> probe_policy_keys(size_t count, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<uint64_t> keys(count);
+    for (auto& key : keys)
+    {
+        key = rng();
+    }
+    return keys;
+}
+
+template <typename Map> static void ProbePolicy_Build(benchmark::State& state)
+{
+    const auto keys =
+            probe_policy_keys(kProbePolicySlots * static_cast<size_t>(state.range(0)) / 100, 42);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(build_probe_policy_map<Map>(keys));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Map, bool Existing> static void ProbePolicy_Lookup(benchmark::State& state)
+{
+    auto keys =
+            probe_policy_keys(kProbePolicySlots * static_cast<size_t>(state.range(0)) / 100, 42);
+    const Map map = build_probe_policy_map<Map>(keys);
+    if constexpr (Existing)
+    {
+        std::shuffle(keys.begin(), keys.end(), std::mt19937_64(1));
+    }
+    else
+    {
+        keys = probe_policy_keys(keys.size(), 43);
+    }
+
+    size_t found = 0;
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < 10000; ++i)
+        {
+            found += map.find(keys[i]) != map.end();
+        }
+    }
+    benchmark::DoNotOptimize(found);
+    state.SetItemsProcessed(state.iterations() * 10000);
+}
+
+BENCHMARK_TEMPLATE(ProbePolicy_Build, LinearProbeMap)->Arg(50)->Arg(80)->Arg(87);
+BENCHMARK_TEMPLATE(ProbePolicy_Build, TriangularProbeMap)->Arg(50)->Arg(80)->Arg(87);
+BENCHMARK_TEMPLATE(ProbePolicy_Build, AbslProbeMap)->Arg(50)->Arg(80)->Arg(87);
+BENCHMARK_TEMPLATE(ProbePolicy_Lookup, LinearProbeMap, true)->Arg(50)->Arg(80)->Arg(87);
+BENCHMARK_TEMPLATE(ProbePolicy_Lookup, TriangularProbeMap, true)->Arg(50)->Arg(80)->Arg(87);
+BENCHMARK_TEMPLATE(ProbePolicy_Lookup, AbslProbeMap, true)->Arg(50)->Arg(80)->Arg(87);
+BENCHMARK_TEMPLATE(ProbePolicy_Lookup, LinearProbeMap, false)->Arg(50)->Arg(80)->Arg(87);
+BENCHMARK_TEMPLATE(ProbePolicy_Lookup, TriangularProbeMap, false)->Arg(50)->Arg(80)->Arg(87);
+BENCHMARK_TEMPLATE(ProbePolicy_Lookup, AbslProbeMap, false)->Arg(50)->Arg(80)->Arg(87);
+
+// ----------------------------------------------------------------------------
+
+// Lifecycle of a tiny map, as in per-request attribute maps or adjacency lists: construct, insert
+// range(0) keys, look each one up, destroy. HashMap and absl allocate a table on the first
+// insert; SmallHashMap keeps up to 8 entries inline and only spills past that
+using TinyMap = optimap::HashMap<uint64_t, uint64_t>;
+using TinySmallMap = optimap::SmallHashMap<uint64_t, uint64_t, 8>;
+using TinyAbslMap = absl::flat_hash_map<uint64_t, uint64_t, optimap::GxHash<uint64_t>>;
+
+template <typename Map> static void TinyMap_Lifecycle(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<uint64_t> keys(n);
+    std::mt19937_64 rng(31);
+    for (auto& key : keys)
+    {
+        key = rng();
+    }
+
+    for (auto _ : state)
+    {
+        Map map;
+        for (const auto key : keys)
+        {
+            map.emplace(key, key);
+        }
+        uint64_t sum = 0;
+        for (const auto key : keys)
+        {
+            sum += map.find(key)->second;
+        }
+        benchmark::DoNotOptimize(sum);
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(TinyMap_Lifecycle, TinyMap)->Arg(0)->Arg(1)->Arg(4)->Arg(8)->Arg(12);
+BENCHMARK_TEMPLATE(TinyMap_Lifecycle, TinySmallMap)->Arg(0)->Arg(1)->Arg(4)->Arg(8)->Arg(12);
+BENCHMARK_TEMPLATE(TinyMap_Lifecycle, TinyAbslMap)->Arg(0)->Arg(1)->Arg(4)->Arg(8)->Arg(12);
+
+// ----------------------------------------------------------------------------
+
+// Dedup of range(0) random 32-bit keys, about half of them repeats. DedupMap is the
+// HashMap<uint32_t, char> workaround, whose 8-byte slots are what a map to an empty struct took
+// before empty values stopped taking space. DedupSet stores 4-byte keys, and InsertMany is its
+// batched, prefetching insert. bytes_per_key is the table block over the distinct keys
+static size_t g_dedup_live_bytes = 0;
+
+template <typename T> struct DedupCountingAllocator
+{
+    using value_type = T;
+
+    DedupCountingAllocator() = default;
+    template <typename U> DedupCountingAllocator(const DedupCountingAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        g_dedup_live_bytes += n * sizeof(T);
+        return AlignedAllocator<T, 64>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        g_dedup_live_bytes -= n * sizeof(T);
+        AlignedAllocator<T, 64>().deallocate(p, n);
+    }
+
+    template <typename U> bool operator==(const DedupCountingAllocator<U>&) const
+    {
+        return true;
+    }
+};
+
+using DedupMap = optimap::HashMap<
+        uint32_t,
+        char,
+        optimap::GxHash<uint32_t>,
+        false,
+        DedupCountingAllocator<std::pair<const uint32_t, char>>>;
+using DedupSet = optimap::HashSet<
+        uint32_t,
+        optimap::GxHash<uint32_t>,
+        false,
+        DedupCountingAllocator<uint32_t>>;
+
+enum class DedupInsert
+{
+    Map,
+    Set,
+    SetInsertMany
+};
+
+static void OptiMap_Dedup(benchmark::State& state, DedupInsert insert)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<uint32_t> keys(n);
+    std::mt19937 rng(43);
+    for (auto& key : keys)
+    {
+        key = static_cast<uint32_t>(rng() % n);
+    }
+
+    size_t distinct = 0;
+    size_t table_bytes = 0;
+    for (auto _ : state)
+    {
+        if (insert == DedupInsert::Map)
+        {
+            DedupMap map;
+            for (const auto key : keys)
+            {
+                map.insert(key, 0);
+            }
+            distinct = map.size();
+            table_bytes = g_dedup_live_bytes;
+            benchmark::DoNotOptimize(map);
+        }
+        else
+        {
+            DedupSet set;
+            if (insert == DedupInsert::Set)
+            {
+                for (const auto key : keys)
+                {
+                    set.insert(key);
+                }
+            }
+            else
+            {
+                set.insert_many(keys);
+            }
+            distinct = set.size();
+            table_bytes = g_dedup_live_bytes;
+            benchmark::DoNotOptimize(set);
+        }
+    }
+    state.counters["bytes_per_key"] = static_cast<double>(table_bytes) / distinct;
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_CAPTURE(OptiMap_Dedup, Map, DedupInsert::Map)
+        ->Arg(100000)
+        ->Arg(10000000)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(OptiMap_Dedup, Set, DedupInsert::Set)
+        ->Arg(100000)
+        ->Arg(10000000)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(OptiMap_Dedup, SetInsertMany, DedupInsert::SetInsertMany)
+        ->Arg(100000)
+        ->Arg(10000000)
+        ->Unit(benchmark::kMillisecond);
+
+// ----------------------------------------------------------------------------
+
+// Full scan summing the values of range(0) entries: the iterator, for_each, for_each_group
+// (one callback per control group) and parallel_for_each on every hardware thread
+enum class Scan
+{
+    Iterator,
+    ForEach,
+    ForEachGroup,
+    Parallel
+};
+
+static void OptiMap_IterateIntegers(benchmark::State& state, Scan scan)
+{
+    using Map = optimap::HashMap<uint64_t, uint64_t>;
+    const size_t n = static_cast<size_t>(state.range(0));
+    Map map;
+    map.reserve(n);
+    std::mt19937_64 rng(47);
+    while (map.size() < n)
+    {
+        const uint64_t key = rng();
+        map.insert(key, key >> 32);
+    }
+    const size_t threads = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+
+    for (auto _ : state)
+    {
+        uint64_t sum = 0;
+        switch (scan)
+        {
+        case Scan::Iterator:
+            for (const auto& entry : map)
+            {
+                sum += entry.second;
+            }
+            break;
+        case Scan::ForEach:
+            map.for_each([&sum](const Map::Entry& entry) { sum += entry.second; });
+            break;
+        case Scan::ForEachGroup:
+            map.for_each_group([&sum](const Map::group_entries& group) {
+                uint64_t group_sum = 0;
+                for (const Map::Entry& entry : group)
+                {
+                    group_sum += entry.second;
+                }
+                sum += group_sum;
+            });
+            break;
+        case Scan::Parallel:
+        {
+            // One partial sum per worker, each on its own cache line
+            struct alignas(64) Partial
+            {
+                uint64_t sum = 0;
+            };
+            std::vector<Partial> partials(threads);
+            map.parallel_for_each(
+                    [&partials](const Map::Entry& entry, size_t worker) {
+                        partials[worker].sum += entry.second;
+                    },
+                    threads
+            );
+            for (const Partial& partial : partials)
+            {
+                sum += partial.sum;
+            }
+            break;
+        }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_CAPTURE(OptiMap_IterateIntegers, Iterator, Scan::Iterator)
+        ->Arg(1000000)
+        ->Arg(20000000)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(OptiMap_IterateIntegers, ForEach, Scan::ForEach)
+        ->Arg(1000000)
+        ->Arg(20000000)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(OptiMap_IterateIntegers, ForEachGroup, Scan::ForEachGroup)
+        ->Arg(1000000)
+        ->Arg(20000000)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(OptiMap_IterateIntegers, Parallel, Scan::Parallel)
+        ->Arg(1000000)
+        ->Arg(20000000)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+
 BENCHMARK_MAIN();
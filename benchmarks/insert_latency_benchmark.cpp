@@ -0,0 +1,90 @@
+#include "huge_page_allocator.hpp"
+#include "incremental_hashmap.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Distribution of single-insert latencies while a map grows from empty to range(0) entries,
+// which crosses several doublings. The mean hides the rehash that one unlucky insert pays; the
+// p99.99 and max counters show it. Each insert is timed on its own with steady_clock, whose
+// ~20 ns of overhead is included in every sample
+using Pair = std::pair<const uint64_t, uint64_t>;
+using Table = optimap::HashMap<uint64_t, uint64_t>;
+using Incremental = optimap::IncrementalHashMap<uint64_t, uint64_t>;
+using IncrementalHugePages = optimap::IncrementalHashMap<
+        uint64_t,
+        uint64_t,
+        optimap::GxHash<uint64_t>,
+        false,
+        optimap::HugePageAllocator<Pair>>;
+
+static void report_latencies(benchmark::State& state, std::vector<uint32_t>& latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](double p) {
+        return static_cast<double>(latencies[static_cast<size_t>(p * (latencies.size() - 1))]);
+    };
+
+    double total = 0;
+    for (const uint32_t ns : latencies)
+    {
+        total += ns;
+    }
+    state.counters["mean_ns"] = total / latencies.size();
+    state.counters["p50_ns"] = percentile(0.5);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p99.9_ns"] = percentile(0.999);
+    state.counters["p99.99_ns"] = percentile(0.9999);
+    state.counters["max_ns"] = static_cast<double>(latencies.back());
+}
+
+template <typename Map> static void InsertLatency(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<uint64_t> keys(n);
+    std::mt19937_64 rng(5);
+    for (auto& key : keys)
+    {
+        key = rng();
+    }
+
+    std::vector<uint32_t> latencies(n);
+    for (auto _ : state)
+    {
+        Map map;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            map.insert(keys[i], i);
+            const auto stop = std::chrono::steady_clock::now();
+            latencies[i] = static_cast<uint32_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()
+            );
+        }
+        benchmark::DoNotOptimize(map);
+    }
+    report_latencies(state, latencies);
+}
+
+BENCHMARK_TEMPLATE(InsertLatency, Table)
+        ->Arg(1 << 20)
+        ->Arg(20 << 20)
+        ->Iterations(1)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(InsertLatency, Incremental)
+        ->Arg(1 << 20)
+        ->Arg(20 << 20)
+        ->Iterations(1)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(InsertLatency, IncrementalHugePages)
+        ->Arg(1 << 20)
+        ->Arg(20 << 20)
+        ->Iterations(1)
+        ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,220 @@
+#pragma once
+
+// Harness for the map_benchmark scenarios (https://github.com/martinus/map_benchmark), on top
+// of google-benchmark. Each scenario is a function template over a map family and runs once
+// per benchmark iteration, with the original sizes, seeds and checksums. Every map allocates
+// through CountingAllocator, and report_map_run() turns the run into the counters that
+// plot_benchmarks.py reads from the JSON output:
+//
+// - operations: map operations in one run, for nanoseconds per operation
+// - peak_bytes: most bytes the maps held at once during the run
+// - bytes_per_element: peak_bytes over the largest element count the scenario reached
+//
+// The label of each run names the map and the hash function
+
+#include "absl/container/flat_hash_map.h"
+#include "hashmap.hpp"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h> // _umul128
+#endif
+
+namespace map_benchmark
+{
+
+    // Small fast counting RNG by Chris Doty-Humphrey, the generator the original scenarios
+    // draw their keys from
+    class sfc64
+    {
+      public:
+        using result_type = uint64_t;
+
+        explicit sfc64(uint64_t seed = UINT64_C(0x853c49e6748fea9b))
+            : m_a(seed), m_b(seed), m_c(seed), m_counter(1)
+        {
+            for (int i = 0; i < 12; ++i)
+            {
+                operator()();
+            }
+        }
+
+        uint64_t operator()()
+        {
+            const uint64_t tmp = m_a + m_b + m_counter++;
+            m_a = m_b ^ (m_b >> 11);
+            m_b = m_c + (m_c << 3);
+            m_c = ((m_c << 24) | (m_c >> 40)) + tmp;
+            return tmp;
+        }
+
+        // Uniform in [0, bound_excluded), by the high half of a 128-bit product
+        uint64_t operator()(uint64_t bound_excluded)
+        {
+            const uint64_t r = operator()();
+#if defined(__SIZEOF_INT128__)
+            return static_cast<uint64_t>((static_cast<__uint128_t>(r) * bound_excluded) >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            uint64_t hi;
+            _umul128(r, bound_excluded, &hi);
+            return hi;
+#else
+            const uint64_t r_lo = r & 0xffffffffULL, r_hi = r >> 32;
+            const uint64_t b_lo = bound_excluded & 0xffffffffULL, b_hi = bound_excluded >> 32;
+            const uint64_t ll = r_lo * b_lo, lh = r_lo * b_hi, hl = r_hi * b_lo;
+            const uint64_t mid = (ll >> 32) + (lh & 0xffffffffULL) + (hl & 0xffffffffULL);
+            return r_hi * b_hi + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+        }
+
+        std::array<uint64_t, 4> state() const
+        {
+            return {m_a, m_b, m_c, m_counter};
+        }
+
+        void state(const std::array<uint64_t, 4>& s)
+        {
+            m_a = s[0];
+            m_b = s[1];
+            m_c = s[2];
+            m_counter = s[3];
+        }
+
+      private:
+        uint64_t m_a;
+        uint64_t m_b;
+        uint64_t m_c;
+        uint64_t m_counter;
+    };
+
+    // Bytes held through CountingAllocator. The scenarios run on one thread
+    struct AllocationCounter
+    {
+        size_t current = 0;
+        size_t peak = 0;
+    };
+
+    inline AllocationCounter g_allocations;
+
+    // Forwards to the aligned global operator new and keeps g_allocations up to date
+    template <typename T> struct CountingAllocator
+    {
+        using value_type = T;
+
+        CountingAllocator() = default;
+        template <typename U> CountingAllocator(const CountingAllocator<U>&) {}
+
+        T* allocate(size_t n)
+        {
+            g_allocations.current += n * sizeof(T);
+            if (g_allocations.current > g_allocations.peak)
+            {
+                g_allocations.peak = g_allocations.current;
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+
+        void deallocate(T* p, size_t n)
+        {
+            g_allocations.current -= n * sizeof(T);
+            ::operator delete(p, n * sizeof(T), std::align_val_t(alignof(T)));
+        }
+
+        template <typename U> bool operator==(const CountingAllocator<U>&) const
+        {
+            return true;
+        }
+    };
+
+    // Map families under test. Map<Family, K, V> is the family's map from K to V
+    struct OptiMap
+    {
+        static constexpr const char* kLabel = "optimap::HashMap (optimap::GxHash)";
+
+        template <typename K, typename V>
+        using type = optimap::
+                HashMap<K, V, optimap::GxHash<K>, false, CountingAllocator<std::pair<const K, V>>>;
+    };
+
+    struct AbslFlatHashMap
+    {
+        static constexpr const char* kLabel = "absl::flat_hash_map (absl::Hash)";
+
+        template <typename K, typename V>
+        using type = absl::flat_hash_map<
+                K,
+                V,
+                absl::Hash<K>,
+                std::equal_to<K>,
+                CountingAllocator<std::pair<const K, V>>>;
+    };
+
+    struct StdUnorderedMap
+    {
+        static constexpr const char* kLabel = "std::unordered_map (std::hash)";
+
+        template <typename K, typename V>
+        using type = std::unordered_map<
+                K,
+                V,
+                std::hash<K>,
+                std::equal_to<K>,
+                CountingAllocator<std::pair<const K, V>>>;
+    };
+
+    template <typename Family, typename K, typename V>
+    using Map = typename Family::template type<K, V>;
+
+    // Clears the allocation counters before a run
+    inline void begin_map_run()
+    {
+        g_allocations = AllocationCounter{};
+    }
+
+    // Fails the run when a scenario's checksum differs from the one the original benchmark
+    // publishes, which catches a scenario that no longer does the same work
+    inline bool check_result(benchmark::State& state, uint64_t expected, uint64_t actual)
+    {
+        if (expected == actual)
+        {
+            return true;
+        }
+        state.SkipWithError(
+                ("checksum " + std::to_string(actual) + ", expected " + std::to_string(expected))
+                        .c_str()
+        );
+        return false;
+    }
+
+    template <typename Family>
+    void report_map_run(benchmark::State& state, size_t operations, size_t max_elements)
+    {
+        state.SetLabel(Family::kLabel);
+        state.counters["operations"] = static_cast<double>(operations);
+        state.counters["peak_bytes"] = static_cast<double>(g_allocations.peak);
+        state.counters["bytes_per_element"] =
+                max_elements == 0 ? 0.0
+                                  : static_cast<double>(g_allocations.peak) / max_elements;
+    }
+
+} // namespace map_benchmark
+
+// Registers scenario once per map family, with the registration calls in the rest of the
+// arguments (e.g. ->Arg(8)) applied to each. The scenarios are long single runs, as in the
+// original suite
+#define MAP_BENCHMARK(scenario, ...)                                                               \
+    BENCHMARK_TEMPLATE(scenario, map_benchmark::OptiMap)                                           \
+    __VA_ARGS__->Iterations(1)->Unit(benchmark::kMillisecond);                                     \
+    BENCHMARK_TEMPLATE(scenario, map_benchmark::AbslFlatHashMap)                                   \
+    __VA_ARGS__->Iterations(1)->Unit(benchmark::kMillisecond);                                     \
+    BENCHMARK_TEMPLATE(scenario, map_benchmark::StdUnorderedMap)                                   \
+    __VA_ARGS__->Iterations(1)->Unit(benchmark::kMillisecond)
@@ -0,0 +1,61 @@
+#include "map_benchmark.hpp"
+
+#include <cstdint>
+
+using namespace map_benchmark;
+
+// Copies a 1M-entry map 200 times with the copy constructor, then 200 times by copy
+// assignment into a live map, adding one entry to the source after each copy
+template <typename Family> static void Copy(benchmark::State& state)
+{
+    constexpr size_t kEntries = 1'000'000;
+    constexpr size_t kCopies = 200;
+    for (auto _ : state)
+    {
+        begin_map_run();
+        sfc64 rng(987);
+        size_t result = 0;
+        {
+            using M = Map<Family, uint64_t, uint64_t>;
+            M map_source;
+            uint64_t remember_key = 0;
+            for (size_t i = 0; i < kEntries; ++i)
+            {
+                const uint64_t key = rng();
+                if (i == kEntries / 2)
+                {
+                    remember_key = key;
+                }
+                map_source[key] = i;
+            }
+
+            M map_for_copy = map_source;
+            for (size_t n = 0; n < kCopies; ++n)
+            {
+                M m = map_for_copy;
+                result += m.size() + m[remember_key];
+                map_for_copy[rng()] = rng();
+            }
+            if (!check_result(state, 300019900, result))
+            {
+                return;
+            }
+
+            map_for_copy = map_source;
+            M m;
+            for (size_t n = 0; n < kCopies; ++n)
+            {
+                m = map_for_copy;
+                result += m.size() + m[remember_key];
+                map_for_copy[rng()] = rng();
+            }
+            if (!check_result(state, 600039800, result))
+            {
+                return;
+            }
+        }
+        report_map_run<Family>(state, 2 * kCopies, kEntries + kCopies);
+    }
+}
+
+MAP_BENCHMARK(Copy);
@@ -0,0 +1,52 @@
+#include "map_benchmark.hpp"
+
+#include <cstddef>
+
+using namespace map_benchmark;
+
+// Constructs and destroys 10M empty maps
+template <typename Family> static void CtorDtorEmptyMap(benchmark::State& state)
+{
+    constexpr size_t kMaps = 10'000'000;
+    for (auto _ : state)
+    {
+        begin_map_run();
+        size_t result = 0;
+        for (size_t n = 0; n < kMaps; ++n)
+        {
+            Map<Family, int, int> map;
+            benchmark::DoNotOptimize(map);
+            result += map.size();
+        }
+        if (!check_result(state, 0, result))
+        {
+            return;
+        }
+        report_map_run<Family>(state, kMaps, 0);
+    }
+}
+
+// Constructs 5M maps, inserts one entry into each and destroys it
+template <typename Family> static void CtorDtorSingleEntryMap(benchmark::State& state)
+{
+    constexpr int kMaps = 5'000'000;
+    for (auto _ : state)
+    {
+        begin_map_run();
+        size_t result = 0;
+        for (int n = 0; n < kMaps; ++n)
+        {
+            Map<Family, int, int> map;
+            map[n];
+            result += map.size();
+        }
+        if (!check_result(state, kMaps, result))
+        {
+            return;
+        }
+        report_map_run<Family>(state, kMaps, 1);
+    }
+}
+
+MAP_BENCHMARK(CtorDtorEmptyMap);
+MAP_BENCHMARK(CtorDtorSingleEntryMap);
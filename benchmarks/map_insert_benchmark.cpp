@@ -0,0 +1,56 @@
+#include "map_benchmark.hpp"
+
+#include <cstdint>
+
+using namespace map_benchmark;
+
+// Inserts 100M random ints into a growing map, clears it, inserts them again into the kept
+// capacity, and erases them in the same order
+template <typename Family> static void InsertHugeInt(benchmark::State& state)
+{
+    constexpr size_t kCount = 100'000'000;
+    for (auto _ : state)
+    {
+        begin_map_run();
+        sfc64 rng(213);
+        size_t max_elements = 0;
+        {
+            Map<Family, int, int> map;
+            for (size_t n = 0; n < kCount; ++n)
+            {
+                map[static_cast<int>(rng())];
+            }
+            max_elements = map.size();
+            if (!check_result(state, 98841586, map.size()))
+            {
+                return;
+            }
+
+            map.clear();
+
+            // Remembers the rng's state so the keys are erased in the order they were added
+            const auto rng_state = rng.state();
+            for (size_t n = 0; n < kCount; ++n)
+            {
+                map[static_cast<int>(rng())];
+            }
+            if (!check_result(state, 98843646, map.size()))
+            {
+                return;
+            }
+
+            rng.state(rng_state);
+            for (size_t n = 0; n < kCount; ++n)
+            {
+                map.erase(static_cast<int>(rng()));
+            }
+            if (!check_result(state, 0, map.size()))
+            {
+                return;
+            }
+        }
+        report_map_run<Family>(state, 3 * kCount, max_elements);
+    }
+}
+
+MAP_BENCHMARK(InsertHugeInt);
@@ -0,0 +1,55 @@
+#include "map_benchmark.hpp"
+
+#include <cstdint>
+
+using namespace map_benchmark;
+
+// Iterates the whole map after each of 50k insertions, then after each of the 50k erasures of
+// the same keys
+template <typename Family> static void IterateIntegers(benchmark::State& state)
+{
+    constexpr size_t kIterations = 50000;
+    for (auto _ : state)
+    {
+        begin_map_run();
+        sfc64 rng(123);
+        uint64_t result = 0;
+        size_t visited = 0;
+        {
+            Map<Family, uint64_t, uint64_t> map;
+
+            const auto rng_state = rng.state();
+            for (size_t n = 0; n < kIterations; ++n)
+            {
+                map[rng()] = n;
+                for (const auto& entry : map)
+                {
+                    result += entry.second;
+                }
+                visited += map.size();
+            }
+            if (!check_result(state, UINT64_C(20833333325000), result))
+            {
+                return;
+            }
+
+            rng.state(rng_state);
+            for (size_t n = 0; n < kIterations; ++n)
+            {
+                map.erase(rng());
+                for (const auto& entry : map)
+                {
+                    result += entry.second;
+                }
+                visited += map.size();
+            }
+            if (!check_result(state, UINT64_C(62498750000000), result))
+            {
+                return;
+            }
+        }
+        report_map_run<Family>(state, visited, kIterations);
+    }
+}
+
+MAP_BENCHMARK(IterateIntegers);
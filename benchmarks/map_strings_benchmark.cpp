@@ -0,0 +1,79 @@
+#include "map_benchmark.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+using namespace map_benchmark;
+
+// Writes value into the 8 bytes of query at offset, the part of the key the scenarios vary
+static void set_key_bytes(std::string& query, size_t offset, uint64_t value)
+{
+    std::memcpy(&query[offset], &value, sizeof(value));
+}
+
+// 1M insertions of strings of range(0) characters, each followed by 100 lookups of which
+// about 90% miss
+template <typename Family> static void StringFind(benchmark::State& state)
+{
+    const size_t length = static_cast<size_t>(state.range(0));
+    constexpr size_t kInserts = 1'000'000;
+    constexpr size_t kLookups = 100;
+    for (auto _ : state)
+    {
+        begin_map_run();
+        sfc64 rng;
+        std::string query(length, 'x');
+        size_t misses = 0;
+        size_t max_elements = 0;
+        {
+            Map<Family, std::string, int> map;
+            for (size_t n = 0; n < kInserts; ++n)
+            {
+                set_key_bytes(query, 0, rng(1'000'000));
+                map[query] = static_cast<int>(rng());
+                for (size_t q = 0; q < kLookups; ++q)
+                {
+                    set_key_bytes(query, 0, rng(100'000));
+                    if (map.find(query) == map.end())
+                    {
+                        ++misses;
+                    }
+                }
+            }
+            max_elements = map.size();
+        }
+        benchmark::DoNotOptimize(misses);
+        report_map_run<Family>(state, kInserts * (kLookups + 1), max_elements);
+    }
+}
+
+// Counts occurrences of range(0)-character strings of which 25% are distinct, varying the
+// last 8 bytes: 50M updates of 20-byte strings or 25M of 500-byte strings
+template <typename Family> static void String25PercentDistinct(benchmark::State& state)
+{
+    const size_t length = static_cast<size_t>(state.range(0));
+    const size_t updates = length <= 20 ? 50'000'000 : 25'000'000;
+    for (auto _ : state)
+    {
+        begin_map_run();
+        sfc64 rng;
+        std::string query(length, 'x');
+        size_t checksum = 0;
+        size_t max_elements = 0;
+        {
+            Map<Family, std::string, size_t> map;
+            for (size_t i = 0; i < updates; ++i)
+            {
+                set_key_bytes(query, length - 8, rng(updates / 4));
+                checksum += ++map[query];
+            }
+            max_elements = map.size();
+        }
+        benchmark::DoNotOptimize(checksum);
+        report_map_run<Family>(state, updates, max_elements);
+    }
+}
+
+MAP_BENCHMARK(StringFind, ->Arg(8)->Arg(1000));
+MAP_BENCHMARK(String25PercentDistinct, ->Arg(20)->Arg(500));
@@ -0,0 +1,83 @@
+#include "hashmap.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Bulk construction of a large table: a serial emplace loop against HashMap::from_range with a
+// growing number of threads, and growth with serial against parallel migration. Linked into
+// OptiMapConcurrentBenchmarks, which provides main()
+static constexpr size_t kBuildSize = size_t{10} << 20;
+
+static const std::vector<std::pair<uint64_t, uint64_t>>& build_input()
+{
+    static const auto pairs = [] {
+        std::vector<std::pair<uint64_t, uint64_t>> result(kBuildSize);
+        std::mt19937_64 rng(7);
+        for (auto& [key, value] : result)
+        {
+            key = rng();
+            value = key;
+        }
+        return result;
+    }();
+    return pairs;
+}
+
+static void SerialEmplaceBuild(benchmark::State& state)
+{
+    const auto& pairs = build_input();
+    for (auto _ : state)
+    {
+        optimap::HashMap<uint64_t, uint64_t> map;
+        map.reserve(pairs.size());
+        for (const auto& [key, value] : pairs)
+        {
+            map.emplace(key, value);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * kBuildSize);
+}
+
+static void FromRangeBuild(benchmark::State& state)
+{
+    const auto& pairs = build_input();
+    for (auto _ : state)
+    {
+        auto map = optimap::HashMap<uint64_t, uint64_t>::from_range(pairs, state.range(0));
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * kBuildSize);
+}
+
+// Inserts without reserving, so the table grows through every power of 2 up to 16M slots
+static void GrowthWithRehashThreads(benchmark::State& state)
+{
+    const auto& pairs = build_input();
+    for (auto _ : state)
+    {
+        optimap::HashMap<uint64_t, uint64_t> map;
+        map.set_rehash_threads(state.range(0));
+        for (const auto& [key, value] : pairs)
+        {
+            map.emplace(key, value);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * kBuildSize);
+}
+
+BENCHMARK(SerialEmplaceBuild)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(FromRangeBuild)
+        ->RangeMultiplier(2)
+        ->Range(1, 16)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+BENCHMARK(GrowthWithRehashThreads)
+        ->RangeMultiplier(2)
+        ->Range(1, 16)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
@@ -0,0 +1,136 @@
+#include "concurrent_read_hashmap.hpp"
+#include "hashmap.hpp"
+#include "sharded_hashmap.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+
+// Multi-threaded throughput of a mixed workload on one shared map: 80% lookups, 10% inserts
+// and 10% erases over 2^20 keys, half of which are present at any time. Each thread runs its
+// own random stream. ShardedHashMap is compared with the single-mutex wrapper it replaces.
+static constexpr uint64_t kKeySpace = uint64_t{1} << 20;
+static constexpr int kOpsPerIteration = 1000;
+
+// Whole-map lock around a plain HashMap
+struct SingleMutexMap
+{
+    bool insert(uint64_t key, uint64_t value)
+    {
+        std::lock_guard lock(mutex);
+        return map.insert(key, value);
+    }
+
+    std::optional<uint64_t> find(uint64_t key) const
+    {
+        std::lock_guard lock(mutex);
+        auto it = map.find(key);
+        if (it == map.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    bool erase(uint64_t key)
+    {
+        std::lock_guard lock(mutex);
+        return map.erase(key);
+    }
+
+    mutable std::mutex mutex;
+    optimap::HashMap<uint64_t, uint64_t> map;
+};
+
+using ShardedMap = optimap::ShardedHashMap<uint64_t, uint64_t>;
+
+template <typename Map> static void MixedWorkload(benchmark::State& state)
+{
+    static std::unique_ptr<Map> map;
+    if (state.thread_index() == 0)
+    {
+        map = std::make_unique<Map>();
+        for (uint64_t key = 0; key < kKeySpace; key += 2)
+        {
+            map->insert(key, key);
+        }
+    }
+
+    std::mt19937_64 rng(state.thread_index() + 1);
+    for (auto _ : state)
+    {
+        for (int i = 0; i < kOpsPerIteration; ++i)
+        {
+            const uint64_t r = rng();
+            const uint64_t key = r % kKeySpace;
+            const uint64_t op = (r >> 32) % 10;
+            if (op == 0)
+            {
+                benchmark::DoNotOptimize(map->insert(key, key));
+            }
+            else if (op == 1)
+            {
+                benchmark::DoNotOptimize(map->erase(key));
+            }
+            else
+            {
+                benchmark::DoNotOptimize(map->find(key));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kOpsPerIteration);
+
+    if (state.thread_index() == 0)
+    {
+        map.reset();
+    }
+}
+
+BENCHMARK_TEMPLATE(MixedWorkload, SingleMutexMap)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(MixedWorkload, ShardedMap)->ThreadRange(1, 64)->UseRealTime();
+
+// Read-mostly workload: every thread looks up random present keys, and thread 0 also updates
+// one value per 1,000 lookups. This compares the sharded reader-writer locks with
+// ConcurrentReadHashMap's lock-free readers
+using ReadOptimizedMap = optimap::ConcurrentReadHashMap<uint64_t, uint64_t>;
+
+template <typename Map> static void ReadMostly(benchmark::State& state)
+{
+    static std::unique_ptr<Map> map;
+    if (state.thread_index() == 0)
+    {
+        map = std::make_unique<Map>();
+        for (uint64_t key = 0; key < kKeySpace; ++key)
+        {
+            map->insert(key, key);
+        }
+    }
+
+    std::mt19937_64 rng(state.thread_index() + 1);
+    for (auto _ : state)
+    {
+        for (int i = 0; i < kOpsPerIteration; ++i)
+        {
+            benchmark::DoNotOptimize(map->find(rng() % kKeySpace));
+        }
+        if (state.thread_index() == 0)
+        {
+            const uint64_t key = rng() % kKeySpace;
+            map->insert_or_assign(key, key);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kOpsPerIteration);
+
+    if (state.thread_index() == 0)
+    {
+        map.reset();
+    }
+}
+
+BENCHMARK_TEMPLATE(ReadMostly, ShardedMap)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(ReadMostly, ReadOptimizedMap)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,786 @@
+#include "map_benchmark.hpp"
+
+#include <algorithm>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// YCSB-style mixed workloads: a table is preloaded with --workload_sizes entries, then every
+// thread runs --workload_ops operations drawn from a read:insert:erase mix, with keys from one
+// of four distributions:
+//
+// - uniform: every preloaded key equally likely
+// - zipfian: YCSB's skewed popularity (theta from --workload_zipf_theta), hot keys scattered
+//   over the table
+// - sequential: each thread walks the keys in insertion order, the best case for the caches
+// - adversarial: keys that differ only in their upper 32 bits, which collapse hashes that use
+//   the low bits directly. None of the maps here should degrade under it
+//
+// Reads and erases pick preloaded keys, so they miss once a key is erased. Inserts add keys
+// never seen before. Every map runs behind the same striped reader-writer locks
+// (--workload_shards, skipped on one thread), so hot keys show up as lock contention as they
+// would in a service. Each run reports throughput, latency percentiles of every
+// --workload_latency_sample-th operation (timer_overhead_ns included) and, on Linux when
+// perf_event_open is permitted, cache and branch misses per operation.
+//
+// ```shell
+// OptiMapWorkloadBenchmarks --workload_distributions=zipfian --workload_mixes=95:5:0
+//     --workload_sizes=1000000000 --workload_threads=1,8,32
+// ```
+namespace
+{
+    using map_benchmark::sfc64;
+
+    struct OptiMap
+    {
+        static constexpr const char* kName = "OptiMap";
+        using type = optimap::HashMap<uint64_t, uint64_t>;
+    };
+
+    struct AbslFlatHashMap
+    {
+        static constexpr const char* kName = "AbslFlatHashMap";
+        using type = absl::flat_hash_map<uint64_t, uint64_t>;
+    };
+
+    struct StdUnorderedMap
+    {
+        static constexpr const char* kName = "StdUnorderedMap";
+        using type = std::unordered_map<uint64_t, uint64_t>;
+    };
+
+    enum class Distribution
+    {
+        Uniform,
+        Zipfian,
+        Sequential,
+        Adversarial,
+    };
+
+    constexpr std::string_view kDistributionNames[] = {
+            "uniform", "zipfian", "sequential", "adversarial"
+    };
+
+    // Percentages of operations that are reads, inserts and erases
+    struct Mix
+    {
+        int read = 95;
+        int insert = 5;
+        int erase = 0;
+    };
+
+    struct Config
+    {
+        std::vector<Distribution> distributions = {
+                Distribution::Uniform,
+                Distribution::Zipfian,
+                Distribution::Sequential,
+                Distribution::Adversarial,
+        };
+        std::vector<Mix> mixes = {{100, 0, 0}, {95, 5, 0}, {80, 10, 10}};
+        std::vector<size_t> sizes = {size_t{1} << 20, size_t{1} << 24};
+        std::vector<size_t> threads = {1, std::max<size_t>(1, std::thread::hardware_concurrency())};
+        size_t ops = 4'000'000;
+        size_t shards = 64;
+        size_t latency_sample = 64;
+        double zipf_theta = 0.99;
+    };
+
+    struct Scenario
+    {
+        Distribution distribution;
+        Mix mix;
+        size_t size;
+        size_t threads;
+    };
+
+    // Bijective 64-bit mixer (the murmur3 finalizer) from key ids to keys, so the keys the
+    // distributions make popular are spread over the whole key space
+    uint64_t mix64(uint64_t x)
+    {
+        x ^= x >> 33;
+        x *= UINT64_C(0xff51afd7ed558ccd);
+        x ^= x >> 33;
+        x *= UINT64_C(0xc4ceb9fe1a85ec53);
+        x ^= x >> 33;
+        return x;
+    }
+
+    uint64_t key_for(Distribution distribution, uint64_t id)
+    {
+        switch (distribution)
+        {
+            case Distribution::Sequential:
+                return id;
+            case Distribution::Adversarial:
+                return (id << 32) | 0x5bd1e995;
+            default:
+                return mix64(id);
+        }
+    }
+
+    // Ranks in [0, n) with P(rank) proportional to 1 / (rank + 1)^theta, by the rejection-free
+    // method of Gray et al. ("Quickly generating billion-record synthetic databases") that YCSB
+    // uses. zeta(n) is summed exactly over the first 2^20 terms and integrated beyond, so that
+    // a billion-entry table does not take a billion pow() calls to set up
+    class ZipfianGenerator
+    {
+      public:
+        ZipfianGenerator(uint64_t n, double theta)
+            : m_n(static_cast<double>(n)), m_alpha(1.0 / (1.0 - theta))
+        {
+            const double zeta2 = 1.0 + std::pow(0.5, theta);
+            m_zetan = zeta(n, theta);
+            m_eta = (1.0 - std::pow(2.0 / m_n, 1.0 - theta)) / (1.0 - zeta2 / m_zetan);
+            m_half_pow_theta = std::pow(0.5, theta);
+        }
+
+        uint64_t operator()(sfc64& rng) const
+        {
+            const double u = static_cast<double>(rng() >> 11) * 0x1.0p-53;
+            const double uz = u * m_zetan;
+            if (uz < 1.0)
+            {
+                return 0;
+            }
+            if (uz < 1.0 + m_half_pow_theta)
+            {
+                return 1;
+            }
+            const auto rank =
+                    static_cast<uint64_t>(m_n * std::pow(m_eta * u - m_eta + 1.0, m_alpha));
+            return std::min(rank, static_cast<uint64_t>(m_n) - 1);
+        }
+
+      private:
+        static double zeta(uint64_t n, double theta)
+        {
+            constexpr uint64_t kExactTerms = uint64_t{1} << 20;
+            const uint64_t exact = std::min(n, kExactTerms);
+            double sum = 0;
+            for (uint64_t i = 1; i <= exact; ++i)
+            {
+                sum += std::pow(static_cast<double>(i), -theta);
+            }
+            if (n > exact)
+            {
+                // Integral of x^-theta over (exact + 1/2, n + 1/2], the midpoint rule's tail
+                const double a = static_cast<double>(exact) + 0.5;
+                const double b = static_cast<double>(n) + 0.5;
+                sum += (std::pow(b, 1.0 - theta) - std::pow(a, 1.0 - theta)) / (1.0 - theta);
+            }
+            return sum;
+        }
+
+        double m_n;
+        double m_alpha;
+        double m_zetan;
+        double m_eta;
+        double m_half_pow_theta;
+    };
+
+    // Maps of one family split into shards by key, each behind its own reader-writer lock.
+    // The shard comes from the top bits of a mix the maps themselves do not use
+    template <typename Map> class StripedMap
+    {
+      public:
+        StripedMap(size_t shards, bool locked) : m_shards(shards), m_locked(locked)
+        {
+            m_shift = 64 - std::countr_zero(shards);
+        }
+
+        void reserve(size_t n)
+        {
+            for (auto& shard : m_shards)
+            {
+                shard.map.reserve(n / m_shards.size() + 1);
+            }
+        }
+
+        bool find(uint64_t key) const
+        {
+            const Shard& shard = shard_for(key);
+            if (!m_locked)
+            {
+                return shard.map.find(key) != shard.map.end();
+            }
+            std::shared_lock lock(shard.mutex);
+            return shard.map.find(key) != shard.map.end();
+        }
+
+        bool insert(uint64_t key, uint64_t value)
+        {
+            Shard& shard = shard_for(key);
+            if (!m_locked)
+            {
+                return shard.map.emplace(key, value).second;
+            }
+            std::unique_lock lock(shard.mutex);
+            return shard.map.emplace(key, value).second;
+        }
+
+        bool erase(uint64_t key)
+        {
+            Shard& shard = shard_for(key);
+            if (!m_locked)
+            {
+                return shard.map.erase(key) != 0;
+            }
+            std::unique_lock lock(shard.mutex);
+            return shard.map.erase(key) != 0;
+        }
+
+        size_t size() const
+        {
+            size_t total = 0;
+            for (const auto& shard : m_shards)
+            {
+                total += shard.map.size();
+            }
+            return total;
+        }
+
+      private:
+        struct alignas(64) Shard
+        {
+            mutable std::shared_mutex mutex;
+            Map map;
+        };
+
+        Shard& shard_for(uint64_t key)
+        {
+            if (m_shards.size() == 1)
+            {
+                return m_shards[0];
+            }
+            return m_shards[mix64(key ^ kShardSalt) >> m_shift];
+        }
+
+        const Shard& shard_for(uint64_t key) const
+        {
+            return const_cast<StripedMap*>(this)->shard_for(key);
+        }
+
+        static constexpr uint64_t kShardSalt = UINT64_C(0x9e3779b97f4a7c15);
+
+        std::vector<Shard> m_shards;
+        bool m_locked;
+        int m_shift;
+    };
+
+    // Cache and branch misses of the calling thread between start() and stop(). Every counter
+    // reads as zero when perf_event_open is unavailable (non-Linux, containers, or a
+    // restrictive perf_event_paranoid)
+    class PerfCounters
+    {
+      public:
+        static constexpr size_t kEvents = 2; // cache misses, branch misses
+
+        PerfCounters()
+        {
+#if defined(__linux__)
+            const uint64_t configs[kEvents] = {
+                    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+            };
+            for (size_t i = 0; i < kEvents; ++i)
+            {
+                perf_event_attr attr{};
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.size = sizeof(attr);
+                attr.config = configs[i];
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                m_fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            }
+#endif
+        }
+
+        ~PerfCounters()
+        {
+#if defined(__linux__)
+            for (const int fd : m_fds)
+            {
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+            }
+#endif
+        }
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        bool available() const
+        {
+            return std::all_of(m_fds, m_fds + kEvents, [](int fd) { return fd >= 0; });
+        }
+
+        void start()
+        {
+#if defined(__linux__)
+            for (const int fd : m_fds)
+            {
+                if (fd >= 0)
+                {
+                    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+#endif
+        }
+
+        std::array<uint64_t, kEvents> stop()
+        {
+            std::array<uint64_t, kEvents> values{};
+#if defined(__linux__)
+            for (size_t i = 0; i < kEvents; ++i)
+            {
+                if (m_fds[i] >= 0)
+                {
+                    ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+                    if (read(m_fds[i], &values[i], sizeof(values[i])) != sizeof(values[i]))
+                    {
+                        values[i] = 0;
+                    }
+                }
+            }
+#endif
+            return values;
+        }
+
+      private:
+        int m_fds[kEvents] = {-1, -1};
+    };
+
+    // Smallest back-to-back steady_clock interval, the floor under every latency sample
+    double timer_overhead_ns()
+    {
+        int64_t best = INT64_MAX;
+        for (int i = 0; i < 1000; ++i)
+        {
+            const auto begin = std::chrono::steady_clock::now();
+            const auto end = std::chrono::steady_clock::now();
+            best = std::min<int64_t>(
+                    best, std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()
+            );
+        }
+        return static_cast<double>(best);
+    }
+
+    // What one worker thread saw
+    struct WorkerResult
+    {
+        std::vector<uint32_t> latencies;
+        size_t reads = 0;
+        size_t read_hits = 0;
+        std::array<uint64_t, PerfCounters::kEvents> misses{};
+        bool perf_available = false;
+    };
+
+    template <typename Map>
+    void run_worker(
+            StripedMap<Map>& map,
+            const Config& config,
+            const Scenario& scenario,
+            const ZipfianGenerator* zipfian,
+            size_t worker,
+            std::latch& start,
+            WorkerResult& result
+    )
+    {
+        sfc64 rng(UINT64_C(0x853c49e6748fea9b) + worker);
+        const uint32_t read_below = static_cast<uint32_t>(scenario.mix.read);
+        const uint32_t insert_below = read_below + static_cast<uint32_t>(scenario.mix.insert);
+        uint64_t cursor = worker * (scenario.size / scenario.threads);
+        uint64_t next_insert = scenario.size + worker;
+
+        const auto draw_id = [&]() -> uint64_t {
+            switch (scenario.distribution)
+            {
+                case Distribution::Zipfian:
+                    return (*zipfian)(rng);
+                case Distribution::Sequential:
+                    cursor = cursor + 1 == scenario.size ? 0 : cursor + 1;
+                    return cursor;
+                default:
+                    return rng(scenario.size);
+            }
+        };
+
+        const auto run_op = [&]() {
+            const uint32_t op = static_cast<uint32_t>(rng(100));
+            if (op < read_below)
+            {
+                ++result.reads;
+                result.read_hits += map.find(key_for(scenario.distribution, draw_id()));
+            }
+            else if (op < insert_below)
+            {
+                benchmark::DoNotOptimize(
+                        map.insert(key_for(scenario.distribution, next_insert), next_insert)
+                );
+                next_insert += scenario.threads;
+            }
+            else
+            {
+                benchmark::DoNotOptimize(map.erase(key_for(scenario.distribution, draw_id())));
+            }
+        };
+
+        result.latencies.reserve(config.ops / config.latency_sample + 1);
+        PerfCounters counters;
+        result.perf_available = counters.available();
+        start.arrive_and_wait();
+
+        counters.start();
+        for (size_t i = 0; i < config.ops; ++i)
+        {
+            if (i % config.latency_sample != 0)
+            {
+                run_op();
+                continue;
+            }
+            const auto begin = std::chrono::steady_clock::now();
+            run_op();
+            const auto end = std::chrono::steady_clock::now();
+            result.latencies.push_back(static_cast<uint32_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()
+            ));
+        }
+        result.misses = counters.stop();
+    }
+
+    // Preloads ids [0, size) with one thread per worker, each taking every threads-th id
+    template <typename Map> void preload(StripedMap<Map>& map, const Scenario& scenario)
+    {
+        map.reserve(scenario.size);
+        std::vector<std::thread> loaders;
+        for (size_t t = 0; t < scenario.threads; ++t)
+        {
+            loaders.emplace_back([&map, &scenario, t] {
+                for (uint64_t id = t; id < scenario.size; id += scenario.threads)
+                {
+                    map.insert(key_for(scenario.distribution, id), id);
+                }
+            });
+        }
+        for (auto& loader : loaders)
+        {
+            loader.join();
+        }
+    }
+
+    template <typename Family>
+    void Workload(benchmark::State& state, const Config& config, const Scenario& scenario)
+    {
+        using Map = typename Family::type;
+        const bool locked = scenario.threads > 1;
+        auto map = std::make_unique<StripedMap<Map>>(locked ? config.shards : 1, locked);
+        preload(*map, scenario);
+
+        std::unique_ptr<ZipfianGenerator> zipfian;
+        if (scenario.distribution == Distribution::Zipfian)
+        {
+            zipfian = std::make_unique<ZipfianGenerator>(scenario.size, config.zipf_theta);
+        }
+
+        std::vector<WorkerResult> results(scenario.threads);
+        double seconds = 0;
+        for (auto _ : state)
+        {
+            std::latch start(static_cast<ptrdiff_t>(scenario.threads + 1));
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < scenario.threads; ++t)
+            {
+                workers.emplace_back([&, t] {
+                    run_worker(*map, config, scenario, zipfian.get(), t, start, results[t]);
+                });
+            }
+            start.arrive_and_wait();
+            const auto begin = std::chrono::steady_clock::now();
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+            const auto end = std::chrono::steady_clock::now();
+            seconds = std::chrono::duration<double>(end - begin).count();
+            state.SetIterationTime(seconds);
+        }
+
+        std::vector<uint32_t> latencies;
+        size_t reads = 0;
+        size_t read_hits = 0;
+        std::array<uint64_t, PerfCounters::kEvents> misses{};
+        bool perf_available = true;
+        for (auto& result : results)
+        {
+            latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+            reads += result.reads;
+            read_hits += result.read_hits;
+            for (size_t i = 0; i < misses.size(); ++i)
+            {
+                misses[i] += result.misses[i];
+            }
+            perf_available = perf_available && result.perf_available;
+        }
+        std::sort(latencies.begin(), latencies.end());
+        const auto percentile = [&latencies](double p) {
+            return static_cast<double>(latencies[static_cast<size_t>(p * (latencies.size() - 1))]);
+        };
+
+        const double operations = static_cast<double>(config.ops * scenario.threads);
+        state.counters["ops_per_second"] = operations / seconds;
+        state.counters["p50_ns"] = percentile(0.5);
+        state.counters["p90_ns"] = percentile(0.9);
+        state.counters["p99_ns"] = percentile(0.99);
+        state.counters["p99.9_ns"] = percentile(0.999);
+        state.counters["max_ns"] = static_cast<double>(latencies.back());
+        state.counters["timer_overhead_ns"] = timer_overhead_ns();
+        state.counters["read_hit_ratio"] =
+                reads == 0 ? 0.0 : static_cast<double>(read_hits) / static_cast<double>(reads);
+        state.counters["final_size"] = static_cast<double>(map->size());
+        if (perf_available)
+        {
+            state.counters["cache_misses_per_op"] = misses[0] / operations;
+            state.counters["branch_misses_per_op"] = misses[1] / operations;
+        }
+        else
+        {
+            state.SetLabel("perf counters unavailable");
+        }
+    }
+
+    // Splits "a,b,c" into its non-empty parts
+    std::vector<std::string_view> split(std::string_view list, char separator)
+    {
+        std::vector<std::string_view> parts;
+        while (!list.empty())
+        {
+            const size_t end = std::min(list.find(separator), list.size());
+            if (end > 0)
+            {
+                parts.push_back(list.substr(0, end));
+            }
+            list.remove_prefix(std::min(end + 1, list.size()));
+        }
+        return parts;
+    }
+
+    [[noreturn]] void usage_error(std::string_view flag, std::string_view value)
+    {
+        std::fprintf(
+                stderr,
+                "invalid --%.*s value '%.*s'\n",
+                static_cast<int>(flag.size()),
+                flag.data(),
+                static_cast<int>(value.size()),
+                value.data()
+        );
+        std::exit(1);
+    }
+
+    size_t parse_size(std::string_view flag, std::string_view text)
+    {
+        const std::string value(text);
+        char* end = nullptr;
+        const unsigned long long parsed = std::strtoull(value.c_str(), &end, 10);
+        if (value.empty() || *end != '\0' || parsed == 0)
+        {
+            usage_error(flag, text);
+        }
+        return static_cast<size_t>(parsed);
+    }
+
+    int parse_percent(std::string_view flag, std::string_view text)
+    {
+        const std::string value(text);
+        char* end = nullptr;
+        const long parsed = std::strtol(value.c_str(), &end, 10);
+        if (value.empty() || *end != '\0' || parsed < 0 || parsed > 100)
+        {
+            usage_error(flag, text);
+        }
+        return static_cast<int>(parsed);
+    }
+
+    std::vector<size_t> parse_sizes(std::string_view flag, std::string_view text)
+    {
+        std::vector<size_t> sizes;
+        for (const std::string_view part : split(text, ','))
+        {
+            sizes.push_back(parse_size(flag, part));
+        }
+        if (sizes.empty())
+        {
+            usage_error(flag, text);
+        }
+        return sizes;
+    }
+
+    // Takes the --workload_* flags out of argv before google-benchmark parses the rest
+    Config parse_config(int& argc, char** argv)
+    {
+        Config config;
+        int kept = 1;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            const size_t equals = arg.find('=');
+            if (!arg.starts_with("--workload_") || equals == std::string_view::npos)
+            {
+                argv[kept++] = argv[i];
+                continue;
+            }
+            const std::string_view flag = arg.substr(2, equals - 2);
+            const std::string_view value = arg.substr(equals + 1);
+
+            if (flag == "workload_distributions")
+            {
+                config.distributions.clear();
+                for (const std::string_view name : split(value, ','))
+                {
+                    const auto* found = std::find(
+                            std::begin(kDistributionNames), std::end(kDistributionNames), name
+                    );
+                    if (found == std::end(kDistributionNames))
+                    {
+                        usage_error(flag, name);
+                    }
+                    config.distributions.push_back(
+                            static_cast<Distribution>(found - std::begin(kDistributionNames))
+                    );
+                }
+            }
+            else if (flag == "workload_mixes")
+            {
+                config.mixes.clear();
+                for (const std::string_view text : split(value, ','))
+                {
+                    const auto parts = split(text, ':');
+                    if (parts.size() != 3)
+                    {
+                        usage_error(flag, text);
+                    }
+                    const Mix mix{
+                            parse_percent(flag, parts[0]),
+                            parse_percent(flag, parts[1]),
+                            parse_percent(flag, parts[2]),
+                    };
+                    if (mix.read + mix.insert + mix.erase != 100)
+                    {
+                        usage_error(flag, text);
+                    }
+                    config.mixes.push_back(mix);
+                }
+            }
+            else if (flag == "workload_sizes")
+            {
+                config.sizes = parse_sizes(flag, value);
+            }
+            else if (flag == "workload_threads")
+            {
+                config.threads = parse_sizes(flag, value);
+            }
+            else if (flag == "workload_ops")
+            {
+                config.ops = parse_size(flag, value);
+            }
+            else if (flag == "workload_shards")
+            {
+                config.shards = std::bit_ceil(parse_size(flag, value));
+            }
+            else if (flag == "workload_latency_sample")
+            {
+                config.latency_sample = parse_size(flag, value);
+            }
+            else if (flag == "workload_zipf_theta")
+            {
+                char* end = nullptr;
+                const std::string text(value);
+                config.zipf_theta = std::strtod(text.c_str(), &end);
+                if (*end != '\0' || !(config.zipf_theta > 0.0 && config.zipf_theta < 1.0))
+                {
+                    usage_error(flag, value);
+                }
+            }
+            else
+            {
+                usage_error(flag, value);
+            }
+        }
+        argc = kept;
+        return config;
+    }
+
+    template <typename Family> void register_family(const Config& config)
+    {
+        for (const Distribution distribution : config.distributions)
+        {
+            for (const Mix& mix : config.mixes)
+            {
+                for (const size_t size : config.sizes)
+                {
+                    for (const size_t threads : config.threads)
+                    {
+                        const Scenario scenario{distribution, mix, size, threads};
+                        const std::string name =
+                                std::string("Workload<") + Family::kName + ">/" +
+                                std::string(kDistributionNames[static_cast<int>(distribution)]) +
+                                "/" + std::to_string(mix.read) + ":" + std::to_string(mix.insert) +
+                                ":" + std::to_string(mix.erase) + "/size:" + std::to_string(size) +
+                                "/threads:" + std::to_string(threads);
+                        benchmark::RegisterBenchmark(
+                                name.c_str(),
+                                [config, scenario](benchmark::State& state) {
+                                    Workload<Family>(state, config, scenario);
+                                }
+                        )
+                                ->Iterations(1)
+                                ->UseManualTime()
+                                ->Unit(benchmark::kMillisecond);
+                    }
+                }
+            }
+        }
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const Config config = parse_config(argc, argv);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    register_family<OptiMap>(config);
+    register_family<AbslFlatHashMap>(config);
+    register_family<StdUnorderedMap>(config);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,593 @@
+#pragma once
+
+#include "hashmap.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+namespace optimap
+{
+    namespace detail
+    {
+        // Busy-wait hint for the short spins on a group that is being written
+        inline void cpu_relax()
+        {
+#if defined(OPTIMAP_HAVE_SSE2)
+            _mm_pause();
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+            __asm__ __volatile__("yield");
+#else
+            std::this_thread::yield();
+#endif
+        }
+
+        // Epoch-based reclamation shared by every ConcurrentReadHashMap.
+        //
+        // A reader publishes the global epoch in its thread's slot before it loads a table
+        // pointer and clears the slot when done. A writer that has unlinked a table advances the
+        // global epoch and waits until no slot still holds an older epoch. After that, no reader
+        // can still hold the unlinked pointer. Slots are leased to threads on first use and
+        // returned at thread exit.
+        struct alignas(64) EpochSlot
+        {
+            std::atomic<uint64_t> epoch{0}; // 0 = not reading
+            std::atomic<bool> leased{false};
+        };
+
+        inline constexpr size_t kEpochSlots = 256;
+        inline std::array<EpochSlot, kEpochSlots> g_epoch_slots;
+        inline std::atomic<uint64_t> g_epoch{1};
+
+        struct EpochSlotLease
+        {
+            EpochSlot* slot = nullptr;
+
+            EpochSlotLease()
+            {
+                for (auto& candidate : g_epoch_slots)
+                {
+                    bool expected = false;
+                    if (!candidate.leased.load(std::memory_order_relaxed) &&
+                        candidate.leased.compare_exchange_strong(expected, true))
+                    {
+                        slot = &candidate;
+                        return;
+                    }
+                }
+            }
+
+            ~EpochSlotLease()
+            {
+                if (slot)
+                {
+                    slot->leased.store(false, std::memory_order_release);
+                }
+            }
+        };
+
+        // Returns this thread's slot, or nullptr if all kEpochSlots are leased
+        inline EpochSlot* this_thread_epoch_slot()
+        {
+            thread_local EpochSlotLease lease;
+            return lease.slot;
+        }
+
+        // Marks the current thread as reading for its lifetime. Guards must not nest
+        class EpochGuard
+        {
+          public:
+            EpochGuard() : m_slot(this_thread_epoch_slot())
+            {
+                if (m_slot)
+                {
+                    m_slot->epoch.store(g_epoch.load(std::memory_order_relaxed));
+                }
+            }
+
+            ~EpochGuard()
+            {
+                if (m_slot)
+                {
+                    m_slot->epoch.store(0, std::memory_order_release);
+                }
+            }
+
+            EpochGuard(const EpochGuard&) = delete;
+            EpochGuard& operator=(const EpochGuard&) = delete;
+
+            bool pinned() const
+            {
+                return m_slot != nullptr;
+            }
+
+          private:
+            EpochSlot* m_slot;
+        };
+
+        // Waits for every reader that may still hold a pointer unlinked before the call
+        inline void synchronize_epoch()
+        {
+            const uint64_t target = g_epoch.fetch_add(1) + 1;
+            for (auto& slot : g_epoch_slots)
+            {
+                for (uint64_t epoch = slot.epoch.load(); epoch != 0 && epoch < target;
+                     epoch = slot.epoch.load())
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    } // namespace detail
+
+    // Concurrent hash map for read-mostly data (configuration, routing tables). Lookups take no
+    // lock and write nothing shared except their own epoch slot, so they never bounce cache
+    // lines between readers. Writers are serialized by a mutex.
+    //
+    // The table reuses HashMap's control-byte groups, probing whole aligned groups. Each group
+    // has a version counter, which works as a seqlock: a writer makes it odd while it changes
+    // the group's control bytes or entries. A reader retries a group if the version was odd
+    // or changed while it scanned. Entries never move within a table, so a key that stays
+    // present is always found.
+    //
+    // Growth and tombstone cleanup build a new table, publish it, and free the old one once
+    // epoch-based reclamation shows that no reader can still be using it. Readers copy entries
+    // while a writer may be changing them and keep a copy only after revalidation. This is why
+    // Key and Value must be trivially copyable; find() returns a copy of the value.
+    template <typename Key, typename Value, typename Hash = GxHash<Key>>
+    class ConcurrentReadHashMap
+    {
+        static_assert(
+                std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Value>,
+                "ConcurrentReadHashMap requires trivially copyable Key and Value"
+        );
+
+      public:
+        ConcurrentReadHashMap() = default;
+
+        explicit ConcurrentReadHashMap(size_t n)
+        {
+            reserve(n);
+        }
+
+        ConcurrentReadHashMap(const ConcurrentReadHashMap&) = delete;
+        ConcurrentReadHashMap& operator=(const ConcurrentReadHashMap&) = delete;
+
+        ~ConcurrentReadHashMap()
+        {
+            destroy_table(m_table.load(std::memory_order_relaxed));
+        }
+
+        // Lock-free lookup. Returns a copy of the value for key, if present
+        std::optional<Value> find(const Key& key) const
+        {
+            const size_t full_hash = Hash{}(key);
+
+            detail::EpochGuard guard;
+            std::unique_lock<std::mutex> fallback;
+            if (!guard.pinned()) [[unlikely]]
+            {
+                // More reading threads than epoch slots: fall back to excluding writers
+                fallback = std::unique_lock(m_write_mutex);
+            }
+
+            const Table* table = m_table.load();
+            if (table == nullptr)
+            {
+                return std::nullopt;
+            }
+            return probe(*table, key, full_hash);
+        }
+
+        bool contains(const Key& key) const
+        {
+            return find(key).has_value();
+        }
+
+        // Inserts key -> value if key is absent. Returns false if the key already exists
+        bool insert(const Key& key, const Value& value)
+        {
+            return write(key, value, false);
+        }
+
+        // Inserts key -> value, or overwrites the value if key exists. Returns true on insertion
+        bool insert_or_assign(const Key& key, const Value& value)
+        {
+            return write(key, value, true);
+        }
+
+        bool erase(const Key& key)
+        {
+            const size_t full_hash = Hash{}(key);
+            std::lock_guard lock(m_write_mutex);
+
+            Table* table = m_table.load(std::memory_order_relaxed);
+            if (table == nullptr)
+            {
+                return false;
+            }
+
+            const auto index = find_index(*table, key, full_hash);
+            if (!index)
+            {
+                return false;
+            }
+
+            // Probes stop at the first group with an empty slot. If this group has one, probes
+            // that reach it already end here, so the slot can go back to empty rather than
+            // becoming a tombstone
+            const size_t group = *index / kGroupWidth;
+            const bool group_has_empty =
+                    static_cast<bool>(Group(&table->ctrl[group * kGroupWidth]).match_empty());
+
+            begin_write(*table, group);
+            table->ctrl[*index] = group_has_empty ? kEmpty : kDeleted;
+            end_write(*table, group);
+
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+            if (!group_has_empty)
+            {
+                m_tombstones++;
+            }
+            return true;
+        }
+
+        // Grows the table so that n elements fit without further growth
+        void reserve(size_t n)
+        {
+            std::lock_guard lock(m_write_mutex);
+            const Table* table = m_table.load(std::memory_order_relaxed);
+            const size_t capacity = capacity_for(n);
+            if (capacity > (table ? table->capacity : 0))
+            {
+                rebuild(capacity);
+            }
+        }
+
+        void clear()
+        {
+            std::lock_guard lock(m_write_mutex);
+            Table* old_table = m_table.exchange(nullptr);
+            m_size.store(0, std::memory_order_relaxed);
+            m_tombstones = 0;
+            if (old_table)
+            {
+                detail::synchronize_epoch();
+                destroy_table(old_table);
+            }
+        }
+
+        size_t size() const
+        {
+            return m_size.load(std::memory_order_relaxed);
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        size_t capacity() const
+        {
+            std::lock_guard lock(m_write_mutex);
+            const Table* table = m_table.load(std::memory_order_relaxed);
+            return table ? table->capacity : 0;
+        }
+
+      private:
+        static constexpr size_t kGroupWidth = detail::kGroupWidth;
+        static constexpr int8_t kEmpty = detail::kEmpty;
+        static constexpr int8_t kDeleted = detail::kDeleted;
+        static constexpr size_t kCacheLineSize = 64;
+
+        using Group = detail::Group;
+        using BitMask = detail::BitMask;
+
+        struct Entry
+        {
+            Key first;
+            Value second;
+        };
+
+        struct Table
+        {
+            size_t capacity;
+            int8_t* ctrl;
+            Entry* entries;
+            std::atomic<uint64_t>* versions; // One per aligned group, odd while being written
+            char* allocation;
+        };
+
+        static int8_t h2(size_t hash)
+        {
+            return detail::h2_of(hash);
+        }
+
+        static constexpr size_t max_load_for(size_t capacity)
+        {
+            return capacity - capacity / 8;
+        }
+
+        static constexpr size_t capacity_for(size_t n)
+        {
+            size_t capacity = kGroupWidth;
+            while (max_load_for(capacity) < n)
+            {
+                capacity *= 2;
+            }
+            return capacity;
+        }
+
+        static size_t first_group(const Table& table, size_t full_hash)
+        {
+            return (full_hash & (table.capacity - 1)) / kGroupWidth;
+        }
+
+        static size_t next_group(const Table& table, size_t group)
+        {
+            return (group + 1) & (table.capacity / kGroupWidth - 1);
+        }
+
+        static constexpr size_t align_up(size_t value, size_t alignment)
+        {
+            return ((value + alignment - 1) / alignment) * alignment;
+        }
+
+        static Table* create_table(size_t capacity)
+        {
+            const size_t groups = capacity / kGroupWidth;
+            const size_t entries_offset = align_up(capacity, alignof(Entry));
+            const size_t versions_offset = align_up(
+                    entries_offset + capacity * sizeof(Entry),
+                    alignof(std::atomic<uint64_t>)
+            );
+            const size_t total_bytes = versions_offset + groups * sizeof(std::atomic<uint64_t>);
+
+            char* allocation = AlignedAllocator<char, kCacheLineSize>().allocate(total_bytes);
+
+            Table* table = new Table{
+                    capacity,
+                    reinterpret_cast<int8_t*>(allocation),
+                    reinterpret_cast<Entry*>(allocation + entries_offset),
+                    reinterpret_cast<std::atomic<uint64_t>*>(allocation + versions_offset),
+                    allocation
+            };
+            std::fill(table->ctrl, table->ctrl + capacity, kEmpty);
+            for (size_t group = 0; group < groups; ++group)
+            {
+                new (&table->versions[group]) std::atomic<uint64_t>(0);
+            }
+            return table;
+        }
+
+        static void destroy_table(Table* table)
+        {
+            if (table)
+            {
+                AlignedAllocator<char, kCacheLineSize>().deallocate(table->allocation, 0);
+                delete table;
+            }
+        }
+
+        // Reader side: seqlock-validated scan of each group on the probe sequence
+        static std::optional<Value> probe(const Table& table, const Key& key, size_t full_hash)
+        {
+            const int8_t hash2_val = h2(full_hash);
+            size_t group = first_group(table, full_hash);
+
+            for (size_t step = 0; step < table.capacity / kGroupWidth; ++step)
+            {
+                const std::atomic<uint64_t>& version = table.versions[group];
+
+                while (true)
+                {
+                    const uint64_t before = version.load(std::memory_order_acquire);
+                    if (before & 1) [[unlikely]]
+                    {
+                        detail::cpu_relax();
+                        continue;
+                    }
+
+                    const Group ctrl_group(&table.ctrl[group * kGroupWidth]);
+                    std::optional<Value> found;
+                    for (BitMask match = ctrl_group.match_h2(hash2_val); match; match.advance())
+                    {
+                        const size_t index = group * kGroupWidth + match.next();
+                        const Entry entry = load_entry(table.entries[index]);
+                        if (entry.first == key)
+                        {
+                            found = entry.second;
+                            break;
+                        }
+                    }
+                    const bool has_empty = static_cast<bool>(ctrl_group.match_empty());
+
+                    // Everything read above must be from one unchanged version of the group
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (version.load(std::memory_order_relaxed) != before) [[unlikely]]
+                    {
+                        continue;
+                    }
+
+                    if (found || has_empty)
+                    {
+                        return found;
+                    }
+                    break;
+                }
+
+                group = next_group(table, group);
+            }
+
+            return std::nullopt;
+        }
+
+        // Copies an entry that a writer may be changing. The copy is only used once the
+        // group's version check confirms it was not torn
+        static Entry load_entry(const Entry& source)
+        {
+            std::array<unsigned char, sizeof(Entry)> bytes;
+            std::memcpy(bytes.data(), &source, sizeof(Entry));
+            return std::bit_cast<Entry>(bytes);
+        }
+
+        // Writer side below; all of it runs under m_write_mutex
+
+        static void begin_write(Table& table, size_t group)
+        {
+            const uint64_t version = table.versions[group].load(std::memory_order_relaxed);
+            table.versions[group].store(version + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        static void end_write(Table& table, size_t group)
+        {
+            const uint64_t version = table.versions[group].load(std::memory_order_relaxed);
+            table.versions[group].store(version + 1, std::memory_order_release);
+        }
+
+        // Plain lookup for the writer, which holds the only right to modify the table
+        static std::optional<size_t>
+        find_index(const Table& table, const Key& key, size_t full_hash)
+        {
+            const int8_t hash2_val = h2(full_hash);
+            size_t group = first_group(table, full_hash);
+
+            for (size_t step = 0; step < table.capacity / kGroupWidth; ++step)
+            {
+                const Group ctrl_group(&table.ctrl[group * kGroupWidth]);
+                for (BitMask match = ctrl_group.match_h2(hash2_val); match; match.advance())
+                {
+                    const size_t index = group * kGroupWidth + match.next();
+                    if (table.entries[index].first == key)
+                    {
+                        return index;
+                    }
+                }
+                if (ctrl_group.match_empty())
+                {
+                    return std::nullopt;
+                }
+                group = next_group(table, group);
+            }
+
+            return std::nullopt;
+        }
+
+        static size_t find_free_slot(const Table& table, size_t full_hash)
+        {
+            size_t group = first_group(table, full_hash);
+            while (true)
+            {
+                const Group ctrl_group(&table.ctrl[group * kGroupWidth]);
+                if (auto free_slots = ctrl_group.match_empty_or_deleted())
+                {
+                    return group * kGroupWidth + free_slots.next();
+                }
+                group = next_group(table, group);
+            }
+        }
+
+        bool write(const Key& key, const Value& value, bool assign)
+        {
+            const size_t full_hash = Hash{}(key);
+            std::lock_guard lock(m_write_mutex);
+
+            Table* table = m_table.load(std::memory_order_relaxed);
+            if (table)
+            {
+                if (const auto index = find_index(*table, key, full_hash))
+                {
+                    if (assign)
+                    {
+                        const size_t group = *index / kGroupWidth;
+                        begin_write(*table, group);
+                        table->entries[*index].second = value;
+                        end_write(*table, group);
+                    }
+                    return false;
+                }
+            }
+
+            if (table == nullptr || size() + m_tombstones >= max_load_for(table->capacity))
+                    [[unlikely]]
+            {
+                table = grow();
+            }
+
+            const size_t index = find_free_slot(*table, full_hash);
+            const size_t group = index / kGroupWidth;
+            if (table->ctrl[index] == kDeleted)
+            {
+                m_tombstones--;
+            }
+
+            begin_write(*table, group);
+            table->entries[index] = Entry{key, value};
+            table->ctrl[index] = h2(full_hash);
+            end_write(*table, group);
+
+            m_size.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Doubles the table, or rebuilds it at the same capacity when tombstones make up a large
+        // share of the used slots (same threshold as HashMap)
+        Table* grow()
+        {
+            const Table* table = m_table.load(std::memory_order_relaxed);
+            if (table == nullptr)
+            {
+                return rebuild(kGroupWidth);
+            }
+            const bool mostly_tombstones = size() * 32 <= table->capacity * 25;
+            return rebuild(mostly_tombstones ? table->capacity : table->capacity * 2);
+        }
+
+        // Copies every live entry into a fresh table, publishes it and frees the old one once no
+        // reader can still be probing it
+        Table* rebuild(size_t new_capacity)
+        {
+            Table* old_table = m_table.load(std::memory_order_relaxed);
+            Table* new_table = create_table(new_capacity);
+
+            if (old_table)
+            {
+                for (size_t i = 0; i < old_table->capacity; ++i)
+                {
+                    if (detail::is_full(old_table->ctrl[i]))
+                    {
+                        const Entry& entry = old_table->entries[i];
+                        const size_t full_hash = Hash{}(entry.first);
+                        const size_t index = find_free_slot(*new_table, full_hash);
+                        new_table->entries[index] = entry;
+                        new_table->ctrl[index] = h2(full_hash);
+                    }
+                }
+            }
+
+            // Not yet visible to readers, so no versioning was needed above
+            m_table.store(new_table);
+            m_tombstones = 0;
+
+            if (old_table)
+            {
+                detail::synchronize_epoch();
+                destroy_table(old_table);
+            }
+            return new_table;
+        }
+
+        std::atomic<Table*> m_table{nullptr};
+        std::atomic<size_t> m_size{0};
+        size_t m_tombstones = 0; // Writer-only
+        mutable std::mutex m_write_mutex;
+    };
+
+} // namespace optimap
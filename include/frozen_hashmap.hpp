@@ -0,0 +1,458 @@
+#pragma once
+
+#include "hashmap.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace optimap
+{
+
+    namespace detail
+    {
+        // Maps a 32-bit hash to [0, n) without a division
+        inline uint32_t reduce_range(uint32_t hash, uint32_t n)
+        {
+            return static_cast<uint32_t>((static_cast<uint64_t>(hash) * n) >> 32);
+        }
+
+        // Group choice of a key for displacement d: the high half of a multiply, which depends on
+        // every bit of the hash, unlike the bucket, which uses the low 32 bits as they are
+        inline uint32_t displaced_hash(uint64_t hash, uint32_t d)
+        {
+            const uint64_t x = hash ^ ((static_cast<uint64_t>(d) + 1) * 0x9e3779b97f4a7c15ULL);
+            return static_cast<uint32_t>((x * 0xd6e8feb86659fd93ULL) >> 32);
+        }
+    } // namespace detail
+
+    // Immutable hash map, built once from a HashMap or a range of key-value pairs and then only
+    // read. Every lookup loads exactly one control group.
+    //
+    // Keys are hashed into buckets of about four. Each bucket stores a 16-bit displacement that,
+    // mixed with a key's hash, picks the key's group. Construction searches, largest bucket
+    // first, for a displacement that sends every key of the bucket to a group with a free
+    // slot, as in CHD (compress, hash and displace). A key is therefore always in the one
+    // group its displacement points to.
+    //
+    // Groups are packed to about 94% full. A group holds only control bytes (empty, or "full"
+    // plus the h2 fingerprint) and the index of its first entry. Keys and values sit in two
+    // dense arrays of exactly size() elements, ordered by group. There are no tombstones and
+    // no spare slots in the entry arrays. The overhead is about 2 bytes per entry.
+    //
+    // find/contains/at match HashMap's, including heterogeneous lookup with a transparent Hash.
+    template <typename Key, typename Value, typename Hash = GxHash<Key>> class FrozenHashMap
+    {
+        using Group = detail::Group;
+        using BitMask = detail::BitMask;
+
+        static constexpr size_t kGroupWidth = detail::kGroupWidth;
+
+        // Average number of keys sharing one displacement
+        static constexpr size_t kKeysPerBucket = 4;
+
+        // Target fill of the groups, as slots per group in 16ths
+        static constexpr size_t kLoadSixteenths = 15;
+
+        static constexpr uint32_t kMaxDisplacement = UINT16_MAX;
+
+        // Construction gives up after this many group-count increases. Only hit when more than a
+        // group's worth of keys have identical hashes
+        static constexpr int kMaxBuildAttempts = 16;
+
+        struct GroupSlots
+        {
+            int8_t ctrl[kGroupWidth];
+            uint32_t first; // Index of the group's first entry in m_keys / m_values
+        };
+
+      public:
+        // Pair of references to one entry, as returned by the iterators
+        struct EntryRef
+        {
+            const Key& first;
+            const Value& second;
+
+            const EntryRef* operator->() const
+            {
+                return this;
+            }
+        };
+
+        class const_iterator
+        {
+          public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = std::pair<Key, Value>;
+            using difference_type = std::ptrdiff_t;
+            using reference = EntryRef;
+            using pointer = EntryRef;
+
+            const_iterator() = default;
+
+            EntryRef operator*() const
+            {
+                return {m_map->m_keys[m_index], m_map->m_values[m_index]};
+            }
+
+            EntryRef operator->() const
+            {
+                return operator*();
+            }
+
+            const_iterator& operator++()
+            {
+                ++m_index;
+                return *this;
+            }
+
+            const_iterator operator++(int)
+            {
+                const_iterator tmp = *this;
+                ++m_index;
+                return tmp;
+            }
+
+            friend bool operator==(const const_iterator& a, const const_iterator& b)
+            {
+                return a.m_map == b.m_map && a.m_index == b.m_index;
+            }
+
+          private:
+            friend class FrozenHashMap;
+
+            const_iterator(const FrozenHashMap* map, size_t index) : m_map(map), m_index(index) {}
+
+            const FrozenHashMap* m_map = nullptr;
+            size_t m_index = 0;
+        };
+
+        using iterator = const_iterator;
+
+        FrozenHashMap() = default;
+
+        // Freezes the entries of map
+        template <bool StoreHash, typename Allocator, typename ProbePolicy>
+        explicit FrozenHashMap(
+                const HashMap<Key, Value, Hash, StoreHash, Allocator, ProbePolicy>& map
+        )
+        {
+            std::vector<Key> keys;
+            std::vector<Value> values;
+            keys.reserve(map.size());
+            values.reserve(map.size());
+            for (const auto& entry : map)
+            {
+                keys.push_back(entry.first);
+                values.push_back(entry.second);
+            }
+            build(std::move(keys), std::move(values));
+        }
+
+        // Freezes a range of key-value pairs. For a repeated key, the first pair wins, as with
+        // HashMap::emplace
+        template <std::ranges::input_range R>
+            requires(!std::is_base_of_v<FrozenHashMap, std::remove_cvref_t<R>>)
+        explicit FrozenHashMap(const R& pairs)
+            : FrozenHashMap(collect_unique(pairs))
+        {
+        }
+
+        size_t size() const noexcept
+        {
+            return m_keys.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return m_keys.empty();
+        }
+
+        // Slots in the control groups; size() / capacity() is the packing achieved
+        size_t capacity() const noexcept
+        {
+            return m_groups.size() * kGroupWidth;
+        }
+
+        const_iterator find(const Key& key) const
+        {
+            return const_iterator(this, index_of(key));
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        const_iterator find(const K& key) const
+        {
+            return const_iterator(this, index_of(key));
+        }
+
+        bool contains(const Key& key) const
+        {
+            return index_of(key) != size();
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        bool contains(const K& key) const
+        {
+            return index_of(key) != size();
+        }
+
+        // Returns the value for key. Throws std::out_of_range if key is absent
+        const Value& at(const Key& key) const
+        {
+            return m_values[index_of_or_throw(key)];
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        const Value& at(const K& key) const
+        {
+            return m_values[index_of_or_throw(key)];
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator(this, size());
+        }
+
+      private:
+        template <typename R> static HashMap<Key, Value, Hash> collect_unique(const R& pairs)
+        {
+            HashMap<Key, Value, Hash> unique;
+            if constexpr (std::ranges::sized_range<R>)
+            {
+                unique.reserve(static_cast<size_t>(std::ranges::size(pairs)));
+            }
+            for (const auto& [key, value] : pairs)
+            {
+                unique.emplace(key, value);
+            }
+            return unique;
+        }
+
+        // Index of key in m_keys, or size() if absent
+        template <typename K> size_t index_of(const K& key) const
+        {
+            if (m_group_count == 0) [[unlikely]]
+            {
+                return size();
+            }
+
+            const size_t full_hash = Hash{}(key);
+            const GroupSlots& slots = m_groups[group_of(full_hash)];
+            const Group group(slots.ctrl);
+            for (BitMask match = group.match_h2(detail::h2_of(full_hash)); match; match.advance())
+            {
+                const size_t index = slots.first + match.next();
+                if (m_keys[index] == key) [[likely]]
+                {
+                    return index;
+                }
+            }
+            return size();
+        }
+
+        template <typename K> size_t index_of_or_throw(const K& key) const
+        {
+            const size_t index = index_of(key);
+            if (index == size())
+            {
+                throw std::out_of_range("Key not found in FrozenHashMap");
+            }
+            return index;
+        }
+
+        uint32_t bucket_of(size_t full_hash) const
+        {
+            return detail::reduce_range(static_cast<uint32_t>(full_hash), m_bucket_count);
+        }
+
+        uint32_t group_for(size_t full_hash, uint32_t displacement) const
+        {
+            const uint32_t mixed = detail::displaced_hash(full_hash, displacement);
+            return detail::reduce_range(mixed, m_group_count);
+        }
+
+        uint32_t group_of(size_t full_hash) const
+        {
+            return group_for(full_hash, m_displacements[bucket_of(full_hash)]);
+        }
+
+        // Places unique keys (and their values) into groups, growing the group count until
+        // every bucket finds a displacement
+        void build(std::vector<Key> keys, std::vector<Value> values)
+        {
+            const size_t count = keys.size();
+            if (count == 0)
+            {
+                return;
+            }
+            if (count > UINT32_MAX)
+            {
+                throw std::length_error("FrozenHashMap supports at most 2^32 - 1 entries");
+            }
+
+            std::vector<size_t> hashes(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                hashes[i] = Hash{}(keys[i]);
+            }
+
+            m_bucket_count = static_cast<uint32_t>((count + kKeysPerBucket - 1) / kKeysPerBucket);
+            const size_t slots_per_group = kGroupWidth * kLoadSixteenths / 16;
+            size_t group_count = (count + slots_per_group - 1) / slots_per_group;
+
+            std::vector<uint32_t> group_of_key(count);
+            for (int attempt = 0;; ++attempt)
+            {
+                if (attempt == kMaxBuildAttempts)
+                {
+                    throw std::invalid_argument(
+                            "FrozenHashMap: too many keys with identical hashes to place"
+                    );
+                }
+                if (try_place(hashes, group_count, group_of_key))
+                {
+                    break;
+                }
+                group_count += group_count / 16 + 1;
+            }
+
+            // Entries ordered by group; each group's control bytes are filled from slot 0
+            std::vector<uint32_t> order(count);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+                return group_of_key[a] < group_of_key[b];
+            });
+
+            m_keys.reserve(count);
+            m_values.reserve(count);
+            for (size_t entry = 0; entry < count; ++entry)
+            {
+                const uint32_t source = order[entry];
+                GroupSlots& slots = m_groups[group_of_key[source]];
+                if (entry == 0 || group_of_key[order[entry - 1]] != group_of_key[source])
+                {
+                    slots.first = static_cast<uint32_t>(entry);
+                }
+                slots.ctrl[entry - slots.first] = detail::h2_of(hashes[source]);
+                m_keys.push_back(std::move(keys[source]));
+                m_values.push_back(std::move(values[source]));
+            }
+        }
+
+        // Finds a displacement for every bucket with group_count groups. On success, fills
+        // m_groups (control bytes still empty), m_displacements and group_of_key
+        bool try_place(
+                const std::vector<size_t>& hashes,
+                size_t group_count,
+                std::vector<uint32_t>& group_of_key
+        )
+        {
+            if (group_count > UINT32_MAX)
+            {
+                return false;
+            }
+            m_groups.assign(group_count, GroupSlots{});
+            m_group_count = static_cast<uint32_t>(group_count);
+            m_displacements.assign(m_bucket_count, 0);
+
+            // Keys grouped by bucket (counting sort), buckets visited largest first
+            std::vector<uint32_t> bucket_start(m_bucket_count + 1, 0);
+            for (const size_t full_hash : hashes)
+            {
+                bucket_start[bucket_of(full_hash) + 1]++;
+            }
+            std::partial_sum(bucket_start.begin(), bucket_start.end(), bucket_start.begin());
+            std::vector<uint32_t> bucket_keys(hashes.size());
+            {
+                std::vector<uint32_t> cursor(bucket_start.begin(), bucket_start.end() - 1);
+                for (size_t i = 0; i < hashes.size(); ++i)
+                {
+                    bucket_keys[cursor[bucket_of(hashes[i])]++] = static_cast<uint32_t>(i);
+                }
+            }
+
+            std::vector<uint32_t> buckets(m_bucket_count);
+            std::iota(buckets.begin(), buckets.end(), 0);
+            const auto bucket_size = [&](uint32_t bucket) {
+                return bucket_start[bucket + 1] - bucket_start[bucket];
+            };
+            std::stable_sort(buckets.begin(), buckets.end(), [&](uint32_t a, uint32_t b) {
+                return bucket_size(a) > bucket_size(b);
+            });
+
+            std::vector<uint8_t> fill(group_count, 0);
+            std::vector<uint32_t> chosen;
+            for (const uint32_t bucket : buckets)
+            {
+                const uint32_t first = bucket_start[bucket];
+                const uint32_t last = bucket_start[bucket + 1];
+                if (first == last)
+                {
+                    break; // Only empty buckets remain
+                }
+
+                bool placed = false;
+                for (uint32_t d = 0; d <= kMaxDisplacement && !placed; ++d)
+                {
+                    chosen.clear();
+                    placed = true;
+                    for (uint32_t k = first; k < last; ++k)
+                    {
+                        const uint32_t group = group_for(hashes[bucket_keys[k]], d);
+                        if (fill[group] == kGroupWidth)
+                        {
+                            placed = false;
+                            break;
+                        }
+                        fill[group]++;
+                        chosen.push_back(group);
+                    }
+
+                    if (placed)
+                    {
+                        m_displacements[bucket] = static_cast<uint16_t>(d);
+                        for (uint32_t k = first; k < last; ++k)
+                        {
+                            group_of_key[bucket_keys[k]] = chosen[k - first];
+                        }
+                    }
+                    else
+                    {
+                        for (const uint32_t group : chosen)
+                        {
+                            fill[group]--;
+                        }
+                    }
+                }
+
+                if (!placed)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::vector<GroupSlots> m_groups;
+        std::vector<uint16_t> m_displacements;
+        std::vector<Key> m_keys;
+        std::vector<Value> m_values;
+        uint32_t m_bucket_count = 0;
+        uint32_t m_group_count = 0;
+    };
+
+} // namespace optimap
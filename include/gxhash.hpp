@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <cassert>
 #include <cstddef>
@@ -25,7 +26,26 @@
 #include <smmintrin.h>
 #include <wmmintrin.h> // For AESENC/AESKEYGEN
 #define GXHASH_HAVE_AES_INTRINSICS 1
+#define GXHASH_HAVE_VAES 1
+// The AES functions carry their own target, so the header builds without -maes and the
+// instructions are only used once the CPU is known to have them
+#define GXHASH_AES_TARGET __attribute__((target("aes,sse4.1")))
+#define GXHASH_VAES_TARGET __attribute__((target("vaes,avx2,aes,sse4.1")))
+#if defined(__VAES__) && defined(__AVX2__)
+#define GXHASH_COMPILE_TIME_VAES 1
+#elif defined(__AES__)
+#define GXHASH_COMPILE_TIME_AES 1
+#else
+#define GXHASH_RUNTIME_DISPATCH 1
+#endif
 #endif
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO))
+// ARMv8 crypto extension (AESE/AESMC), e.g. -march=armv8-a+crypto
+#include <arm_neon.h>
+#define GXHASH_HAVE_AES_INTRINSICS 1
+#define GXHASH_AES_NEON 1
+#define GXHASH_AES_TARGET
+#define GXHASH_COMPILE_TIME_AES 1
 #endif
 
 namespace gxhash
@@ -63,6 +83,27 @@ namespace gxhash
             return x;
         }
 
+        // 64x64 -> 128-bit multiply with the two halves folded together by xor
+        static inline uint64_t folded_multiply(uint64_t a, uint64_t b) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            const __uint128_t r = static_cast<__uint128_t>(a) * b;
+            return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            uint64_t hi;
+            const uint64_t lo = _umul128(a, b, &hi);
+            return lo ^ hi;
+#else
+            const uint64_t a_lo = a & 0xffffffffULL, a_hi = a >> 32;
+            const uint64_t b_lo = b & 0xffffffffULL, b_hi = b >> 32;
+            const uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo;
+            const uint64_t mid = (ll >> 32) + (lh & 0xffffffffULL) + (hl & 0xffffffffULL);
+            const uint64_t lo = (mid << 32) | (ll & 0xffffffffULL);
+            const uint64_t hi = a_hi * b_hi + (lh >> 32) + (hl >> 32) + (mid >> 32);
+            return lo ^ hi;
+#endif
+        }
+
         static inline uint64_t mix64(uint64_t a, uint64_t b) noexcept
         {
             uint64_t z = a ^ b;
@@ -72,10 +113,13 @@ namespace gxhash
             return z;
         }
 
-        // Runtime AES detection (x86)
+        // Runtime AES detection (x86). On ARM the crypto extension is a compile-time target
+        // feature, so it is always available once GXHASH_AES_NEON is defined
         static inline bool cpu_supports_aes() noexcept
         {
-#if (defined(__x86_64__) || defined(__i386))
+#if defined(GXHASH_AES_NEON)
+            return true;
+#elif (defined(__x86_64__) || defined(__i386))
 #if defined(__GNUC__) || defined(__clang__)
 #if defined(__has_builtin)
 #if __has_builtin(__builtin_cpu_supports)
@@ -94,58 +138,139 @@ namespace gxhash
 #endif
         }
 
-    } // namespace detail
+#if defined(GXHASH_HAVE_AES_INTRINSICS)
+        // 128-bit block operations used by the AES path, one set per instruction set so that
+        // the algorithm below is written once. AESE xors the key before SubBytes/ShiftRows and
+        // AESMC applies MixColumns, so AESMC(AESE(a, 0)) ^ k equals x86 AESENC(a, k) and both
+        // produce identical hashes
+#if defined(GXHASH_AES_NEON)
+        using aes_block = uint8x16_t;
+
+        static inline aes_block aes_load(const uint8_t* p) noexcept
+        {
+            return vld1q_u8(p);
+        }
 
-    // gxhash64 implementation
-    inline uint64_t gxhash64(const void* data, size_t len, uint64_t seed = 0) noexcept
-    {
-        const size_t orig_len = len; // Save original length for finalization
+        static inline void aes_store(uint8_t* p, aes_block block) noexcept
+        {
+            vst1q_u8(p, block);
+        }
 
-        // Defensive handling of null pointer with non-zero length
-        if (data == nullptr)
+        static inline aes_block aes_set64(uint64_t hi, uint64_t lo) noexcept
         {
-            if (orig_len == 0)
-            {
-                // empty input \implies deterministic result derived from seed
-                return detail::final_avalanche(seed ^ 0x9e3779b97f4a7c15ULL);
-            }
+            return vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(lo), vcreate_u64(hi)));
+        }
 
-            // Invalid input: data==nullptr but len>0. In debug builds assert;
-            // in release builds return a deterministic mix so we avoid UB/crash.
-            assert(false && "gxhash64: data == nullptr but len > 0 (invalid)");
-            return detail::final_avalanche(
-                    seed ^ (static_cast<uint64_t>(orig_len) * 0x9e3779b97f4a7c15ULL)
-            );
+        static inline aes_block aes_xor(aes_block a, aes_block b) noexcept
+        {
+            return veorq_u8(a, b);
         }
 
-        const uint8_t* ptr = static_cast<const uint8_t*>(data);
+        static inline aes_block aes_encrypt_round(aes_block a, aes_block key) noexcept
+        {
+            return veorq_u8(vaesmcq_u8(vaeseq_u8(a, vdupq_n_u8(0))), key);
+        }
+#else
+        using aes_block = __m128i;
 
-        // AES-NI accelerated path (if compiled & available)
-#if defined(GXHASH_HAVE_AES_INTRINSICS)
-        static bool has_aes = detail::cpu_supports_aes();
-        if (has_aes)
-        {
-            const uint64_t C1 = 0x9e3779b97f4a7c15ULL;
-            const uint64_t C2 = 0xc6a4a7935bd1e995ULL;
-            __m128i acc = _mm_set_epi64x(
-                    static_cast<long long>(seed ^ C1),
-                    static_cast<long long>((~seed) ^ C2)
-            );
+        GXHASH_AES_TARGET static inline aes_block aes_load(const uint8_t* p) noexcept
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
 
-            const __m128i RK1 = _mm_set_epi64x(0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL);
-            const __m128i RK2 = _mm_set_epi64x(0xa4093822299f31d0ULL, 0x082efa98ec4e6c89ULL);
-            const __m128i RK3 = _mm_set_epi64x(0x452821e638d01377ULL, 0xbe5466cf34e90c6cULL);
+        GXHASH_AES_TARGET static inline void aes_store(uint8_t* p, aes_block block) noexcept
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p), block);
+        }
 
-            size_t remaining = len;
-            const uint8_t* p = ptr;
+        GXHASH_AES_TARGET static inline aes_block aes_set64(uint64_t hi, uint64_t lo) noexcept
+        {
+            return _mm_set_epi64x(static_cast<long long>(hi), static_cast<long long>(lo));
+        }
+
+        GXHASH_AES_TARGET static inline aes_block aes_xor(aes_block a, aes_block b) noexcept
+        {
+            return _mm_xor_si128(a, b);
+        }
+
+        GXHASH_AES_TARGET static inline aes_block
+        aes_encrypt_round(aes_block a, aes_block key) noexcept
+        {
+            return _mm_aesenc_si128(a, key);
+        }
+#endif
+
+        inline constexpr uint64_t kSeedC1 = 0x9e3779b97f4a7c15ULL;
+        inline constexpr uint64_t kSeedC2 = 0xc6a4a7935bd1e995ULL;
+        inline constexpr uint64_t kRoundKeys[3][2] = {
+                {0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL},
+                {0xa4093822299f31d0ULL, 0x082efa98ec4e6c89ULL},
+                {0x452821e638d01377ULL, 0xbe5466cf34e90c6cULL},
+        };
+
+        // Long inputs are absorbed as 128-byte stripes by 8 independent lanes, one 16-byte
+        // block each, so 8 AES chains are in flight instead of 1. Shorter inputs, and what is
+        // left after the last full stripe, go through the single accumulator
+        inline constexpr size_t kAesLanes = 8;
+        inline constexpr size_t kAesStripe = kAesLanes * 16;
+
+        // Initial state of lane i, distinct per lane
+        GXHASH_AES_TARGET static inline aes_block aes_lane_seed(aes_block acc, size_t i) noexcept
+        {
+            const uint64_t k = static_cast<uint64_t>(i + 1) * kSeedC1;
+            return aes_encrypt_round(acc, aes_set64(k, ~k));
+        }
+
+        // Two rounds per block on each lane, then the lanes are folded into one state in order,
+        // so the result depends on which lane (and so which offset) every block came from
+        GXHASH_AES_TARGET static inline aes_block aes_absorb_stripes(
+                aes_block acc, const uint8_t*& p, size_t& remaining
+        ) noexcept
+        {
+            const aes_block RK1 = aes_set64(kRoundKeys[0][0], kRoundKeys[0][1]);
+            const aes_block RK2 = aes_set64(kRoundKeys[1][0], kRoundKeys[1][1]);
+
+            aes_block lanes[kAesLanes];
+            for (size_t i = 0; i < kAesLanes; ++i)
+            {
+                lanes[i] = aes_lane_seed(acc, i);
+            }
+
+            while (remaining >= kAesStripe)
+            {
+                for (size_t i = 0; i < kAesLanes; ++i)
+                {
+                    lanes[i] = aes_xor(lanes[i], aes_load(p + 16 * i));
+                    lanes[i] = aes_encrypt_round(lanes[i], RK1);
+                    lanes[i] = aes_encrypt_round(lanes[i], RK2);
+                }
+                p += kAesStripe;
+                remaining -= kAesStripe;
+            }
+
+            for (size_t i = 0; i < kAesLanes; ++i)
+            {
+                acc = aes_encrypt_round(acc, lanes[i]);
+            }
+            return acc;
+        }
+
+        // Single-accumulator blocks, the zero-padded tail and the final fold
+        GXHASH_AES_TARGET static inline uint64_t aes_finish(
+                aes_block acc, const uint8_t* p, size_t remaining, size_t len, uint64_t seed
+        ) noexcept
+        {
+            const aes_block RK1 = aes_set64(kRoundKeys[0][0], kRoundKeys[0][1]);
+            const aes_block RK2 = aes_set64(kRoundKeys[1][0], kRoundKeys[1][1]);
+            const aes_block RK3 = aes_set64(kRoundKeys[2][0], kRoundKeys[2][1]);
 
             while (remaining >= 16)
             {
-                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
-                acc = _mm_xor_si128(acc, block);
-                acc = _mm_aesenc_si128(acc, RK1);
-                acc = _mm_aesenc_si128(acc, RK2);
-                acc = _mm_aesenc_si128(acc, RK3);
+                aes_block block = aes_load(p);
+                acc = aes_xor(acc, block);
+                acc = aes_encrypt_round(acc, RK1);
+                acc = aes_encrypt_round(acc, RK2);
+                acc = aes_encrypt_round(acc, RK3);
 
                 p += 16;
 
@@ -158,86 +283,233 @@ namespace gxhash
                 std::memset(tail, 0, sizeof(tail));
                 std::memcpy(tail, p, remaining);
 
-                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tail));
+                aes_block block = aes_load(tail);
 
-                acc = _mm_xor_si128(acc, block);
-                acc = _mm_aesenc_si128(acc, RK2);
-                acc = _mm_aesenc_si128(acc, RK3);
+                acc = aes_xor(acc, block);
+                acc = aes_encrypt_round(acc, RK2);
+                acc = aes_encrypt_round(acc, RK3);
             }
 
             // Store accumulator to bytes and extract two 64-bit lanes
             alignas(16) uint8_t acc_bytes[16];
-            _mm_storeu_si128(reinterpret_cast<__m128i*>(acc_bytes), acc);
-            uint64_t lo = detail::fetch_u64_unaligned(acc_bytes);
-            uint64_t hi = detail::fetch_u64_unaligned(acc_bytes + 8);
+            aes_store(acc_bytes, acc);
+            uint64_t lo = fetch_u64_unaligned(acc_bytes);
+            uint64_t hi = fetch_u64_unaligned(acc_bytes + 8);
 
-            uint64_t folded = hi ^ lo ^ seed ^ (static_cast<uint64_t>(orig_len) << 3);
-            return detail::final_avalanche(folded);
+            uint64_t folded = hi ^ lo ^ seed ^ (static_cast<uint64_t>(len) << 3);
+            return final_avalanche(folded);
         }
-#endif // GXHASH_HAVE_AES_INTRINSICS
-
-        // Portable fallback
-        uint64_t state = seed ^ 0x9e3779b97f4a7c15ULL;
-        const uint64_t MUL1 = 0x9ddfea08eb382d69ULL;
 
-        // Use local pointer & local remaining to not touch original len variable
-        const uint8_t* p = ptr;
-        size_t remaining = len;
+        GXHASH_AES_TARGET inline uint64_t
+        gxhash64_aes(const uint8_t* p, size_t len, uint64_t seed) noexcept
+        {
+            aes_block acc = aes_set64(seed ^ kSeedC1, (~seed) ^ kSeedC2);
+            size_t remaining = len;
+            if (remaining >= kAesStripe)
+            {
+                acc = aes_absorb_stripes(acc, p, remaining);
+            }
+            return aes_finish(acc, p, remaining, len, seed);
+        }
 
-        while (remaining >= 16)
+#if defined(GXHASH_HAVE_VAES)
+        // Same hash as gxhash64_aes, with the 8 lanes held in pairs by four 256-bit registers:
+        // VAES runs the 128-bit AES round on both halves of a register at once
+        GXHASH_VAES_TARGET inline uint64_t
+        gxhash64_vaes(const uint8_t* p, size_t len, uint64_t seed) noexcept
         {
-            uint64_t a = detail::fetch_u64_unaligned(p);
-            uint64_t b = detail::fetch_u64_unaligned(p + 8);
+            aes_block acc = aes_set64(seed ^ kSeedC1, (~seed) ^ kSeedC2);
+            size_t remaining = len;
+            if (remaining >= kAesStripe)
+            {
+                const __m256i RK1 =
+                        _mm256_broadcastsi128_si256(aes_set64(kRoundKeys[0][0], kRoundKeys[0][1]));
+                const __m256i RK2 =
+                        _mm256_broadcastsi128_si256(aes_set64(kRoundKeys[1][0], kRoundKeys[1][1]));
 
-            state += a * MUL1;
-            uint64_t m = detail::mix64(
-                    a ^ (detail::rotl64(b, 23) + (state ^ (state >> 41))),
-                    b ^ (state + 0x9e3779b97f4a7c15ULL)
-            );
-            state ^= m;
-            state = detail::rotl64(state, 27) * 0x3C79AC492BA7B653ULL;
+                __m256i pairs[kAesLanes / 2];
+                for (size_t i = 0; i < kAesLanes / 2; ++i)
+                {
+                    pairs[i] = _mm256_set_m128i(
+                            aes_lane_seed(acc, 2 * i + 1), aes_lane_seed(acc, 2 * i)
+                    );
+                }
+
+                while (remaining >= kAesStripe)
+                {
+                    for (size_t i = 0; i < kAesLanes / 2; ++i)
+                    {
+                        const __m256i block =
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * i));
+                        pairs[i] = _mm256_xor_si256(pairs[i], block);
+                        pairs[i] = _mm256_aesenc_epi128(pairs[i], RK1);
+                        pairs[i] = _mm256_aesenc_epi128(pairs[i], RK2);
+                    }
+                    p += kAesStripe;
+                    remaining -= kAesStripe;
+                }
 
-            p += 16;
-            remaining -= 16;
+                for (size_t i = 0; i < kAesLanes / 2; ++i)
+                {
+                    acc = aes_encrypt_round(acc, _mm256_castsi256_si128(pairs[i]));
+                    acc = aes_encrypt_round(acc, _mm256_extracti128_si256(pairs[i], 1));
+                }
+            }
+            return aes_finish(acc, p, remaining, len, seed);
         }
+#endif
+#endif // GXHASH_HAVE_AES_INTRINSICS
 
-        if (remaining >= 8)
+        // Portable fallback
+        inline uint64_t gxhash64_portable(const uint8_t* p, size_t len, uint64_t seed) noexcept
         {
-            uint64_t a = detail::fetch_u64_unaligned(p);
+            uint64_t state = seed ^ 0x9e3779b97f4a7c15ULL;
+            const uint64_t MUL1 = 0x9ddfea08eb382d69ULL;
 
-            state += a ^ 0x9e3779b97f4a7c15ULL;
-            state = detail::mix64(state, a);
+            size_t remaining = len;
 
-            p += 8;
-            remaining -= 8;
+            while (remaining >= 16)
+            {
+                uint64_t a = fetch_u64_unaligned(p);
+                uint64_t b = fetch_u64_unaligned(p + 8);
+
+                state += a * MUL1;
+                uint64_t m = mix64(
+                        a ^ (rotl64(b, 23) + (state ^ (state >> 41))),
+                        b ^ (state + 0x9e3779b97f4a7c15ULL)
+                );
+                state ^= m;
+                state = rotl64(state, 27) * 0x3C79AC492BA7B653ULL;
+
+                p += 16;
+                remaining -= 16;
+            }
+
+            if (remaining >= 8)
+            {
+                uint64_t a = fetch_u64_unaligned(p);
+
+                state += a ^ 0x9e3779b97f4a7c15ULL;
+                state = mix64(state, a);
+
+                p += 8;
+                remaining -= 8;
+            }
+
+            if (remaining >= 4)
+            {
+                uint32_t a32 = fetch_u32_unaligned(p);
+
+                state += static_cast<uint64_t>(a32) * 0x85ebca6bULL;
+                state = mix64(state, static_cast<uint64_t>(a32));
+
+                p += 4;
+                remaining -= 4;
+            }
+
+            if (remaining > 0)
+            {
+                uint64_t tail = 0;
+                for (size_t i = 0; i < remaining; ++i)
+                {
+                    tail |= (uint64_t(p[i]) << (i * 8));
+                }
+
+                state += tail * 0x27d4eb2f165667c5ULL;
+                state = mix64(state, tail);
+            }
+
+            state ^= (static_cast<uint64_t>(seed) << 7);
+            state += (static_cast<uint64_t>(len) << 3);
+            return final_avalanche(state);
         }
 
-        if (remaining >= 4)
+        using hash_bytes_fn = uint64_t (*)(const uint8_t*, size_t, uint64_t) noexcept;
+
+#if defined(GXHASH_RUNTIME_DISPATCH)
+        static inline bool cpu_supports_vaes() noexcept
         {
-            uint32_t a32 = detail::fetch_u32_unaligned(p);
+#if defined(GXHASH_HAVE_VAES)
+            return __builtin_cpu_supports("vaes") && __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+        }
+
+        inline uint64_t gxhash64_resolve(const uint8_t* p, size_t len, uint64_t seed) noexcept;
 
-            state += static_cast<uint64_t>(a32) * 0x85ebca6bULL;
-            state = detail::mix64(state, static_cast<uint64_t>(a32));
+        // Implementation picked for this CPU. Starts at the resolver, which is a constant
+        // initializer, so hashing during static initialization of other translation units is
+        // safe. Threads racing through the resolver store the same pointer
+        inline std::atomic<hash_bytes_fn> g_gxhash64_impl{&gxhash64_resolve};
 
-            p += 4;
-            remaining -= 4;
+        inline uint64_t gxhash64_resolve(const uint8_t* p, size_t len, uint64_t seed) noexcept
+        {
+            hash_bytes_fn impl = &gxhash64_portable;
+#if defined(GXHASH_HAVE_VAES)
+            if (cpu_supports_vaes())
+            {
+                impl = &gxhash64_vaes;
+            }
+            else
+#endif
+            if (cpu_supports_aes())
+            {
+                impl = &gxhash64_aes;
+            }
+            g_gxhash64_impl.store(impl, std::memory_order_relaxed);
+            return impl(p, len, seed);
         }
+#endif
 
-        if (remaining > 0)
+    } // namespace detail
+
+    // gxhash64 implementation. The AES path is chosen at compile time when the target enables
+    // the instructions (-maes, -march=native, ARMv8 crypto), and otherwise once per process
+    // from the CPU's features; the byte-oriented portable path is the last resort. VAES only
+    // changes how fast long inputs are absorbed, never the hash value
+    inline uint64_t gxhash64(const void* data, size_t len, uint64_t seed = 0) noexcept
+    {
+        // Defensive handling of null pointer with non-zero length
+        if (data == nullptr)
         {
-            uint64_t tail = 0;
-            for (size_t i = 0; i < remaining; ++i)
+            if (len == 0)
             {
-                tail |= (uint64_t(p[i]) << (i * 8));
+                // empty input \implies deterministic result derived from seed
+                return detail::final_avalanche(seed ^ 0x9e3779b97f4a7c15ULL);
             }
 
-            state += tail * 0x27d4eb2f165667c5ULL;
-            state = detail::mix64(state, tail);
+            // Invalid input: data==nullptr but len>0. In debug builds assert;
+            // in release builds return a deterministic mix so we avoid UB/crash.
+            assert(false && "gxhash64: data == nullptr but len > 0 (invalid)");
+            return detail::final_avalanche(
+                    seed ^ (static_cast<uint64_t>(len) * 0x9e3779b97f4a7c15ULL)
+            );
         }
 
-        state ^= (static_cast<uint64_t>(seed) << 7);
-        state += (static_cast<uint64_t>(orig_len) << 3); // Use original length
-        return detail::final_avalanche(state);
+        const uint8_t* ptr = static_cast<const uint8_t*>(data);
+
+#if defined(GXHASH_COMPILE_TIME_VAES)
+        return detail::gxhash64_vaes(ptr, len, seed);
+#elif defined(GXHASH_COMPILE_TIME_AES)
+        return detail::gxhash64_aes(ptr, len, seed);
+#elif defined(GXHASH_RUNTIME_DISPATCH)
+        return detail::g_gxhash64_impl.load(std::memory_order_relaxed)(ptr, len, seed);
+#else
+        return detail::gxhash64_portable(ptr, len, seed);
+#endif
+    }
+
+    // Hash of a single integer of up to 64 bits. Two dependent folded multiplies, with no
+    // branches, memory traffic or CPU feature check, make it several times cheaper than
+    // gxhash64 on the key's bytes. One multiply leaves the low output bits (used for the
+    // home slot) blind to the high input bits; the second round gives every output bit,
+    // including the top 7 used for the control-byte fingerprint, full avalanche
+    inline uint64_t gxhash_int(uint64_t x, uint64_t seed = 0) noexcept
+    {
+        const uint64_t m =
+                detail::folded_multiply(x ^ seed ^ 0x243f6a8885a308d3ULL, 0x9e3779b97f4a7c15ULL);
+        return detail::folded_multiply(m ^ 0x13198a2e03707344ULL, 0xd6e8feb86659fd93ULL);
     }
 
     // 128-bit GxHash function returns a 128-bit hash as two uint64_t halves.
@@ -257,24 +529,31 @@ namespace gxhash
         seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
     }
 
-    // Fundamental templates
+    // Fundamental templates. The hashers below also take a seed as a second argument, which
+    // HashMap passes its per-map seed through (see HashMap::reseed). Seed 0 gives the same
+    // hash as the one-argument form
     template <typename T> struct GxHash
     {
-        std::size_t operator()(const T& key) const noexcept
+        std::size_t operator()(const T& key, uint64_t seed = 0) const noexcept
         {
-            if constexpr (std::is_integral_v<T>)
+            if constexpr (std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t))
             {
-                // Hash integer by treating its bytes as data
-                return static_cast<std::size_t>(gxhash64(&key, sizeof(T), 0));
+                // Sign extension keeps equal values of different widths on the same hash
+                return static_cast<std::size_t>(gxhash_int(static_cast<uint64_t>(key), seed));
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                // Wider integers (__int128) are hashed as bytes
+                return static_cast<std::size_t>(gxhash64(&key, sizeof(T), seed));
             }
             else if constexpr (std::is_floating_point_v<T>)
             {
                 // For floats: treat -0.0 same as 0.0
                 if (key == 0.0)
                 {
-                    return GxHash<int>{}(0);
+                    return GxHash<int>{}(0, seed);
                 }
-                return static_cast<std::size_t>(gxhash64(&key, sizeof(T), 0));
+                return static_cast<std::size_t>(gxhash64(&key, sizeof(T), seed));
             }
             else
             {
@@ -282,7 +561,7 @@ namespace gxhash
                         std::is_trivially_copyable_v<T>,
                         "GxHash requires trivially copyable types"
                 );
-                return static_cast<std::size_t>(gxhash64(&key, sizeof(T), 0));
+                return static_cast<std::size_t>(gxhash64(&key, sizeof(T), seed));
             }
         }
     };
@@ -290,11 +569,11 @@ namespace gxhash
     // Pointers
     template <typename T> struct GxHash<T*>
     {
-        std::size_t operator()(T* ptr) const noexcept
+        std::size_t operator()(T* ptr, uint64_t seed = 0) const noexcept
         {
             // Hash the address value
             uint64_t addr = reinterpret_cast<uintptr_t>(ptr);
-            return static_cast<std::size_t>(gxhash64(&addr, sizeof(addr), 0));
+            return static_cast<std::size_t>(gxhash64(&addr, sizeof(addr), seed));
         }
     };
 
@@ -323,27 +602,44 @@ namespace gxhash
     };
 
     // Strings
+    // The string hashers are transparent: std::string, std::string_view and const char* with
+    // the same characters hash identically, so maps keyed by std::string can be queried without
+    // constructing a temporary key
     template <> struct GxHash<std::string>
     {
-        std::size_t operator()(const std::string& s) const noexcept
+        using is_transparent = void;
+
+        std::size_t operator()(const std::string& s, uint64_t seed = 0) const noexcept
+        {
+            return static_cast<std::size_t>(gxhash64(s.data(), s.size(), seed));
+        }
+
+        std::size_t operator()(std::string_view sv, uint64_t seed = 0) const noexcept
         {
-            return static_cast<std::size_t>(gxhash64(s.data(), s.size(), 0));
+            return static_cast<std::size_t>(gxhash64(sv.data(), sv.size(), seed));
+        }
+
+        std::size_t operator()(const char* s, uint64_t seed = 0) const noexcept
+        {
+            return static_cast<std::size_t>(gxhash64(s, std::strlen(s), seed));
         }
     };
 
     template <> struct GxHash<std::string_view>
     {
-        std::size_t operator()(const std::string_view& sv) const noexcept
+        using is_transparent = void;
+
+        std::size_t operator()(const std::string_view& sv, uint64_t seed = 0) const noexcept
         {
-            return static_cast<std::size_t>(gxhash64(sv.data(), sv.size(), 0));
+            return static_cast<std::size_t>(gxhash64(sv.data(), sv.size(), seed));
         }
     };
 
     template <> struct GxHash<const char*>
     {
-        std::size_t operator()(const char* s) const noexcept
+        std::size_t operator()(const char* s, uint64_t seed = 0) const noexcept
         {
-            return static_cast<std::size_t>(gxhash64(s, std::strlen(s), 0));
+            return static_cast<std::size_t>(gxhash64(s, std::strlen(s), seed));
         }
     };
 
@@ -3,20 +3,88 @@
 #include "gxhash.hpp"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
 #include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <functional>
+#include <istream>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <memory_resource>
 #include <new>
 #include <optional>
+#include <ostream>
+#include <random>
+#include <ranges>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+// [[no_unique_address]] is accepted but ignored by MSVC, which spells it with its own prefix
+#if defined(_MSC_VER)
+#define OPTIMAP_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define OPTIMAP_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define OPTIMAP_HAVE_MMAP 1
+#endif
+
 #if defined(__SSE2__) || (defined(_M_X64) || defined(_M_IX86))
 #include <immintrin.h>
 #if defined(_MSC_VER)
 #include <intrin.h>
 #endif
+#define OPTIMAP_HAVE_SSE2 1
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#include <arm_neon.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#define OPTIMAP_HAVE_NEON 1
+#endif
+
+// Number of slots per control group, i.e. scanned by one probe step. 16 fits an SSE2/NEON
+// register; 32 (AVX2) and 64 (AVX-512BW) cover more slots per step, which shortens long probe
+// sequences at high load factors. Must be the same in every translation unit of a program
+#ifndef OPTIMAP_GROUP_WIDTH
+#define OPTIMAP_GROUP_WIDTH 16
+#endif
+
+#if OPTIMAP_GROUP_WIDTH != 16 && OPTIMAP_GROUP_WIDTH != 32 && OPTIMAP_GROUP_WIDTH != 64
+#error "OPTIMAP_GROUP_WIDTH must be 16, 32 or 64"
+#endif
+
+// Group backend: SIMD for the widths the target supports, scalar otherwise
+#if defined(OPTIMAP_HAVE_SSE2) && OPTIMAP_GROUP_WIDTH == 16
+#define OPTIMAP_GROUP_SSE2 1
+#elif defined(OPTIMAP_HAVE_SSE2) && OPTIMAP_GROUP_WIDTH == 32
+#if !defined(__AVX2__)
+#error "OPTIMAP_GROUP_WIDTH=32 requires AVX2 (e.g. -mavx2 or -march=native)"
+#endif
+#define OPTIMAP_GROUP_AVX2 1
+#elif defined(OPTIMAP_HAVE_SSE2) && OPTIMAP_GROUP_WIDTH == 64
+#if !defined(__AVX512BW__)
+#error "OPTIMAP_GROUP_WIDTH=64 requires AVX-512BW (e.g. -mavx512bw or -march=native)"
+#endif
+#define OPTIMAP_GROUP_AVX512 1
+#elif defined(OPTIMAP_HAVE_NEON) && OPTIMAP_GROUP_WIDTH == 16
+#define OPTIMAP_GROUP_NEON 1
 #endif
 
 template <typename T, size_t Alignment> struct AlignedAllocator
@@ -86,51 +154,92 @@ namespace optimap
 
     using namespace gxhash;
 
-    template <typename Key, typename Value, typename Hash = GxHash<Key>> class HashMap
+    namespace detail
     {
-      public:
-        struct Entry
-        {
-            Key first;
-            Value second;
-
-            bool operator==(const Entry& other) const
-            {
-                return first == other.first && second == other.second;
-            }
-        };
-
-      private:
-        // 16 control bytes = size of a SIMD register. Allows
+        // Heterogeneous lookup: satisfied when Hash opts in by declaring is_transparent and a K
+        // can be hashed and compared against a Key directly, without constructing a Key
+        template <typename Hash, typename Key, typename K>
+        concept transparent_key = requires { typename Hash::is_transparent; } &&
+                                  requires(const Hash& hash, const Key& key, const K& query) {
+                                      { hash(query) } -> std::convertible_to<size_t>;
+                                      { key == query } -> std::convertible_to<bool>;
+                                  };
+
+        // Control bytes per group (16 by default = size of an SSE2 register). Allows
         // efficient, parallel operations on multiple slots simultaneously
-        static constexpr size_t kGroupWidth = 16;
-
-        // Aligns the hash map's internal storage to cache line boundary. Prevents
-        // single group of control bytes from splitting across two cache lines, significantly
-        // degrading performance
-        static constexpr size_t kCacheLineSize = 64;
+        inline constexpr size_t kGroupWidth = OPTIMAP_GROUP_WIDTH;
 
         // Control bytes are used to mark the state of each slot in the map.
-        // Negative values indicate special empty or deleted states.
-        // Positive values (0-127) store the h2 hash (top 7 bits of full hash)
-        static constexpr int8_t kEmpty = -128; // 0b10000000
-        static constexpr int8_t kDeleted = -2; // 0b11111110
+        // Full slots have the high bit set and store the h2 hash (top 7 bits of full hash)
+        // in the low bits. Empty is all zeros, so zero-filled memory (fresh mmap pages) is
+        // already a valid table of empty slots and needs no initialization pass
+        inline constexpr int8_t kEmpty = 0;   // 0b00000000
+        inline constexpr int8_t kDeleted = 1; // 0b00000001
 
-        struct FindResult
+        constexpr bool is_full(int8_t ctrl)
         {
-            size_t index;
-            bool found;
+            return ctrl < 0;
+        }
+
+        // Control byte of a full slot for hash
+        constexpr int8_t h2_of(size_t hash)
+        {
+            return static_cast<int8_t>((hash >> (sizeof(size_t) * 8 - 7)) | 0x80);
+        }
+
+        // Header of a table saved with HashMap::write_to, padded to kTableFileHeaderBytes. The
+        // table block follows it byte for byte, so a file can be mapped and used in place. Every
+        // field that affects where an entry lives is recorded and checked on load
+        struct TableFileHeader
+        {
+            static constexpr char kMagic[8] = {'O', 'P', 'T', 'I', 'M', 'A', 'P', '\0'};
+            static constexpr uint32_t kVersion = 1;
+            static constexpr uint32_t kByteOrderMark = 0x01020304;
+
+            char magic[8];
+            uint32_t version;
+            uint32_t byte_order;
+            uint32_t group_width;
+            uint32_t store_hash;
+            uint64_t slot_size;
+            uint64_t slot_align;
+            uint64_t capacity;
+            uint64_t size;
+            uint64_t tombstones;
+            uint64_t buckets_offset;
+            uint64_t group_mask_offset;
+            uint64_t block_bytes;
+            uint64_t hash_seed;  // HashMap::seed() of the saved table
+            uint64_t hash_check; // Hash of a value-initialized key, catches a different Hash
+            uint64_t probe_policy; // ProbePolicy::kId. Zero padding in older files reads as linear
         };
 
-#if defined(__SSE2__) || (defined(_M_X64) || defined(_M_IX86))
-        // A wrapper around a SIMD bitmask. Provides iterator-like interface
-        // for efficiently finding the set bits, corresponding to matching slots
+        inline constexpr size_t kTableFileHeaderBytes = 128;
+        static_assert(sizeof(TableFileHeader) <= kTableFileHeaderBytes);
 
+        // Allocators whose memory is always zero-filled (such as HugePageAllocator, backed by
+        // fresh anonymous mappings) opt out of the control byte initialization pass by declaring
+        // static constexpr bool allocates_zeroed_memory = true
+        template <typename Allocator>
+        inline constexpr bool allocates_zeroed_memory = requires {
+            requires Allocator::allocates_zeroed_memory;
+        };
+
+        // A wrapper around a group match bitmask. Provides iterator-like interface
+        // for efficiently finding the set bits, corresponding to matching slots.
+        // SSE2 and the scalar fallback produce one bit per slot. NEON has no movemask, so
+        // its masks spend a nibble per slot (kShift = 2) with only the top bit of each kept
         struct BitMask
         {
-            uint32_t mask;
+#if defined(OPTIMAP_GROUP_NEON)
+            static constexpr int kShift = 2;
+#else
+            static constexpr int kShift = 0;
+#endif
 
-            explicit BitMask(uint32_t m) : mask(m) {}
+            uint64_t mask;
+
+            explicit BitMask(uint64_t m) : mask(m) {}
 
             // Returns true if there are any bits set
             explicit operator bool() const
@@ -138,17 +247,11 @@ namespace optimap
                 return mask != 0;
             }
 
-            // Returns the index of the lowest set bit
+            // Returns the slot index of the lowest match
             // Assumes the mask is not empty
-            int next()
+            int next() const
             {
-#if defined(_MSC_VER)
-                unsigned long i;
-                _BitScanForward(&i, mask);
-                return i;
-#else
-                return __builtin_ctz(mask);
-#endif
+                return ctzll(mask) >> kShift;
             }
 
             // Advances to the next bit, clearing the one that was just processed
@@ -157,11 +260,17 @@ namespace optimap
                 mask &= (mask - 1);
             }
 
+            // Drops the matches for the slots before slot
+            void skip_before(size_t slot)
+            {
+                mask &= (~UINT64_C(0)) << (slot << kShift);
+            }
+
             // Returns the index of the lowest set bit
             // Assumes the mask is not empty
             static int ctzll(uint64_t n)
             {
-#if defined(_MSC_VER) && defined(_M_X64)
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
                 unsigned long i;
                 _BitScanForward64(&i, n);
                 return i;
@@ -171,6 +280,7 @@ namespace optimap
             }
         };
 
+#if defined(OPTIMAP_GROUP_SSE2)
         // Represents a group of 16 control bytes loaded into a SIMD register.
         // This allows for parallel matching of h2 hashes and special states.
         struct Group
@@ -186,637 +296,2694 @@ namespace optimap
             // Returns a bitmask of slots that match the given H2 hash
             BitMask match_h2(int8_t hash) const
             {
-                return BitMask(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(hash))));
+                return to_mask(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(hash))));
             }
 
             // Returns a bitmask of slots that are empty
             // The termination condition for a probe sequence
             BitMask match_empty() const
             {
-                return BitMask(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(kEmpty))));
+                return to_mask(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(kEmpty))));
             }
 
             // Returns a bitmask of slots that are empty OR deleted
             // This is used to find a suitable slot for insertion
             BitMask match_empty_or_deleted() const
             {
-                // Any control byte with the MSB set is either empty or deleted
-                return BitMask(_mm_movemask_epi8(ctrl));
+                return to_mask(~_mm_movemask_epi8(ctrl) & 0xFFFF);
+            }
+
+            // Returns a bitmask of slots that hold an entry
+            BitMask match_full() const
+            {
+                // Any control byte with the MSB set is full
+                return to_mask(_mm_movemask_epi8(ctrl));
+            }
+
+            // Stores the group to p with the slots whose lane in erased is -1 turned into
+            // tombstones. Lanes of erased are 0 or -1
+            void store_deleted(int8_t* p, const int8_t* erased) const
+            {
+                const __m128i lanes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(erased));
+                const __m128i result = _mm_or_si128(
+                        _mm_andnot_si128(lanes, ctrl), _mm_and_si128(lanes, _mm_set1_epi8(kDeleted))
+                );
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p), result);
+            }
+
+          private:
+            static BitMask to_mask(int movemask)
+            {
+                return BitMask(static_cast<uint32_t>(movemask));
             }
         };
-#else
-        // Helper for iterating over matches without SIMD.
-        struct BitMask
+#elif defined(OPTIMAP_GROUP_AVX2)
+        // 32-wide Group in an AVX2 register. Same operations as the SSE2 group on twice the slots
+        struct Group
         {
-            uint32_t mask;
+            __m256i ctrl;
 
-            explicit BitMask(uint32_t m) : mask(m) {}
+            explicit Group(const int8_t* p)
+            {
+                ctrl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            }
 
-            explicit operator bool() const
+            BitMask match_h2(int8_t hash) const
             {
-                return mask != 0;
+                return to_mask(
+                        _mm256_movemask_epi8(_mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8(hash)))
+                );
+            }
+
+            BitMask match_empty() const
+            {
+                return to_mask(
+                        _mm256_movemask_epi8(_mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8(kEmpty)))
+                );
             }
 
-            int next()
+            BitMask match_empty_or_deleted() const
             {
-                return __builtin_ctz(mask);
+                return to_mask(~_mm256_movemask_epi8(ctrl));
             }
 
-            void advance()
+            BitMask match_full() const
             {
-                mask &= (mask - 1);
+                return to_mask(_mm256_movemask_epi8(ctrl));
             }
 
-            static int ctzll(uint64_t n)
+            void store_deleted(int8_t* p, const int8_t* erased) const
             {
-#if defined(_MSC_VER) && defined(_M_X64)
-                unsigned long i;
-                _BitScanForward64(&i, n);
-                return i;
-#else
-                return __builtin_ctzll(n);
-#endif
+                const __m256i lanes =
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(erased));
+                const __m256i result = _mm256_or_si256(
+                        _mm256_andnot_si256(lanes, ctrl),
+                        _mm256_and_si256(lanes, _mm256_set1_epi8(kDeleted))
+                );
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), result);
             }
-        };
 
-        // Fallback implementation of Group for non-SSE2 builds.
+          private:
+            static BitMask to_mask(int movemask)
+            {
+                return BitMask(static_cast<uint32_t>(movemask));
+            }
+        };
+#elif defined(OPTIMAP_GROUP_AVX512)
+        // 64-wide Group in an AVX-512 register. AVX-512BW byte compares write a 64-bit mask
+        // register directly, so no movemask step is needed
         struct Group
         {
-            const int8_t* ctrl;
+            __m512i ctrl;
 
-            explicit Group(const int8_t* p) : ctrl(p) {}
+            explicit Group(const int8_t* p) : ctrl(_mm512_loadu_si512(p)) {}
 
             BitMask match_h2(int8_t hash) const
             {
-                uint32_t mask = 0;
-                for (int i = 0; i < kGroupWidth; ++i)
-                {
-                    if (ctrl[i] == hash)
-                    {
-                        mask |= (1 << i);
-                    }
-                }
-                return BitMask(mask);
+                return BitMask(_mm512_cmpeq_epi8_mask(ctrl, _mm512_set1_epi8(hash)));
             }
 
             BitMask match_empty() const
             {
-                uint32_t mask = 0;
-                for (int i = 0; i < kGroupWidth; ++i)
-                {
-                    if (ctrl[i] == kEmpty)
-                    {
-                        mask |= (1 << i);
-                    }
-                }
-                return BitMask(mask);
+                return BitMask(_mm512_cmpeq_epi8_mask(ctrl, _mm512_set1_epi8(kEmpty)));
             }
 
             BitMask match_empty_or_deleted() const
             {
-                uint32_t mask = 0;
-                for (int i = 0; i < kGroupWidth; ++i)
-                {
-                    if (ctrl[i] < 0)
-                    {
-                        mask |= (1 << i);
-                    }
-                }
-                return BitMask(mask);
+                return BitMask(~static_cast<uint64_t>(_mm512_movepi8_mask(ctrl)));
             }
-        };
-#endif
 
-        // Core lookup function. SIMD-accelerated linear probing used to find
-        // correct slot for a key. Takes pre-computed hash to avoid
-        // redundant calculations
-        FindResult find_impl(const Key& key, size_t full_hash) const
-        {
-            if (capacity() == 0)
+            BitMask match_full() const
             {
-                return {0, false};
+                return BitMask(_mm512_movepi8_mask(ctrl));
             }
 
-            const int8_t hash2_val = h2(full_hash);
-            size_t probe_start_index = h1(full_hash);
-            std::optional<size_t> first_deleted_slot;
+            void store_deleted(int8_t* p, const int8_t* erased) const
+            {
+                const __mmask64 lanes = _mm512_movepi8_mask(_mm512_loadu_si512(erased));
+                _mm512_storeu_si512(p, _mm512_mask_set1_epi8(ctrl, lanes, kDeleted));
+            }
+        };
+#elif defined(OPTIMAP_GROUP_NEON)
+        // NEON implementation of Group. The byte-wise comparison results (0x00/0xFF per slot)
+        // are narrowed to a 64-bit mask with a shift-right-narrow by 4, giving one nibble per
+        // slot; BitMask::kShift accounts for the spacing.
+        struct Group
+        {
+            int8x16_t ctrl;
 
-            for (size_t offset = 0;; offset += kGroupWidth)
+            explicit Group(const int8_t* p) : ctrl(vld1q_s8(p)) {}
+
+            BitMask match_h2(int8_t hash) const
             {
-                const size_t group_start_index = (probe_start_index + offset) & (capacity() - 1);
-                Group group(&m_ctrl[group_start_index]);
+                return to_mask(vceqq_s8(ctrl, vdupq_n_s8(hash)));
+            }
 
-                // Combine match operations for efficiency
-                auto match_h2_mask = group.match_h2(hash2_val);
-                auto match_empty_mask = group.match_empty();
+            BitMask match_empty() const
+            {
+                return to_mask(vceqq_s8(ctrl, vdupq_n_s8(kEmpty)));
+            }
 
-                for (; match_h2_mask; match_h2_mask.advance())
-                {
-                    const size_t index =
-                            (group_start_index + match_h2_mask.next()) & (capacity() - 1);
-                    if (m_buckets[index].first == key) [[likely]]
-                    {
-                        return {index, true};
-                    }
-                }
+            BitMask match_empty_or_deleted() const
+            {
+                return to_mask(vcgezq_s8(ctrl));
+            }
 
-                if (match_empty_mask)
-                {
-                    const size_t empty_index =
-                            (group_start_index + match_empty_mask.next()) & (capacity() - 1);
-                    return {first_deleted_slot.value_or(empty_index), false};
-                }
+            BitMask match_full() const
+            {
+                return to_mask(vcltzq_s8(ctrl));
+            }
 
-                if (!first_deleted_slot)
-                {
-                    auto match_deleted_mask = group.match_empty_or_deleted();
-                    if (match_deleted_mask)
-                    {
-                        const size_t index =
-                                (group_start_index + match_deleted_mask.next()) & (capacity() - 1);
-                        if (m_ctrl[index] == kDeleted)
-                        {
-                            first_deleted_slot = index;
-                        }
-                    }
-                }
+            void store_deleted(int8_t* p, const int8_t* erased) const
+            {
+                const uint8x16_t lanes = vreinterpretq_u8_s8(vld1q_s8(erased));
+                vst1q_s8(p, vbslq_s8(lanes, vdupq_n_s8(kDeleted), ctrl));
             }
-        }
 
-        static constexpr size_t next_power_of_2(size_t n)
-        {
-            if (n == 0)
+          private:
+            static BitMask to_mask(uint8x16_t lanes)
             {
-                return 1;
+                const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(lanes), 4);
+                return BitMask(
+                        vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) &
+                        UINT64_C(0x8888888888888888)
+                );
             }
+        };
+#else
+        // Fallback implementation of Group for builds without SSE2 or NEON, and for group
+        // widths the SIMD backend does not cover.
+        struct Group
+        {
+            const int8_t* ctrl;
 
-            n--;
-            n |= n >> 1;
-            n |= n >> 2;
-            n |= n >> 4;
-            n |= n >> 8;
-            n |= n >> 16;
-            n |= n >> 32;
-            n++;
+            explicit Group(const int8_t* p) : ctrl(p) {}
 
-            return n;
-        }
+            BitMask match_h2(int8_t hash) const
+            {
+                return match([hash](int8_t c) { return c == hash; });
+            }
 
-        void resize_and_rehash()
-        {
-            size_t new_capacity = (m_capacity == 0) ? kGroupWidth : m_capacity * 2;
+            BitMask match_empty() const
+            {
+                return match([](int8_t c) { return c == kEmpty; });
+            }
 
-            int8_t* old_ctrl = m_ctrl;
-            Entry* old_buckets = m_buckets;
-            size_t old_capacity = m_capacity;
+            BitMask match_empty_or_deleted() const
+            {
+                return match([](int8_t c) { return !is_full(c); });
+            }
 
-            allocate_and_initialize(new_capacity);
+            BitMask match_full() const
+            {
+                return match([](int8_t c) { return is_full(c); });
+            }
 
-            for (size_t i = 0; i < old_capacity; ++i)
+            void store_deleted(int8_t* p, const int8_t* erased) const
             {
-                if (old_ctrl[i] >= 0)
+                for (size_t i = 0; i < kGroupWidth; ++i)
                 {
-                    const auto& key = old_buckets[i].first;
-                    const size_t full_hash = Hash{}(key);
-                    size_t probe_start_index = h1(full_hash);
+                    p[i] = erased[i] ? kDeleted : ctrl[i];
+                }
+            }
 
-                    for (size_t offset = 0;; offset += kGroupWidth)
+          private:
+            template <typename Predicate> BitMask match(Predicate predicate) const
+            {
+                uint64_t mask = 0;
+                for (size_t i = 0; i < kGroupWidth; ++i)
+                {
+                    if (predicate(ctrl[i]))
                     {
-                        const size_t group_start_index =
-                                (probe_start_index + offset) & (m_capacity - 1);
-                        Group group(&m_ctrl[group_start_index]);
-
-                        if (auto empty_mask = group.match_empty())
-                        {
-                            const size_t empty_index =
-                                    (group_start_index + empty_mask.next()) & (m_capacity - 1);
-                            const int8_t hash2_val = h2(full_hash);
+                        mask |= (UINT64_C(1) << i);
+                    }
+                }
+                return BitMask(mask);
+            }
+        };
+#endif
 
-                            new (&m_buckets[empty_index]) Entry(std::move(old_buckets[i]));
-                            old_buckets[i].~Entry();
-                            m_ctrl[empty_index] = hash2_val;
+        enum class CounterEvent
+        {
+            Lookup,
+            Probe,
+            KeyComparison,
+            H2FalsePositive,
+            Rehash,
+        };
 
-                            size_t sentinel_index = empty_index + m_capacity;
-                            if (sentinel_index < m_capacity + kGroupWidth)
-                            {
-                                m_ctrl[sentinel_index] = hash2_val;
-                            }
+        // Storage behind HashMap::counters. Relaxed atomics, since const lookups may run
+        // concurrently (ShardedHashMap readers share a lock). A copied or moved map starts
+        // counting from zero: the counts describe the work done through one object
+        struct CounterStorage
+        {
+#if defined(OPTIMAP_ENABLE_COUNTERS)
+            CounterStorage() = default;
+            CounterStorage(const CounterStorage&) noexcept {}
+            CounterStorage& operator=(const CounterStorage&) noexcept
+            {
+                return *this;
+            }
 
-                            const size_t group_index = empty_index / kGroupWidth;
-                            m_group_mask[group_index / 64] |= (UINT64_C(1) << (group_index % 64));
-                            break;
-                        }
-                    }
+            void add(CounterEvent event) noexcept
+            {
+                std::atomic<uint64_t>* counter = &lookups;
+                switch (event)
+                {
+                case CounterEvent::Lookup:
+                    counter = &lookups;
+                    break;
+                case CounterEvent::Probe:
+                    counter = &probes;
+                    break;
+                case CounterEvent::KeyComparison:
+                    counter = &key_comparisons;
+                    break;
+                case CounterEvent::H2FalsePositive:
+                    counter = &h2_false_positives;
+                    break;
+                case CounterEvent::Rehash:
+                    counter = &rehashes;
+                    break;
                 }
+                counter->fetch_add(1, std::memory_order_relaxed);
             }
 
-            if (old_ctrl)
+            void reset() noexcept
             {
-                AlignedAllocator<char, kCacheLineSize>().deallocate(
-                        reinterpret_cast<char*>(old_ctrl),
-                        0
-                );
+                lookups.store(0, std::memory_order_relaxed);
+                probes.store(0, std::memory_order_relaxed);
+                key_comparisons.store(0, std::memory_order_relaxed);
+                h2_false_positives.store(0, std::memory_order_relaxed);
+                rehashes.store(0, std::memory_order_relaxed);
             }
-        }
 
-        inline size_t h1(size_t hash) const
+            std::atomic<uint64_t> lookups = 0;
+            std::atomic<uint64_t> probes = 0;
+            std::atomic<uint64_t> key_comparisons = 0;
+            std::atomic<uint64_t> h2_false_positives = 0;
+            std::atomic<uint64_t> rehashes = 0;
+#else
+            void add(CounterEvent) noexcept {}
+#endif
+        };
+
+        // Define OPTIMAP_ENABLE_COUNTERS to count probes, key comparisons, h2 false positives
+        // and rehashes in every HashMap (see HashMap::counters). Off by default, where the
+        // counters take no space and no instructions. Must be the same in every translation
+        // unit of a program
+#if defined(OPTIMAP_ENABLE_COUNTERS)
+        inline constexpr bool kCountersEnabled = true;
+#else
+        inline constexpr bool kCountersEnabled = false;
+#endif
+
+        // Hashers that take a seed as a second argument, like the GxHash family. HashMap passes
+        // its seed through them; other hashers get their output remixed with the seed instead
+        template <typename Hash, typename K>
+        concept SeededHasher = requires(const Hash& hash, const K& key, uint64_t seed) {
+            { hash(key, seed) } -> std::convertible_to<size_t>;
+        };
+
+        // Remixes the output of an unseeded hasher. Breaks up clusters of nearby hash values,
+        // not full collisions
+        inline size_t seed_hash(size_t hash, uint64_t seed) noexcept
         {
-            return hash & (capacity() - 1);
+            return static_cast<size_t>(gxhash::gxhash_int(hash, seed));
         }
 
-        static inline int8_t h2(size_t hash)
+        // Nonzero seeds for HashMap::reseed(). std::random_device is read once per process; each
+        // call then steps a Weyl sequence and mixes it, so seeds come without a system call
+        inline uint64_t random_seed() noexcept
         {
-            return static_cast<int8_t>(hash >> (sizeof(size_t) * 8 - 7));
+            static std::atomic<uint64_t> state = [] {
+                uint64_t entropy = static_cast<uint64_t>(
+                        std::chrono::steady_clock::now().time_since_epoch().count()
+                );
+                try
+                {
+                    std::random_device device;
+                    entropy ^= (static_cast<uint64_t>(device()) << 32) | device();
+                }
+                catch (...)
+                {
+                    // No entropy source: the clock alone still varies between processes
+                }
+                return entropy;
+            }();
+            const uint64_t step = state.fetch_add(0x9e3779b97f4a7c15ULL, std::memory_order_relaxed);
+            return gxhash::gxhash_int(step) | 1;
         }
+    } // namespace detail
+
+    // Probe policies, the last template parameter of HashMap. A policy's Sequence yields the
+    // first slot of each control group a probe visits, for a table whose capacity - 1 is mask;
+    // probe_length counts the groups a probe for hash loads up to and including the one that
+    // holds slot index. Every sequence visits each group of the table once before repeating.
+    //
+    // LinearProbing starts at the hash's home slot and steps one group at a time, so group
+    // loads are unaligned and a cluster spills into the groups right after it.
+    struct LinearProbing
+    {
+        static constexpr uint64_t kId = 0;
+        static constexpr bool kAlignedGroups = false;
 
-        // Hash map data is stored in a single contiguous memory block to
-        // improve cache locality and reduce allocation overhead. The block is
-        // partitioned into three sections:
-        //
-        // m_ctrl: array of control bytes
-        // m_buckets: array of key-value pairs (Entry)
-        // m_group_mask: bitmask used to quickly skip over empty groups during iteration
-        int8_t* m_ctrl = nullptr;
-        Entry* m_buckets = nullptr;
-        uint64_t* m_group_mask = nullptr;
-        size_t m_size = 0;
-        size_t m_capacity = 0;
+        class Sequence
+        {
+          public:
+            Sequence(size_t hash, size_t mask) : m_offset(hash & mask), m_mask(mask) {}
 
-        static constexpr size_t align_up(size_t value, size_t alignment)
+            size_t offset() const
+            {
+                return m_offset;
+            }
+
+            // Slot i of the current group, wrapping past the end of the table
+            size_t offset(size_t i) const
+            {
+                return (m_offset + i) & m_mask;
+            }
+
+            void next()
+            {
+                m_offset = (m_offset + detail::kGroupWidth) & m_mask;
+            }
+
+          private:
+            size_t m_offset;
+            size_t m_mask;
+        };
+
+        static size_t probe_length(size_t hash, size_t index, size_t mask)
         {
-            return ((value + alignment - 1) / alignment) * alignment;
+            return ((index - (hash & mask)) & mask) / detail::kGroupWidth + 1;
         }
+    };
 
-        void allocate_and_initialize(size_t new_capacity)
+    // TriangularProbing, as in Abseil's SwissTable but on aligned groups: the probe starts at
+    // the group holding the home slot and jumps 1, 2, 3, ... groups further each step. Group
+    // loads never straddle a cache line or the end of the table, so the sentinel bytes are
+    // never read, and neighbouring home groups follow different paths instead of piling into
+    // one cluster
+    struct TriangularProbing
+    {
+        static constexpr uint64_t kId = 1;
+        static constexpr bool kAlignedGroups = true;
+
+        class Sequence
         {
-            if (new_capacity == 0)
+          public:
+            Sequence(size_t hash, size_t mask)
+                : m_offset(hash & mask & ~(detail::kGroupWidth - 1)), m_mask(mask)
             {
-                return;
             }
 
-            const size_t ctrl_bytes = new_capacity + kGroupWidth;
-            const size_t buckets_offset = align_up(ctrl_bytes, alignof(Entry));
-            const size_t buckets_bytes = new_capacity * sizeof(Entry);
-            const size_t group_mask_offset =
-                    align_up(buckets_offset + buckets_bytes, alignof(uint64_t));
-            const size_t group_words = (new_capacity / kGroupWidth + 63) / 64;
-            const size_t group_mask_bytes = group_words * sizeof(uint64_t);
+            size_t offset() const
+            {
+                return m_offset;
+            }
 
-            const size_t total_bytes = group_mask_offset + group_mask_bytes;
+            size_t offset(size_t i) const
+            {
+                return m_offset + i;
+            }
 
-            void* allocation = AlignedAllocator<char, kCacheLineSize>().allocate(total_bytes);
+            void next()
+            {
+                m_stride += detail::kGroupWidth;
+                m_offset = (m_offset + m_stride) & m_mask;
+            }
 
-            m_ctrl = static_cast<int8_t*>(allocation);
-            m_buckets = reinterpret_cast<Entry*>(static_cast<char*>(allocation) + buckets_offset);
-            m_group_mask =
-                    reinterpret_cast<uint64_t*>(static_cast<char*>(allocation) + group_mask_offset);
+          private:
+            size_t m_offset;
+            size_t m_mask;
+            size_t m_stride = 0;
+        };
 
-            std::fill(m_ctrl, m_ctrl + ctrl_bytes, kEmpty);
-            std::fill(m_group_mask, m_group_mask + group_words, 0);
+        static size_t probe_length(size_t hash, size_t index, size_t mask)
+        {
+            const size_t target = index & ~(detail::kGroupWidth - 1);
+            size_t length = 1;
+            for (Sequence seq(hash, mask); seq.offset() != target; seq.next())
+            {
+                ++length;
+            }
+            return length;
+        }
+    };
 
-            m_capacity = new_capacity;
+    // Snapshot of HashMap::stats(). Probe lengths count control groups loaded by a successful
+    // lookup: 1 when a key sits in the group starting at its home slot, which is the common
+    // case below the max load factor
+    struct TableStats
+    {
+        // Bucket i counts sampled keys found after i + 1 groups; the last bucket also holds
+        // every longer probe
+        static constexpr size_t kProbeHistogramSize = 16;
+
+        size_t size = 0;
+        size_t capacity = 0;
+        size_t tombstones = 0;
+        double load_factor = 0;        // size / capacity
+        double tombstone_factor = 0;   // tombstones / capacity
+        size_t groups = 0;             // Aligned control groups in the table
+        size_t occupied_groups = 0;    // Groups holding at least one entry, from the group mask
+        size_t sampled_keys = 0;
+        double mean_probe_length = 0;
+        size_t max_probe_length = 0;
+        std::array<size_t, kProbeHistogramSize> probe_length_histogram{};
+    };
+
+    // Work counted by HashMap when OPTIMAP_ENABLE_COUNTERS is defined. A lookup is one probe
+    // sequence, for find/contains/at/erase or for the duplicate check of an insertion. A probe
+    // is one control group loaded. An h2 false positive is a slot whose fingerprint matched but
+    // whose key (or, with StoreHash, cached hash) did not
+    struct OperationCounters
+    {
+        uint64_t lookups = 0;
+        uint64_t probes = 0;
+        uint64_t key_comparisons = 0;
+        uint64_t h2_false_positives = 0;
+        uint64_t rehashes = 0;
+    };
+
+    // StoreHash keeps the full hash next to every entry. Growth, tombstone cleanup and copies
+    // then never call Hash again, and lookups compare the cached hash before running == on the
+    // key. Worth it for keys that are expensive to hash or compare (long strings, tuples); off by
+    // default so small integer keys keep their compact layout.
+    //
+    // Allocator supplies the single block that holds control bytes, slots and group mask. It is
+    // rebound to a cache-line-sized type, so the block stays cache line aligned with any
+    // allocator (std::allocator, std::pmr::polymorphic_allocator, arenas). Entries are
+    // constructed in place inside that block and are not themselves allocator-aware
+    template <
+            typename Key,
+            typename Value,
+            typename Hash = GxHash<Key>,
+            bool StoreHash = false,
+            typename Allocator = AlignedAllocator<std::pair<const Key, Value>, 64>,
+            typename ProbePolicy = LinearProbing>
+    class HashMap
+    {
+      public:
+        struct Entry
+        {
+            Key first;
+            // Takes no space for an empty Value, so key-only tables (HashSet) store bare keys
+            OPTIMAP_NO_UNIQUE_ADDRESS Value second;
+
+            bool operator==(const Entry& other) const
+            {
+                return first == other.first && second == other.second;
+            }
+        };
+
+      private:
+        // Entry plus its cached full hash, used as the slot type when StoreHash is set. Derives
+        // from Entry so iterators and nodes keep exposing plain Entry references
+        struct HashedEntry : Entry
+        {
+            template <typename... Args>
+            explicit HashedEntry(size_t full_hash, Args&&... args)
+                : Entry{std::forward<Args>(args)...}, hash(full_hash)
+            {
+            }
+
+            size_t hash;
+        };
+
+        using Slot = std::conditional_t<StoreHash, HashedEntry, Entry>;
+
+        static constexpr size_t kGroupWidth = detail::kGroupWidth;
+        static constexpr int8_t kEmpty = detail::kEmpty;
+        static constexpr int8_t kDeleted = detail::kDeleted;
+
+        // Aligns the hash map's internal storage to cache line boundary. Prevents
+        // single group of control bytes from splitting across two cache lines, significantly
+        // degrading performance
+        static constexpr size_t kCacheLineSize = 64;
+
+        // Allocation unit of the table block
+        struct alignas(kCacheLineSize) CacheLine
+        {
+            char bytes[kCacheLineSize];
+        };
+
+        using allocator_traits =
+                typename std::allocator_traits<Allocator>::template rebind_traits<CacheLine>;
+        using block_allocator = typename allocator_traits::allocator_type;
+        static_assert(
+                std::is_same_v<typename allocator_traits::pointer, CacheLine*>,
+                "Allocators with fancy pointers are not supported"
+        );
+
+        // Number of keys hashed and prefetched ahead of probing in the batched lookups. Large
+        // enough to overlap several cache misses, small enough to keep the hashes in registers
+        // or L1
+        static constexpr size_t kPrefetchBlock = 16;
+
+        struct FindResult
+        {
+            size_t index;
+            bool found;
+        };
+
+        // Hints the CPU to start loading the cache line at p
+        static inline void prefetch(const void* p)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#endif
         }
 
-        void destroy_and_deallocate()
+        using BitMask = detail::BitMask;
+        using Group = detail::Group;
+        using ProbeSequence = typename ProbePolicy::Sequence;
+
+        ProbeSequence probe_sequence(size_t hash) const
         {
-            if (m_ctrl)
+            return ProbeSequence(hash, m_capacity - 1);
+        }
+
+        // Groups a lookup of hash loads to reach slot index
+        size_t probe_length(size_t hash, size_t index) const
+        {
+            return ProbePolicy::probe_length(hash, index, m_capacity - 1);
+        }
+
+        // Core lookup function. SIMD-accelerated probing along the ProbePolicy sequence used to
+        // find correct slot for a key. Takes pre-computed hash to avoid
+        // redundant calculations
+        template <typename K> FindResult find_impl(const K& key, size_t full_hash) const
+        {
+            if (capacity() == 0)
             {
-                for (size_t i = 0; i < m_capacity; ++i)
+                return {0, false};
+            }
+
+            const int8_t hash2_val = h2(full_hash);
+            std::optional<size_t> first_deleted_slot;
+            count_event(detail::CounterEvent::Lookup);
+
+            for (ProbeSequence seq = probe_sequence(full_hash);; seq.next())
+            {
+                Group group(&m_ctrl[seq.offset()]);
+                count_event(detail::CounterEvent::Probe);
+
+                // Combine match operations for efficiency
+                auto match_h2_mask = group.match_h2(hash2_val);
+                auto match_empty_mask = group.match_empty();
+
+                for (; match_h2_mask; match_h2_mask.advance())
+                {
+                    const size_t index = seq.offset(match_h2_mask.next());
+                    if constexpr (StoreHash)
+                    {
+                        if (m_buckets[index].hash != full_hash)
+                        {
+                            count_event(detail::CounterEvent::H2FalsePositive);
+                            continue;
+                        }
+                    }
+                    count_event(detail::CounterEvent::KeyComparison);
+                    if (m_buckets[index].first == key) [[likely]]
+                    {
+                        return {index, true};
+                    }
+                    count_event(detail::CounterEvent::H2FalsePositive);
+                }
+
+                if (match_empty_mask)
+                {
+                    const size_t empty_index = seq.offset(match_empty_mask.next());
+                    return {first_deleted_slot.value_or(empty_index), false};
+                }
+
+                if (!first_deleted_slot)
                 {
-                    if (m_ctrl[i] >= 0)
+                    auto match_deleted_mask = group.match_empty_or_deleted();
+                    if (match_deleted_mask)
                     {
-                        m_buckets[i].~Entry();
+                        const size_t index = seq.offset(match_deleted_mask.next());
+                        if (m_ctrl[index] == kDeleted)
+                        {
+                            first_deleted_slot = index;
+                        }
                     }
                 }
-                AlignedAllocator<char, kCacheLineSize>().deallocate(
-                        reinterpret_cast<char*>(m_ctrl),
-                        0
-                );
-                m_ctrl = nullptr;
-                m_buckets = nullptr;
-                m_group_mask = nullptr;
-                m_capacity = 0;
-                m_size = 0;
             }
         }
 
-      public:
-        explicit HashMap(size_t capacity = 0)
+        // Batched lookup. Hashes a block of keys and prefetches the first control group and the
+        // candidate bucket of each one, then runs the regular probe loop over the block so the
+        // cache misses of neighbouring keys overlap instead of stalling one after another
+        template <typename OnResult>
+        void probe_many(std::span<const Key> keys, OnResult&& on_result) const
         {
-            if (capacity > 0)
+            size_t hashes[kPrefetchBlock];
+
+            for (size_t block_start = 0; block_start < keys.size(); block_start += kPrefetchBlock)
             {
-                size_t initial_capacity =
-                        next_power_of_2(capacity < kGroupWidth ? kGroupWidth : capacity);
-                allocate_and_initialize(initial_capacity);
+                const size_t block_size = std::min(kPrefetchBlock, keys.size() - block_start);
+
+                for (size_t i = 0; i < block_size; ++i)
+                {
+                    hashes[i] = hash_key(keys[block_start + i]);
+                    if (capacity() > 0) [[likely]]
+                    {
+                        const size_t index = probe_sequence(hashes[i]).offset();
+                        prefetch(&m_ctrl[index]);
+                        prefetch(&m_buckets[index]);
+                    }
+                }
+
+                for (size_t i = 0; i < block_size; ++i)
+                {
+                    on_result(find_impl(keys[block_start + i], hashes[i]));
+                }
             }
         }
 
-        ~HashMap()
+        static constexpr size_t next_power_of_2(size_t n)
         {
-            destroy_and_deallocate();
+            if (n == 0)
+            {
+                return 1;
+            }
+
+            n--;
+            n |= n >> 1;
+            n |= n >> 2;
+            n |= n >> 4;
+            n |= n >> 8;
+            n |= n >> 16;
+            n |= n >> 32;
+            n++;
+
+            return n;
         }
 
-        // Copy/move constructors and assignment operators
-        HashMap(const HashMap& other)
+        // Maximum number of elements a table of the given capacity holds before it grows.
+        // Corresponds to a 0.875 max load factor
+        static constexpr size_t max_load_for(size_t capacity)
         {
-            if (other.m_capacity > 0)
+            return capacity - capacity / 8;
+        }
+
+        // Smallest valid capacity that holds n elements without exceeding the max load factor
+        static constexpr size_t capacity_for(size_t n)
+        {
+            if (n == 0)
             {
-                allocate_and_initialize(other.m_capacity);
-                m_size = other.m_size;
-                std::copy(other.m_ctrl, other.m_ctrl + other.m_capacity + kGroupWidth, m_ctrl);
-                std::copy(
-                        other.m_group_mask,
-                        other.m_group_mask + (other.m_capacity / kGroupWidth + 63) / 64,
-                        m_group_mask
-                );
-                for (size_t i = 0; i < other.m_capacity; ++i)
-                {
-                    if (other.m_ctrl[i] >= 0)
-                    {
-                        new (&m_buckets[i]) Entry(other.m_buckets[i]);
-                    }
-                }
+                return 0;
+            }
+
+            size_t capacity = next_power_of_2(n < kGroupWidth ? kGroupWidth : n);
+            while (max_load_for(capacity) < n)
+            {
+                capacity *= 2;
             }
+
+            return capacity;
         }
 
-        HashMap& operator=(const HashMap& other)
+        // Doubles the capacity (or allocates the first group for an empty map)
+        void resize_and_rehash()
         {
-            if (this != &other)
+            resize_and_rehash((m_capacity == 0) ? kGroupWidth : m_capacity * 2);
+        }
+
+        // Migrates every live entry into a freshly allocated table of new_capacity slots.
+        // new_capacity must be a power of 2 large enough to hold size() elements
+        void resize_and_rehash(size_t new_capacity)
+        {
+            count_event(detail::CounterEvent::Rehash);
+            int8_t* old_ctrl = m_ctrl;
+            Slot* old_buckets = m_buckets;
+            size_t old_capacity = m_capacity;
+
+            allocate_and_initialize(new_capacity);
+
+            if (m_rehash_threads > 1 && m_size >= kParallelRehashMinSize)
             {
-                destroy_and_deallocate();
-                if (other.m_capacity > 0)
+                MigrationSource source{old_ctrl, old_buckets, old_capacity, this};
+                m_size = 0; // Recounted as the entries are placed
+                place_parallel(source, m_rehash_threads, false);
+            }
+            else
+            {
+                for (size_t i = 0; i < old_capacity; ++i)
                 {
-                    allocate_and_initialize(other.m_capacity);
-                    m_size = other.m_size;
-                    std::copy(other.m_ctrl, other.m_ctrl + other.m_capacity + kGroupWidth, m_ctrl);
-                    std::copy(
-                            other.m_group_mask,
-                            other.m_group_mask + (other.m_capacity / kGroupWidth + 63) / 64,
-                            m_group_mask
-                    );
-                    for (size_t i = 0; i < other.m_capacity; ++i)
+                    if (detail::is_full(old_ctrl[i]))
                     {
-                        if (other.m_ctrl[i] >= 0)
+                        const size_t full_hash = entry_hash(old_buckets[i]);
+
+                        for (ProbeSequence seq = probe_sequence(full_hash);; seq.next())
                         {
-                            new (&m_buckets[i]) Entry(other.m_buckets[i]);
+                            Group group(&m_ctrl[seq.offset()]);
+
+                            if (auto empty_mask = group.match_empty())
+                            {
+                                const size_t empty_index = seq.offset(empty_mask.next());
+                                const int8_t hash2_val = h2(full_hash);
+
+                                new (&m_buckets[empty_index]) Slot(std::move(old_buckets[i]));
+                                old_buckets[i].~Slot();
+                                set_ctrl(empty_index, hash2_val);
+                                mark_group_occupied(empty_index);
+                                break;
+                            }
                         }
                     }
                 }
             }
-            return *this;
+
+            if (old_ctrl)
+            {
+                deallocate_table(old_ctrl, old_capacity);
+            }
+        }
+
+        // Parallel placement, used by growth (see set_rehash_threads) and from_range. The new
+        // table is split into a power-of-2 number of partitions of whole groups, one per
+        // worker. Worker p places the entries whose probe sequence starts in partition p, and
+        // only touches control bytes and slots inside it, so no atomics are needed. An entry
+        // whose probe window would leave its partition (including wrap-around at the end of the
+        // table) is put on an overflow list, which is inserted serially at the end. Keys are
+        // hashed once, in parallel, before placement. An exception thrown on a worker thread
+        // (e.g. by a copying key constructor) terminates the program
+        static constexpr size_t kParallelRehashMinSize = size_t{1} << 16;
+        static constexpr size_t kMinSlotsPerPartition = size_t{1} << 14;
+
+        struct PendingEntry
+        {
+            size_t source; // Index of the item in the source
+            size_t hash;
+        };
+
+        enum class PlaceResult
+        {
+            Placed,
+            Duplicate,
+            Overflow
+        };
+
+        // Live entries of the table being replaced. Entries are moved out as they are placed
+        struct MigrationSource
+        {
+            int8_t* ctrl;
+            Slot* buckets;
+            size_t capacity;
+            const HashMap* map;
+
+            size_t size() const
+            {
+                return capacity;
+            }
+
+            bool live(size_t i) const
+            {
+                return detail::is_full(ctrl[i]);
+            }
+
+            size_t hash(size_t i) const
+            {
+                return map->entry_hash(buckets[i]);
+            }
+
+            const Key& key(size_t i) const
+            {
+                return buckets[i].first;
+            }
+
+            void construct(HashMap& target, size_t index, const PendingEntry& pending)
+            {
+                new (&target.m_buckets[index]) Slot(std::move(buckets[pending.source]));
+                buckets[pending.source].~Slot();
+            }
+        };
+
+        // Key-value pairs of a random access range, copied into the map
+        template <typename R> struct RangeSource
+        {
+            const R& range;
+            const HashMap* map;
+
+            size_t size() const
+            {
+                return static_cast<size_t>(std::ranges::size(range));
+            }
+
+            bool live(size_t) const
+            {
+                return true;
+            }
+
+            size_t hash(size_t i) const
+            {
+                return map->hash_key(key(i));
+            }
+
+            const Key& key(size_t i) const
+            {
+                const auto& [key, value] = std::ranges::begin(range)[i];
+                return key;
+            }
+
+            void construct(HashMap& target, size_t index, const PendingEntry& pending)
+            {
+                const auto& [key, value] = std::ranges::begin(range)[pending.source];
+                target.construct_entry(index, pending.hash, key, value);
+            }
+        };
+
+        // Words of m_group_mask in the current table: one bit per aligned group
+        size_t group_words() const
+        {
+            return m_size == 0 ? 0 : layout_for(m_capacity).group_words;
+        }
+
+        // Calls fn(GroupEntries) for the groups flagged in words [word_begin, word_end) of
+        // m_group_mask. Shared by the const and mutable scans
+        template <typename GroupEntries, typename Self, typename Fn>
+        static void for_each_group_in_words(Self& self, size_t word_begin, size_t word_end, Fn& fn)
+        {
+            for (size_t word = word_begin; word < word_end; ++word)
+            {
+                for (uint64_t groups = self.m_group_mask[word]; groups; groups &= groups - 1)
+                {
+                    const size_t first_slot = (word * 64 + BitMask::ctzll(groups)) * kGroupWidth;
+                    const BitMask full = Group(&self.m_ctrl[first_slot]).match_full();
+                    if (full)
+                    {
+                        fn(GroupEntries(&self.m_buckets[first_slot], first_slot, full));
+                    }
+                }
+            }
+        }
+
+        template <typename GroupEntries, typename Self, typename Fn>
+        static void for_each_in_chunk_impl(Self& self, size_t chunk, size_t chunks, Fn& fn)
+        {
+            const size_t words = self.group_words();
+            const size_t word_begin = words * chunk / chunks;
+            const size_t word_end = words * (chunk + 1) / chunks;
+            auto visit = [&fn](const GroupEntries& group) {
+                for (auto& entry : group)
+                {
+                    fn(entry);
+                }
+            };
+            for_each_group_in_words<GroupEntries>(self, word_begin, word_end, visit);
+        }
+
+        template <typename Self, typename Fn>
+        static void parallel_for_each_impl(Self& self, Fn& fn, size_t threads)
+        {
+            using GroupEntries = std::conditional_t<
+                    std::is_const_v<Self>,
+                    const_group_entries,
+                    group_entries>;
+
+            const size_t chunks_available = std::max<size_t>(self.group_words(), 1);
+            const size_t workers = std::clamp<size_t>(threads, 1, chunks_available);
+            run_parallel(workers, [&](size_t worker) {
+                using Reference = typename GroupEntries::reference;
+                if constexpr (std::is_invocable_v<Fn&, Reference, size_t>)
+                {
+                    auto visit = [&fn, worker](Reference entry) { fn(entry, worker); };
+                    for_each_in_chunk_impl<GroupEntries>(self, worker, workers, visit);
+                }
+                else
+                {
+                    for_each_in_chunk_impl<GroupEntries>(self, worker, workers, fn);
+                }
+            });
+        }
+
+        // Runs fn(0) .. fn(workers - 1), fn(0) on the calling thread
+        template <typename F> static void run_parallel(size_t workers, F&& fn)
+        {
+            std::vector<std::thread> pool;
+            pool.reserve(workers - 1);
+            for (size_t worker = 1; worker < workers; ++worker)
+            {
+                pool.emplace_back([&fn, worker] { fn(worker); });
+            }
+            fn(0);
+            for (auto& thread : pool)
+            {
+                thread.join();
+            }
+        }
+
+        // Probes for pending inside [partition_begin, partition_end) only: once the probe
+        // sequence leaves the partition, the entry overflows. With check_duplicates, an entry
+        // with an equal key already in place makes this one a duplicate
+        template <typename Source>
+        PlaceResult place_in_partition(
+                Source& source,
+                const PendingEntry& pending,
+                size_t partition_begin,
+                size_t partition_end,
+                bool check_duplicates
+        )
+        {
+            const int8_t hash2_val = h2(pending.hash);
+
+            for (ProbeSequence seq = probe_sequence(pending.hash);; seq.next())
+            {
+                const size_t group_start_index = seq.offset();
+                if (group_start_index < partition_begin ||
+                    group_start_index + kGroupWidth > partition_end)
+                {
+                    return PlaceResult::Overflow;
+                }
+
+                Group group(&m_ctrl[group_start_index]);
+                if (check_duplicates)
+                {
+                    for (auto match = group.match_h2(hash2_val); match; match.advance())
+                    {
+                        if (m_buckets[group_start_index + match.next()].first ==
+                            source.key(pending.source))
+                        {
+                            return PlaceResult::Duplicate;
+                        }
+                    }
+                }
+
+                if (auto empty_mask = group.match_empty())
+                {
+                    const size_t index = group_start_index + empty_mask.next();
+                    source.construct(*this, index, pending);
+                    m_ctrl[index] = hash2_val;
+                    return PlaceResult::Placed;
+                }
+            }
+        }
+
+        // Places every live item of source into this freshly allocated, empty table using up to
+        // threads workers. With check_duplicates, only the first item of each key is kept, as
+        // with repeated emplace calls
+        template <typename Source>
+        void place_parallel(Source& source, size_t threads, bool check_duplicates)
+        {
+            const size_t count = source.size();
+
+            size_t partitions = 1;
+            while (partitions * 2 <= threads &&
+                   m_capacity / (partitions * 2) >= kMinSlotsPerPartition)
+            {
+                partitions *= 2;
+            }
+            const size_t partition_slots = m_capacity / partitions;
+
+            // Phase 1: hash the items chunk by chunk, bucketing them by target partition while
+            // keeping input order within each bucket
+            const size_t chunk = (count + threads - 1) / threads;
+            std::vector<std::vector<std::vector<PendingEntry>>> buckets(
+                    threads,
+                    std::vector<std::vector<PendingEntry>>(partitions)
+            );
+            run_parallel(threads, [&](size_t worker) {
+                const size_t end = std::min(count, (worker + 1) * chunk);
+                for (size_t i = worker * chunk; i < end; ++i)
+                {
+                    if (source.live(i))
+                    {
+                        const size_t full_hash = source.hash(i);
+                        buckets[worker][h1(full_hash) / partition_slots].push_back({i, full_hash});
+                    }
+                }
+            });
+
+            // Phase 2: each partition is filled by one worker, in input order
+            std::vector<std::vector<PendingEntry>> overflow(partitions);
+            std::vector<size_t> placed(partitions, 0);
+            run_parallel(partitions, [&](size_t partition) {
+                const size_t partition_begin = partition * partition_slots;
+                const size_t partition_end = partition_begin + partition_slots;
+                for (const auto& chunk_buckets : buckets)
+                {
+                    for (const auto& pending : chunk_buckets[partition])
+                    {
+                        const PlaceResult result = place_in_partition(
+                                source,
+                                pending,
+                                partition_begin,
+                                partition_end,
+                                check_duplicates
+                        );
+                        switch (result)
+                        {
+                        case PlaceResult::Placed:
+                            placed[partition]++;
+                            break;
+                        case PlaceResult::Overflow:
+                            overflow[partition].push_back(pending);
+                            break;
+                        case PlaceResult::Duplicate:
+                            break;
+                        }
+                    }
+                }
+            });
+
+            // Phase 3: sentinel, group mask and the entries that crossed a partition boundary
+            std::copy(m_ctrl, m_ctrl + kGroupWidth, m_ctrl + m_capacity);
+            rebuild_group_mask();
+            for (const size_t count_in_partition : placed)
+            {
+                m_size += count_in_partition;
+            }
+
+            for (const auto& partition_overflow : overflow)
+            {
+                for (const auto& pending : partition_overflow)
+                {
+                    size_t index;
+                    if (check_duplicates)
+                    {
+                        const auto result = find_impl(source.key(pending.source), pending.hash);
+                        if (result.found)
+                        {
+                            continue;
+                        }
+                        index = result.index;
+                    }
+                    else
+                    {
+                        index = find_first_non_full(pending.hash);
+                    }
+
+                    source.construct(*this, index, pending);
+                    occupy_slot(index, h2(pending.hash));
+                }
+            }
+        }
+
+        inline size_t h1(size_t hash) const
+        {
+            return hash & (capacity() - 1);
+        }
+
+        static inline int8_t h2(size_t hash)
+        {
+            return detail::h2_of(hash);
+        }
+
+        // Writes a control byte. The first group is mirrored into the sentinel bytes past the
+        // end of the table so that unaligned group loads near the end see the wrapped slots.
+        // Aligned probe policies never load past the end and skip the mirror
+        void set_ctrl(size_t index, int8_t value)
+        {
+            m_ctrl[index] = value;
+            if (!ProbePolicy::kAlignedGroups && index < kGroupWidth)
+            {
+                m_ctrl[index + m_capacity] = value;
+            }
+        }
+
+        void mark_group_occupied(size_t index)
+        {
+            const size_t group_index = index / kGroupWidth;
+            m_group_mask[group_index / 64] |= (UINT64_C(1) << (group_index % 64));
+        }
+
+        // Publishes a freshly constructed entry at index. Reusing a tombstone gives it back
+        void occupy_slot(size_t index, int8_t hash2_val)
+        {
+            if (m_ctrl[index] == kDeleted)
+            {
+                m_tombstones--;
+            }
+
+            set_ctrl(index, hash2_val);
+            mark_group_occupied(index);
+            m_size++;
+        }
+
+        // Returns the first empty or deleted slot along the probe sequence of full_hash
+        size_t find_first_non_full(size_t full_hash) const
+        {
+            for (ProbeSequence seq = probe_sequence(full_hash);; seq.next())
+            {
+                Group group(&m_ctrl[seq.offset()]);
+
+                if (auto free_mask = group.match_empty_or_deleted())
+                {
+                    return seq.offset(free_mask.next());
+                }
+            }
+        }
+
+        // Recomputes m_group_mask from the control bytes
+        void rebuild_group_mask()
+        {
+            const size_t group_words = (m_capacity / kGroupWidth + 63) / 64;
+            std::fill(m_group_mask, m_group_mask + group_words, 0);
+
+            for (size_t group_start_index = 0; group_start_index < m_capacity;
+                 group_start_index += kGroupWidth)
+            {
+                Group group(&m_ctrl[group_start_index]);
+                if (group.match_full())
+                {
+                    mark_group_occupied(group_start_index);
+                }
+            }
+        }
+
+        // Reclaims every tombstone without changing the capacity. Entries are rehashed in place
+        // into the first free slot of their probe sequence, so no second table is allocated
+        void drop_tombstones()
+        {
+            // Full slots become kDeleted ("pending placement") and tombstones become kEmpty
+            for (size_t i = 0; i < m_capacity; ++i)
+            {
+                m_ctrl[i] = detail::is_full(m_ctrl[i]) ? kDeleted : kEmpty;
+            }
+            std::copy(m_ctrl, m_ctrl + kGroupWidth, m_ctrl + m_capacity);
+
+            for (size_t i = 0; i < m_capacity; ++i)
+            {
+                if (m_ctrl[i] != kDeleted)
+                {
+                    continue;
+                }
+
+                const size_t full_hash = entry_hash(m_buckets[i]);
+                const int8_t hash2_val = h2(full_hash);
+                const size_t target = find_first_non_full(full_hash);
+
+                // The entry already sits in the first group of its probe sequence that has
+                // room, so lookups reach it before any empty slot. Keep it where it is
+                if (probe_length(full_hash, i) == probe_length(full_hash, target))
+                {
+                    set_ctrl(i, hash2_val);
+                    continue;
+                }
+
+                if (m_ctrl[target] == kEmpty)
+                {
+                    new (&m_buckets[target]) Slot(std::move(m_buckets[i]));
+                    m_buckets[i].~Slot();
+                    set_ctrl(target, hash2_val);
+                    set_ctrl(i, kEmpty);
+                }
+                else
+                {
+                    // The target holds another pending entry. Swap the two, then process the
+                    // entry that landed in slot i again
+                    Slot pending(std::move(m_buckets[target]));
+                    m_buckets[target].~Slot();
+                    new (&m_buckets[target]) Slot(std::move(m_buckets[i]));
+                    m_buckets[i].~Slot();
+                    new (&m_buckets[i]) Slot(std::move(pending));
+                    set_ctrl(target, hash2_val);
+                    --i;
+                }
+            }
+
+            rebuild_group_mask();
+            m_tombstones = 0;
+        }
+
+        // Called when live entries plus tombstones reach the max load. If tombstones make up a
+        // large share of the used slots, reclaim them at the same capacity; otherwise double
+        void make_room_for_insert()
+        {
+            if (m_capacity > 0 && m_size * 32 <= m_capacity * 25)
+            {
+                drop_tombstones();
+            }
+            else
+            {
+                resize_and_rehash();
+            }
+        }
+
+        // Hash map data is stored in a single contiguous memory block to
+        // improve cache locality and reduce allocation overhead. The block is
+        // partitioned into three sections:
+        //
+        // m_ctrl: array of control bytes
+        // m_buckets: array of key-value pairs (Entry, or HashedEntry when StoreHash is set)
+        // m_group_mask: bitmask used to quickly skip over empty groups during iteration
+        int8_t* m_ctrl = nullptr;
+        Slot* m_buckets = nullptr;
+        uint64_t* m_group_mask = nullptr;
+        size_t m_size = 0;
+        size_t m_capacity = 0;
+        size_t m_tombstones = 0;
+        size_t m_rehash_threads = 1;
+        uint64_t m_seed = 0; // Hash seed of the table, see reseed()
+        size_t m_probe_limit = kDefaultProbeLimit; // In groups, see set_probe_limit()
+        size_t m_watchdog_capacity = 0; // Capacity at the last reseed by the watchdog
+        char* m_mapping = nullptr; // File mapping holding the table, see open_mapped
+        OPTIMAP_NO_UNIQUE_ADDRESS block_allocator m_allocator;
+        OPTIMAP_NO_UNIQUE_ADDRESS mutable detail::CounterStorage m_counters;
+
+        // Bumps one of m_counters; compiles to nothing unless OPTIMAP_ENABLE_COUNTERS is defined
+        void count_event([[maybe_unused]] detail::CounterEvent event) const noexcept
+        {
+            if constexpr (detail::kCountersEnabled)
+            {
+                m_counters.add(event);
+            }
+        }
+
+        static constexpr size_t align_up(size_t value, size_t alignment)
+        {
+            return ((value + alignment - 1) / alignment) * alignment;
+        }
+
+        // Offsets of the three arrays within the single table block
+        struct TableLayout
+        {
+            size_t ctrl_bytes;
+            size_t buckets_offset;
+            size_t group_mask_offset;
+            size_t group_words;
+            size_t cache_lines; // Size of the whole block
+        };
+
+        static constexpr TableLayout layout_for(size_t capacity)
+        {
+            const size_t ctrl_bytes = capacity + kGroupWidth;
+            const size_t buckets_offset = align_up(ctrl_bytes, alignof(Slot));
+            const size_t buckets_bytes = capacity * sizeof(Slot);
+            const size_t group_mask_offset =
+                    align_up(buckets_offset + buckets_bytes, alignof(uint64_t));
+            const size_t group_words = (capacity / kGroupWidth + 63) / 64;
+            const size_t group_mask_bytes = group_words * sizeof(uint64_t);
+
+            const size_t total_bytes = group_mask_offset + group_mask_bytes;
+            return {ctrl_bytes,
+                    buckets_offset,
+                    group_mask_offset,
+                    group_words,
+                    (total_bytes + kCacheLineSize - 1) / kCacheLineSize};
+        }
+
+        // Entries that can be copied as raw bytes and need no destructor call. Copies, clear()
+        // and destruction of such maps work on whole arrays instead of slot by slot
+        static constexpr bool kTriviallyCopyableSlot = std::is_trivially_copyable_v<Slot>;
+        static constexpr bool kTriviallyDestructibleSlot = std::is_trivially_destructible_v<Slot>;
+
+        // Allocates a table of new_capacity slots without initializing it
+        void allocate_table(size_t new_capacity)
+        {
+            const TableLayout layout = layout_for(new_capacity);
+            char* allocation = reinterpret_cast<char*>(
+                    allocator_traits::allocate(m_allocator, layout.cache_lines)
+            );
+
+            m_ctrl = reinterpret_cast<int8_t*>(allocation);
+            m_buckets = reinterpret_cast<Slot*>(allocation + layout.buckets_offset);
+            m_group_mask = reinterpret_cast<uint64_t*>(allocation + layout.group_mask_offset);
+            m_capacity = new_capacity;
+            m_tombstones = 0;
+        }
+
+        // Marks every slot of the current table empty
+        void reset_ctrl()
+        {
+            const TableLayout layout = layout_for(m_capacity);
+            std::fill(m_ctrl, m_ctrl + layout.ctrl_bytes, kEmpty);
+            std::fill(m_group_mask, m_group_mask + layout.group_words, 0);
+            m_tombstones = 0;
+        }
+
+        void allocate_and_initialize(size_t new_capacity)
+        {
+            if (new_capacity == 0)
+            {
+                return;
+            }
+
+            allocate_table(new_capacity);
+
+            // Both arrays start out all zeros, which zero-filled allocations already are. The
+            // pages are then only touched when probes reach them
+            if constexpr (!detail::allocates_zeroed_memory<block_allocator>)
+            {
+                reset_ctrl();
+            }
+        }
+
+        // Runs the destructor of every live entry. Only groups flagged in m_group_mask are
+        // scanned, so sparse tables skip most of their control bytes
+        void destroy_entries()
+        {
+            if constexpr (!kTriviallyDestructibleSlot)
+            {
+                const size_t group_words = layout_for(m_capacity).group_words;
+                for (size_t word = 0; word < group_words; ++word)
+                {
+                    for (uint64_t groups = m_group_mask[word]; groups; groups &= groups - 1)
+                    {
+                        const size_t group_start_index =
+                                (word * 64 + BitMask::ctzll(groups)) * kGroupWidth;
+                        Group group(&m_ctrl[group_start_index]);
+                        for (auto full = group.match_full(); full; full.advance())
+                        {
+                            m_buckets[group_start_index + full.next()].~Slot();
+                        }
+                    }
+                }
+            }
+        }
+
+        // Returns the block of a table of capacity slots, whose entries are already destroyed
+        void deallocate_table(int8_t* ctrl, size_t capacity)
+        {
+#if defined(OPTIMAP_HAVE_MMAP)
+            if (m_mapping &&
+                reinterpret_cast<char*>(ctrl) == m_mapping + detail::kTableFileHeaderBytes)
+            {
+                const size_t block_bytes = layout_for(capacity).cache_lines * kCacheLineSize;
+                munmap(m_mapping, detail::kTableFileHeaderBytes + block_bytes);
+                m_mapping = nullptr;
+                return;
+            }
+#endif
+            allocator_traits::deallocate(
+                    m_allocator,
+                    reinterpret_cast<CacheLine*>(ctrl),
+                    layout_for(capacity).cache_lines
+            );
+        }
+
+        // Fills this empty map with a copy (or, from an rvalue, a move) of other's entries,
+        // keeping the same capacity and slot positions
+        template <typename Other> void assign_entries_from(Other&& other)
+        {
+            // The layout is copied as is, so the copy has to hash keys the same way
+            m_seed = other.m_seed;
+            if (other.m_capacity == 0)
+            {
+                return;
+            }
+
+            const TableLayout layout = layout_for(other.m_capacity);
+            if constexpr (kTriviallyCopyableSlot)
+            {
+                // Control bytes, slots and group mask in one copy of the whole block
+                allocate_table(other.m_capacity);
+                std::memcpy(
+                        static_cast<void*>(m_ctrl),
+                        other.m_ctrl,
+                        layout.cache_lines * kCacheLineSize
+                );
+            }
+            else
+            {
+                allocate_and_initialize(other.m_capacity);
+                for (size_t i = 0; i < other.m_capacity; ++i)
+                {
+                    if (detail::is_full(other.m_ctrl[i]))
+                    {
+                        if constexpr (std::is_lvalue_reference_v<Other>)
+                        {
+                            new (&m_buckets[i]) Slot(other.m_buckets[i]);
+                        }
+                        else
+                        {
+                            new (&m_buckets[i]) Slot(std::move(other.m_buckets[i]));
+                        }
+                    }
+                }
+
+                std::copy(other.m_ctrl, other.m_ctrl + layout.ctrl_bytes, m_ctrl);
+                std::copy(
+                        other.m_group_mask,
+                        other.m_group_mask + layout.group_words,
+                        m_group_mask
+                );
+            }
+            m_size = other.m_size;
+            m_tombstones = other.m_tombstones;
+        }
+
+        // Takes over other's table. The allocators must compare equal
+        void steal_table_from(HashMap& other) noexcept
+        {
+            m_ctrl = std::exchange(other.m_ctrl, nullptr);
+            m_buckets = std::exchange(other.m_buckets, nullptr);
+            m_group_mask = std::exchange(other.m_group_mask, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            m_tombstones = std::exchange(other.m_tombstones, 0);
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+            m_seed = std::exchange(other.m_seed, 0);
+            m_watchdog_capacity = std::exchange(other.m_watchdog_capacity, 0);
+        }
+
+        void destroy_and_deallocate()
+        {
+            if (m_ctrl)
+            {
+                destroy_entries();
+                deallocate_table(m_ctrl, m_capacity);
+                m_ctrl = nullptr;
+                m_buckets = nullptr;
+                m_group_mask = nullptr;
+                m_capacity = 0;
+                m_size = 0;
+                m_tombstones = 0;
+            }
+            m_watchdog_capacity = 0;
+        }
+
+        // hash_key(key) from hash = unseeded_hash(key): the same value under seed 0, remixed
+        // under any other seed for plain hashers, and recomputed for hashers that take the seed
+        size_t hash_key_from_unseeded(const Key& key, size_t hash) const
+        {
+            if (m_seed == 0) [[likely]]
+            {
+                return hash;
+            }
+            if constexpr (detail::SeededHasher<Hash, Key>)
+            {
+                return Hash{}(key, m_seed);
+            }
+            else
+            {
+                return detail::seed_hash(hash, m_seed);
+            }
+        }
+
+        // Every hash the table uses goes through here, so that it includes m_seed. Seed 0 leaves
+        // the hasher's output unchanged
+        template <typename K> size_t hash_key(const K& key) const
+        {
+            if constexpr (detail::SeededHasher<Hash, K>)
+            {
+                return Hash{}(key, m_seed);
+            }
+            else
+            {
+                const size_t hash = Hash{}(key);
+                return m_seed == 0 ? hash : detail::seed_hash(hash, m_seed);
+            }
+        }
+
+        // Probe-length watchdog, run by insertions before they construct the entry at
+        // result.index. A free slot whose probe loads probe_limit() groups or more means the
+        // hashes cluster, by accident (reinserting another table's keys in its slot order)
+        // or by design (flooding). The table is then rehashed under a random seed and the slot
+        // looked up again. A hash that collides outright clusters under every seed, so the
+        // watchdog fires at most once per capacity
+        template <typename K>
+        void watch_probe_length(const K& key, size_t& full_hash, FindResult& result)
+        {
+            if (probe_length(full_hash, result.index) < m_probe_limit) [[likely]]
+            {
+                return;
+            }
+            if (m_capacity == m_watchdog_capacity)
+            {
+                return;
+            }
+
+            m_watchdog_capacity = m_capacity;
+            reseed(detail::random_seed());
+            full_hash = hash_key(key);
+            result = find_impl(key, full_hash);
+        }
+
+        // Full hash of a live slot: the cached value with StoreHash, otherwise the key is hashed
+        size_t entry_hash(const Slot& slot) const
+        {
+            if constexpr (StoreHash)
+            {
+                return slot.hash;
+            }
+            else
+            {
+                return hash_key(slot.first);
+            }
+        }
+
+        // Constructs the slot at index in place from args (forwarded to Entry's members) and
+        // records full_hash when StoreHash is set
+        template <typename... Args>
+        void construct_entry(size_t index, size_t full_hash, Args&&... args)
+        {
+            if constexpr (StoreHash)
+            {
+                new (&m_buckets[index]) Slot(full_hash, std::forward<Args>(args)...);
+            }
+            else
+            {
+                new (&m_buckets[index]) Entry{std::forward<Args>(args)...};
+            }
+        }
+
+        template <typename K> FindResult lookup(const K& key) const
+        {
+            return find_impl(key, hash_key(key));
+        }
+
+        template <typename K> size_t index_of_or_throw(const K& key) const
+        {
+            const auto result = lookup(key);
+            if (!result.found)
+            {
+                throw std::out_of_range("Key not found in HashMap");
+            }
+            return result.index;
+        }
+
+        // Destroys the entry at index and leaves a tombstone in its slot
+        void erase_at(size_t index)
+        {
+            m_buckets[index].~Slot();
+            set_ctrl(index, kDeleted);
+
+            m_size--;
+            m_tombstones++;
+
+            // Check if the group is now empty and clear the bit if so
+            const size_t group_index = index / kGroupWidth;
+            const size_t group_start_index = group_index * kGroupWidth;
+
+            Group group(&m_ctrl[group_start_index]);
+
+            if (!group.match_full())
+            {
+                m_group_mask[group_index / 64] &= ~(UINT64_C(1) << (group_index % 64));
+            }
+        }
+
+        template <typename K> bool erase_key(const K& key)
+        {
+            const auto result = lookup(key);
+
+            if (result.found) [[likely]]
+            {
+                erase_at(result.index);
+                return true;
+            }
+
+            return false;
+        }
+
+        // Erases the entries of the group at group_start_index that pred selects. Every entry
+        // is tested before any is destroyed, so a throwing pred leaves the group untouched. The
+        // group's control bytes are rewritten with one store and its mask bit updated once
+        template <typename Pred> void erase_in_group_if(size_t group_start_index, Pred& pred)
+        {
+            const Group group(&m_ctrl[group_start_index]);
+            int8_t erased[kGroupWidth] = {};
+            size_t live = 0;
+            size_t erased_count = 0;
+
+            for (auto full = group.match_full(); full; full.advance())
+            {
+                const size_t slot = full.next();
+                ++live;
+                if (pred(static_cast<const Entry&>(m_buckets[group_start_index + slot])))
+                {
+                    erased[slot] = -1;
+                    ++erased_count;
+                }
+            }
+
+            if (erased_count == 0)
+            {
+                return;
+            }
+
+            if constexpr (!kTriviallyDestructibleSlot)
+            {
+                for (size_t slot = 0; slot < kGroupWidth; ++slot)
+                {
+                    if (erased[slot])
+                    {
+                        m_buckets[group_start_index + slot].~Slot();
+                    }
+                }
+            }
+
+            group.store_deleted(&m_ctrl[group_start_index], erased);
+            if (group_start_index == 0)
+            {
+                std::copy(m_ctrl, m_ctrl + kGroupWidth, m_ctrl + m_capacity);
+            }
+
+            m_size -= erased_count;
+            m_tombstones += erased_count;
+
+            if (erased_count == live)
+            {
+                const size_t group_index = group_start_index / kGroupWidth;
+                m_group_mask[group_index / 64] &= ~(UINT64_C(1) << (group_index % 64));
+            }
+        }
+
+        // The probe every insertion starts with. Looks key up first and only makes room when it
+        // is absent and taking a free slot would pass the max load, so an existing key never
+        // triggers growth. Reusing a tombstone leaves size plus tombstones unchanged and needs no
+        // room either. On a miss, result.index is the free slot to construct the entry in
+        template <typename K> FindResult find_or_prepare_insert(const K& key, size_t& full_hash)
+        {
+            full_hash = hash_key(key);
+            return find_or_prepare_insert_hashed(key, full_hash);
+        }
+
+        // find_or_prepare_insert for a full_hash the caller already computed. full_hash is
+        // updated if the probe-length watchdog reseeds the table
+        template <typename K>
+        FindResult find_or_prepare_insert_hashed(const K& key, size_t& full_hash)
+        {
+            FindResult result = find_impl(key, full_hash);
+            if (result.found)
+            {
+                return result;
+            }
+
+            if (m_capacity == 0 ||
+                (m_ctrl[result.index] == kEmpty &&
+                 m_size + m_tombstones >= max_load_for(m_capacity))) [[unlikely]]
+            {
+                // The key is known to be absent, so the new table only needs a free slot
+                make_room_for_insert();
+                result.index = find_first_non_full(full_hash);
+            }
+            watch_probe_length(key, full_hash, result);
+            return result;
+        }
+
+        // Shared by try_emplace, emplace and operator[]. The Key is only built from key, and
+        // the Value from args, when an insertion actually happens. Returns the slot index and
+        // whether the entry was inserted
+        template <typename K, typename... Args>
+        std::pair<size_t, bool> try_emplace_impl(K&& key, Args&&... args)
+        {
+            return try_emplace_hashed_impl(
+                    hash_key(key), std::forward<K>(key), std::forward<Args>(args)...
+            );
+        }
+
+        // try_emplace_impl for a full_hash the caller already computed with hash_key
+        template <typename K, typename... Args>
+        std::pair<size_t, bool> try_emplace_hashed_impl(size_t full_hash, K&& key, Args&&... args)
+        {
+            const FindResult result = find_or_prepare_insert_hashed(key, full_hash);
+            if (result.found)
+            {
+                return {result.index, false};
+            }
+
+            construct_entry(
+                    result.index,
+                    full_hash,
+                    Key(std::forward<K>(key)),
+                    Value(std::forward<Args>(args)...)
+            );
+            occupy_slot(result.index, h2(full_hash));
+
+            return {result.index, true};
+        }
+
+        template <typename K, typename V>
+        std::pair<size_t, bool> insert_or_assign_impl(K&& key, V&& value)
+        {
+            // Forwarding value twice is safe: try_emplace_impl only consumes it on insertion
+            const auto [index, inserted] =
+                    try_emplace_impl(std::forward<K>(key), std::forward<V>(value));
+            if (!inserted)
+            {
+                m_buckets[index].second = std::forward<V>(value);
+            }
+            return {index, inserted};
+        }
+
+        // Zero-copy serialization needs entries that are plain bytes
+        static constexpr bool kSerializable =
+                std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Value>;
+
+        static size_t hash_check()
+        {
+            if constexpr (std::is_default_constructible_v<Key>)
+            {
+                return Hash{}(Key{});
+            }
+            else
+            {
+                return 0;
+            }
+        }
+
+        // Header of a table with capacity slots, without its size and tombstone count
+        static detail::TableFileHeader file_header_for(size_t capacity)
+        {
+            detail::TableFileHeader header{};
+            std::memcpy(header.magic, header.kMagic, sizeof(header.magic));
+            header.version = header.kVersion;
+            header.byte_order = header.kByteOrderMark;
+            header.group_width = kGroupWidth;
+            header.store_hash = StoreHash;
+            header.slot_size = sizeof(Slot);
+            header.slot_align = alignof(Slot);
+            header.capacity = capacity;
+            header.hash_check = hash_check();
+            header.probe_policy = ProbePolicy::kId;
+            if (capacity > 0)
+            {
+                const TableLayout layout = layout_for(capacity);
+                header.buckets_offset = layout.buckets_offset;
+                header.group_mask_offset = layout.group_mask_offset;
+                header.block_bytes = layout.cache_lines * kCacheLineSize;
+            }
+            return header;
+        }
+
+        // Throws std::runtime_error unless header describes a table this map type can use as is
+        static void validate_file_header(const detail::TableFileHeader& header)
+        {
+            const detail::TableFileHeader reference = file_header_for(header.capacity);
+
+            if (std::memcmp(header.magic, reference.magic, sizeof(header.magic)) != 0)
+            {
+                throw std::runtime_error("Not an OptiMap table file");
+            }
+            if (header.version != reference.version || header.byte_order != reference.byte_order)
+            {
+                throw std::runtime_error("Unsupported OptiMap table file version or byte order");
+            }
+            if (header.group_width != reference.group_width ||
+                header.store_hash != reference.store_hash ||
+                header.slot_size != reference.slot_size ||
+                header.slot_align != reference.slot_align ||
+                header.hash_check != reference.hash_check ||
+                header.probe_policy != reference.probe_policy)
+            {
+                throw std::runtime_error("OptiMap table file was written by a different map type");
+            }
+            if ((header.capacity & (header.capacity - 1)) != 0 ||
+                (header.capacity != 0 && header.capacity < kGroupWidth) ||
+                header.buckets_offset != reference.buckets_offset ||
+                header.group_mask_offset != reference.group_mask_offset ||
+                header.block_bytes != reference.block_bytes ||
+                // Every table keeps an empty slot for probes to stop at. The separate bounds
+                // keep the sum from wrapping
+                header.size > header.capacity || header.tombstones > header.capacity ||
+                header.size + header.tombstones > max_load_for(header.capacity))
+            {
+                throw std::runtime_error("Corrupt OptiMap table file header");
+            }
+        }
+
+#if defined(OPTIMAP_HAVE_MMAP)
+        static HashMap map_file(const std::string& path, bool writable)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw std::runtime_error("Cannot open " + path);
+            }
+
+            struct stat file_stat;
+            detail::TableFileHeader header;
+            const bool has_header =
+                    fstat(fd, &file_stat) == 0 &&
+                    static_cast<size_t>(file_stat.st_size) >= detail::kTableFileHeaderBytes &&
+                    ::pread(fd, &header, sizeof(header), 0) == sizeof(header);
+            if (!has_header)
+            {
+                ::close(fd);
+                throw std::runtime_error("Truncated OptiMap table file " + path);
+            }
+            try
+            {
+                validate_file_header(header);
+            }
+            catch (...)
+            {
+                ::close(fd);
+                throw;
+            }
+
+            HashMap map;
+            if (header.capacity == 0)
+            {
+                ::close(fd);
+                return map;
+            }
+
+            const size_t mapped_bytes = detail::kTableFileHeaderBytes + header.block_bytes;
+            if (static_cast<size_t>(file_stat.st_size) < mapped_bytes)
+            {
+                ::close(fd);
+                throw std::runtime_error("Truncated OptiMap table file " + path);
+            }
+
+            void* mapping = mmap(
+                    nullptr,
+                    mapped_bytes,
+                    writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                    writable ? MAP_PRIVATE : MAP_SHARED,
+                    fd,
+                    0
+            );
+            ::close(fd);
+            if (mapping == MAP_FAILED)
+            {
+                throw std::runtime_error("Cannot map " + path);
+            }
+
+            map.m_mapping = static_cast<char*>(mapping);
+            map.m_ctrl = reinterpret_cast<int8_t*>(map.m_mapping + detail::kTableFileHeaderBytes);
+            map.m_buckets = reinterpret_cast<Slot*>(
+                    map.m_mapping + detail::kTableFileHeaderBytes + header.buckets_offset
+            );
+            map.m_group_mask = reinterpret_cast<uint64_t*>(
+                    map.m_mapping + detail::kTableFileHeaderBytes + header.group_mask_offset
+            );
+            map.m_capacity = header.capacity;
+            map.m_size = header.size;
+            map.m_tombstones = header.tombstones;
+            map.m_seed = header.hash_seed;
+            return map;
+        }
+#endif
+
+      public:
+        using allocator_type = Allocator;
+
+        explicit HashMap(size_t capacity = 0, const Allocator& alloc = Allocator())
+            : m_allocator(alloc)
+        {
+            if (capacity > 0)
+            {
+                size_t initial_capacity =
+                        next_power_of_2(capacity < kGroupWidth ? kGroupWidth : capacity);
+                allocate_and_initialize(initial_capacity);
+            }
+        }
+
+        explicit HashMap(const Allocator& alloc) : HashMap(0, alloc) {}
+
+        ~HashMap()
+        {
+            destroy_and_deallocate();
+        }
+
+        // Copy/move constructors and assignment operators. The allocator follows the usual
+        // container rules (select_on_container_copy_construction, propagate_on_container_*)
+        HashMap(const HashMap& other)
+            : m_rehash_threads(other.m_rehash_threads), m_probe_limit(other.m_probe_limit),
+              m_allocator(
+                      allocator_traits::select_on_container_copy_construction(other.m_allocator)
+              )
+        {
+            assign_entries_from(other);
+        }
+
+        HashMap(const HashMap& other, const Allocator& alloc)
+            : m_rehash_threads(other.m_rehash_threads), m_probe_limit(other.m_probe_limit),
+              m_allocator(alloc)
+        {
+            assign_entries_from(other);
+        }
+
+        HashMap& operator=(const HashMap& other)
+        {
+            if (this != &other)
+            {
+                destroy_and_deallocate();
+                if constexpr (allocator_traits::propagate_on_container_copy_assignment::value)
+                {
+                    m_allocator = other.m_allocator;
+                }
+                m_rehash_threads = other.m_rehash_threads;
+                m_probe_limit = other.m_probe_limit;
+                assign_entries_from(other);
+            }
+            return *this;
+        }
+
+        HashMap(HashMap&& other) noexcept
+            : m_rehash_threads(other.m_rehash_threads), m_probe_limit(other.m_probe_limit),
+              m_allocator(std::move(other.m_allocator))
+        {
+            steal_table_from(other);
+        }
+
+        // Moves the entries one by one when alloc cannot free other's table
+        HashMap(HashMap&& other, const Allocator& alloc)
+            : m_rehash_threads(other.m_rehash_threads), m_probe_limit(other.m_probe_limit),
+              m_allocator(alloc)
+        {
+            if (m_allocator == other.m_allocator)
+            {
+                steal_table_from(other);
+            }
+            else
+            {
+                assign_entries_from(std::move(other));
+                other.destroy_and_deallocate();
+            }
+        }
+
+        HashMap& operator=(HashMap&& other) noexcept(
+                allocator_traits::propagate_on_container_move_assignment::value ||
+                allocator_traits::is_always_equal::value
+        )
+        {
+            if (this != &other)
+            {
+                destroy_and_deallocate();
+                m_rehash_threads = other.m_rehash_threads;
+                m_probe_limit = other.m_probe_limit;
+                if constexpr (allocator_traits::propagate_on_container_move_assignment::value)
+                {
+                    m_allocator = std::move(other.m_allocator);
+                    steal_table_from(other);
+                }
+                else if (m_allocator == other.m_allocator)
+                {
+                    steal_table_from(other);
+                }
+                else
+                {
+                    assign_entries_from(std::move(other));
+                    other.destroy_and_deallocate();
+                }
+            }
+            return *this;
+        }
+
+        allocator_type get_allocator() const noexcept
+        {
+            return allocator_type(m_allocator);
+        }
+
+        // Returns true if the entry was inserted, false if the key was already present
+        bool insert(const Key& key, const Value& value)
+        {
+            return emplace(key, value).second;
+        }
+
+        // Overload for r-values to enable move semantics
+        bool insert(Key&& key, Value&& value)
+        {
+            return emplace(std::move(key), std::move(value)).second;
+        }
+
+        // Forward declaration
+        template <bool IsConst> class iterator_impl;
+
+        // Aliases
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+
+        class node_type
+        {
+          public:
+            using key_type = Key;
+            using mapped_type = Value;
+
+            node_type() = default;
+
+            explicit node_type(Entry&& entry) : m_entry(std::move(entry)) {}
+
+            bool empty() const noexcept
+            {
+                return !m_entry.has_value();
+            }
+            explicit operator bool() const noexcept
+            {
+                return m_entry.has_value();
+            }
+
+            key_type& key()
+            {
+                return m_entry->first;
+            }
+
+            mapped_type& mapped()
+            {
+                return m_entry->second;
+            }
+
+          private:
+            friend class HashMap;
+            std::optional<Entry> m_entry;
+        };
+
+        iterator find(const Key& key)
+        {
+            const auto result = lookup(key);
+            return result.found ? iterator(this, result.index) : end();
+        }
+
+        const_iterator find(const Key& key) const
+        {
+            const auto result = lookup(key);
+            return result.found ? const_iterator(this, result.index) : end();
+        }
+
+        // Heterogeneous overloads of find/contains/at/erase/try_emplace. They are available when
+        // Hash is transparent, e.g. std::string_view or const char* queries against std::string
+        // keys with the GxHash string hashers. The query is hashed and compared as-is
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        iterator find(const K& key)
+        {
+            const auto result = lookup(key);
+            return result.found ? iterator(this, result.index) : end();
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        const_iterator find(const K& key) const
+        {
+            const auto result = lookup(key);
+            return result.found ? const_iterator(this, result.index) : end();
+        }
+
+        // Erases the entry it points to without hashing its key again, and returns an iterator
+        // to the next entry. Erasing leaves a tombstone, so iterators to other entries stay valid
+        iterator erase(iterator it)
+        {
+            return erase(const_iterator(it));
+        }
+
+        iterator erase(const_iterator it)
+        {
+            if (it == end())
+            {
+                return end();
+            }
+            iterator next(this, it.m_index);
+            erase_at(it.m_index);
+            return ++next;
+        }
+
+        bool erase(const Key& key)
+        {
+            return erase_key(key);
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K> &&
+                     (!std::is_convertible_v<const K&, iterator>) &&
+                     (!std::is_convertible_v<const K&, const_iterator>)
+        bool erase(const K& key)
+        {
+            return erase_key(key);
+        }
+
+        // Prehashed entry points, for containers that hash a key once for their own use and
+        // hand the hash on: ShardedHashMap picks the shard from it. hash must be
+        // unseeded_hash(key), the key's hash under seed 0, which no reseed() changes. While
+        // seed() is 0 it is used as is, so the key is hashed only once
+        static size_t unseeded_hash(const Key& key)
+        {
+            if constexpr (detail::SeededHasher<Hash, Key>)
+            {
+                return Hash{}(key, uint64_t{0});
+            }
+            else
+            {
+                return Hash{}(key);
+            }
+        }
+
+        iterator find_prehashed(const Key& key, size_t hash)
+        {
+            const auto result = find_impl(key, hash_key_from_unseeded(key, hash));
+            return result.found ? iterator(this, result.index) : end();
+        }
+
+        const_iterator find_prehashed(const Key& key, size_t hash) const
+        {
+            const auto result = find_impl(key, hash_key_from_unseeded(key, hash));
+            return result.found ? const_iterator(this, result.index) : end();
+        }
+
+        template <typename K, typename... Args>
+            requires std::is_same_v<std::remove_cvref_t<K>, Key>
+        std::pair<iterator, bool> try_emplace_prehashed(K&& key, size_t hash, Args&&... args)
+        {
+            const size_t full_hash = hash_key_from_unseeded(key, hash);
+            const auto [index, inserted] = try_emplace_hashed_impl(
+                    full_hash, std::forward<K>(key), std::forward<Args>(args)...
+            );
+            return {iterator(this, index), inserted};
+        }
+
+        bool erase_prehashed(const Key& key, size_t hash)
+        {
+            const auto result = find_impl(key, hash_key_from_unseeded(key, hash));
+            if (result.found) [[likely]]
+            {
+                erase_at(result.index);
+                return true;
+            }
+            return false;
+        }
+
+        // Erases every entry for which pred(const Entry&) returns true and returns how many
+        // were erased. Only the groups flagged in m_group_mask are visited and no key is hashed,
+        // which makes a sweep over a large table much cheaper than erasing its keys one by one
+        template <typename Pred> size_t erase_if(Pred pred)
+        {
+            if (m_size == 0)
+            {
+                return 0;
+            }
+
+            const size_t old_size = m_size;
+            const size_t group_words = layout_for(m_capacity).group_words;
+            for (size_t word = 0; word < group_words; ++word)
+            {
+                for (uint64_t groups = m_group_mask[word]; groups; groups &= groups - 1)
+                {
+                    erase_in_group_if((word * 64 + BitMask::ctzll(groups)) * kGroupWidth, pred);
+                }
+            }
+
+            // Nothing is left to find past a tombstone, so an emptied table starts over clean
+            if (m_size == 0)
+            {
+                reset_ctrl();
+            }
+            return old_size - m_size;
+        }
+
+        // Occupied entries of one control group, as passed to the for_each_group callback.
+        // Iterating it walks the bits of the group's match_full() mask
+        template <bool IsConst> class group_entries_impl
+        {
+            using slot_pointer = std::conditional_t<IsConst, const Slot*, Slot*>;
+
+          public:
+            using reference = std::conditional_t<IsConst, const Entry&, Entry&>;
+
+            class iterator
+            {
+              public:
+                reference operator*() const
+                {
+                    return m_slots[m_full.next()];
+                }
+
+                iterator& operator++()
+                {
+                    m_full.advance();
+                    return *this;
+                }
+
+                bool operator==(std::default_sentinel_t) const
+                {
+                    return !m_full;
+                }
+
+              private:
+                friend class group_entries_impl;
+
+                iterator(slot_pointer slots, BitMask full) : m_slots(slots), m_full(full) {}
+
+                slot_pointer m_slots;
+                BitMask m_full;
+            };
+
+            iterator begin() const
+            {
+                return iterator(m_slots, m_full);
+            }
+
+            std::default_sentinel_t end() const
+            {
+                return {};
+            }
+
+            // Index of the group's first slot in the table
+            size_t first_slot() const
+            {
+                return m_first_slot;
+            }
+
+          private:
+            friend class HashMap;
+
+            group_entries_impl(slot_pointer slots, size_t first_slot, BitMask full)
+                : m_slots(slots), m_first_slot(first_slot), m_full(full)
+            {
+            }
+
+            slot_pointer m_slots;
+            size_t m_first_slot;
+            BitMask m_full;
+        };
+
+        using group_entries = group_entries_impl<false>;
+        using const_group_entries = group_entries_impl<true>;
+
+        // Calls fn(entry) for every entry. Only the groups flagged in m_group_mask are loaded,
+        // and each one is scanned from a single match_full() mask, which is cheaper than
+        // advancing an iterator slot by slot. fn must not insert or erase
+        template <typename Fn> void for_each(Fn fn)
+        {
+            for_each_group([&fn](const group_entries& group) {
+                for (Entry& entry : group)
+                {
+                    fn(entry);
+                }
+            });
+        }
+
+        template <typename Fn> void for_each(Fn fn) const
+        {
+            for_each_group([&fn](const const_group_entries& group) {
+                for (const Entry& entry : group)
+                {
+                    fn(entry);
+                }
+            });
+        }
+
+        // Calls fn(group) once per control group that may hold entries, with a range over the
+        // group's occupied entries, so that per-group work (a partial sum, a batch of output)
+        // is done once per group instead of once per entry
+        template <typename Fn> void for_each_group(Fn fn)
+        {
+            for_each_group_in_words<group_entries>(*this, 0, group_words(), fn);
+        }
+
+        template <typename Fn> void for_each_group(Fn fn) const
+        {
+            for_each_group_in_words<const_group_entries>(*this, 0, group_words(), fn);
+        }
+
+        // Calls fn(entry) for the entries in the chunk-th of chunks equal slices of the table,
+        // cut along m_group_mask words. Every entry belongs to exactly one chunk, so the chunks
+        // can be handed to the threads of an outside pool
+        template <typename Fn> void for_each_in_chunk(size_t chunk, size_t chunks, Fn fn)
+        {
+            for_each_in_chunk_impl<group_entries>(*this, chunk, chunks, fn);
+        }
+
+        template <typename Fn> void for_each_in_chunk(size_t chunk, size_t chunks, Fn fn) const
+        {
+            for_each_in_chunk_impl<const_group_entries>(*this, chunk, chunks, fn);
+        }
+
+        // for_each on up to threads threads, each scanning one chunk. fn is called concurrently
+        // on different entries, so it must be safe to run in parallel; it must not throw,
+        // insert or erase. Tables of fewer than 64 groups per thread use fewer threads. fn may
+        // also take the worker index as a second argument, below threads, to accumulate into
+        // per-thread partial results without sharing a counter
+        template <typename Fn>
+        void parallel_for_each(Fn fn, size_t threads = std::thread::hardware_concurrency())
+        {
+            parallel_for_each_impl(*this, fn, threads);
         }
 
-        HashMap(HashMap&& other) noexcept
-            : m_ctrl(other.m_ctrl), m_buckets(other.m_buckets), m_group_mask(other.m_group_mask),
-              m_size(other.m_size), m_capacity(other.m_capacity)
+        template <typename Fn>
+        void parallel_for_each(Fn fn, size_t threads = std::thread::hardware_concurrency()) const
         {
-            other.m_ctrl = nullptr;
-            other.m_buckets = nullptr;
-            other.m_group_mask = nullptr;
-            other.m_size = 0;
-            other.m_capacity = 0;
+            parallel_for_each_impl(*this, fn, threads);
         }
 
-        HashMap& operator=(HashMap&& other) noexcept
+        node_type extract(const Key& key)
         {
-            if (this != &other)
+            auto it = find(key);
+            if (it == end())
             {
-                destroy_and_deallocate();
-                m_ctrl = other.m_ctrl;
-                m_buckets = other.m_buckets;
-                m_group_mask = other.m_group_mask;
-                m_size = other.m_size;
-                m_capacity = other.m_capacity;
-                other.m_ctrl = nullptr;
-                other.m_buckets = nullptr;
-                other.m_group_mask = nullptr;
-                other.m_size = 0;
-                other.m_capacity = 0;
+                return node_type{};
             }
-            return *this;
+            return extract(it);
         }
 
-        template <typename K, typename V> bool emplace(K&& key, V&& value)
+        node_type extract(const_iterator it)
         {
-            if (capacity() == 0 || m_size >= capacity() * 0.875) [[unlikely]]
+            if (it == end())
             {
-                resize_and_rehash();
+                return node_type{};
             }
 
-            const size_t full_hash = Hash{}(key);
-            const auto result = find_impl(key, full_hash);
+            node_type node(std::move(const_cast<Entry&>(*it)));
+            erase(it);
+            return node;
+        }
 
-            if (result.found)
+        void insert(node_type&& node)
+        {
+            if (!node.empty())
             {
-                return false; // Duplicate key
+                emplace(std::move(node.key()), std::move(node.mapped()));
             }
+        }
 
-            // Insert into the primary table
-            const int8_t hash2_val = h2(full_hash);
+        size_t size() const
+        {
+            return m_size;
+        }
+        size_t capacity() const
+        {
+            return m_capacity;
+        }
 
-            // Create a new Entry with the key and value
-            new (&m_buckets[result.index]) Entry{std::forward<K>(key), std::forward<V>(value)};
+        // New keys the table takes before an insertion makes room, by growing or by reclaiming
+        // tombstones. At zero, the next insertion of a new key may rehash every entry
+        size_t growth_left() const
+        {
+            const size_t used = m_size + m_tombstones;
+            const size_t max_load = max_load_for(m_capacity);
+            return used < max_load ? max_load - used : 0;
+        }
 
-            // Update control bytes
-            m_ctrl[result.index] = hash2_val;
+        // Occupancy and probe lengths, for telling a clustered table or a weak hash from one
+        // that is merely full. Probe lengths are measured for up to sample_size entries spread
+        // evenly over the table. Reads the whole control array, so call it from diagnostics,
+        // not from a hot path
+        TableStats stats(size_t sample_size = 1024) const
+        {
+            TableStats result;
+            result.size = m_size;
+            result.capacity = m_capacity;
+            result.tombstones = m_tombstones;
+            if (m_capacity == 0)
+            {
+                return result;
+            }
 
-            // Update sentinel if within bounds
-            size_t sentinel_index = result.index + capacity();
-            if (sentinel_index < capacity() + kGroupWidth)
+            result.load_factor = static_cast<double>(m_size) / m_capacity;
+            result.tombstone_factor = static_cast<double>(m_tombstones) / m_capacity;
+            result.groups = m_capacity / kGroupWidth;
+            const size_t group_words = (result.groups + 63) / 64;
+            for (size_t word = 0; word < group_words; ++word)
             {
-                m_ctrl[sentinel_index] = hash2_val;
+                result.occupied_groups += std::popcount(m_group_mask[word]);
             }
 
-            const size_t group_index = result.index / kGroupWidth;
-            m_group_mask[group_index / 64] |= (UINT64_C(1) << (group_index % 64));
+            if (sample_size == 0 || m_size == 0)
+            {
+                return result;
+            }
 
-            m_size++;
+            // Every stride-th entry in slot order. An entry's probe length follows from where its
+            // slot lies on the probe sequence of its hash
+            const size_t stride = std::max<size_t>(1, m_size / sample_size);
+            size_t seen = 0;
+            size_t total_length = 0;
+            for (size_t index = 0; index < m_capacity && result.sampled_keys < sample_size; ++index)
+            {
+                if (!detail::is_full(m_ctrl[index]) || seen++ % stride != 0)
+                {
+                    continue;
+                }
 
-            return true;
+                const size_t length = probe_length(entry_hash(m_buckets[index]), index);
+                const size_t bucket = std::min(length, TableStats::kProbeHistogramSize) - 1;
+                result.probe_length_histogram[bucket]++;
+                result.max_probe_length = std::max(result.max_probe_length, length);
+                total_length += length;
+                result.sampled_keys++;
+            }
+            result.mean_probe_length = static_cast<double>(total_length) / result.sampled_keys;
+            return result;
         }
 
-        bool insert(const Key& key, const Value& value)
+        // Totals since construction, the last copy or reset_counters(). All zero unless
+        // OPTIMAP_ENABLE_COUNTERS is defined
+        OperationCounters counters() const noexcept
         {
-            return emplace(key, value);
+            OperationCounters result;
+#if defined(OPTIMAP_ENABLE_COUNTERS)
+            result.lookups = m_counters.lookups.load(std::memory_order_relaxed);
+            result.probes = m_counters.probes.load(std::memory_order_relaxed);
+            result.key_comparisons = m_counters.key_comparisons.load(std::memory_order_relaxed);
+            result.h2_false_positives =
+                    m_counters.h2_false_positives.load(std::memory_order_relaxed);
+            result.rehashes = m_counters.rehashes.load(std::memory_order_relaxed);
+#endif
+            return result;
         }
 
-        // Overload for r-values to enable move semantics
-        bool insert(Key&& key, Value&& value)
+        void reset_counters() noexcept
         {
-            return emplace(std::move(key), std::move(value));
+#if defined(OPTIMAP_ENABLE_COUNTERS)
+            m_counters.reset();
+#endif
         }
 
-        // Forward declaration
-        template <bool IsConst> class iterator_impl;
-
-        // Aliases
-        using iterator = iterator_impl<false>;
-        using const_iterator = iterator_impl<true>;
-
-        class node_type
+        // Sizes the table so that at least n elements fit under the max load factor, migrating
+        // existing entries in a single pass. Never shrinks the table
+        void reserve(size_t n)
         {
-          public:
-            using key_type = Key;
-            using mapped_type = Value;
-
-            node_type() = default;
-
-            explicit node_type(Entry&& entry) : m_entry(std::move(entry)) {}
-
-            bool empty() const noexcept
+            const size_t required_capacity = capacity_for(n);
+            if (required_capacity > capacity())
             {
-                return !m_entry.has_value();
+                resize_and_rehash(required_capacity);
             }
-            explicit operator bool() const noexcept
+        }
+
+        // Rehashes into a table with at least count slots that also holds size() elements under
+        // the max load factor. Unlike reserve(), this may shrink the table; rehash(0) shrinks it
+        // to the smallest capacity that fits the current elements
+        void rehash(size_t count)
+        {
+            size_t new_capacity = capacity_for(m_size);
+            if (count > 0)
             {
-                return m_entry.has_value();
+                new_capacity =
+                        std::max(new_capacity, next_power_of_2(std::max(count, kGroupWidth)));
             }
 
-            key_type& key()
+            if (new_capacity == 0)
             {
-                return m_entry->first;
+                destroy_and_deallocate();
+                return;
             }
 
-            mapped_type& mapped()
+            if (new_capacity != capacity())
             {
-                return m_entry->second;
+                resize_and_rehash(new_capacity);
             }
+        }
 
-          private:
-            friend class HashMap;
-            std::optional<Entry> m_entry;
-        };
+        // Number of threads used to migrate entries when the table grows or is rehashed. Tables
+        // with fewer than 65,536 entries are always migrated serially. Default 1
+        void set_rehash_threads(size_t threads)
+        {
+            m_rehash_threads = std::max<size_t>(threads, 1);
+        }
 
-        iterator find(const Key& key)
+        size_t rehash_threads() const
         {
-            const size_t full_hash = Hash{}(key);
-            const auto result = find_impl(key, full_hash);
+            return m_rehash_threads;
+        }
 
-            if (result.found)
+        // Watchdog threshold for the probe-length defense of watch_probe_length: an insertion
+        // that loads this many groups or more to find a free slot rehashes the table under a
+        // random seed. 0 turns the watchdog off. The default, 2048 slots' worth of groups, is
+        // far above the longest probe of a well-hashed table at max load (about 60 groups of 16
+        // for 2^26 slots), so it only fires on clustered hashes
+        static constexpr size_t kDefaultProbeLimit = 2048 / kGroupWidth;
+
+        void set_probe_limit(size_t groups)
+        {
+            m_probe_limit = groups == 0 ? SIZE_MAX : groups;
+        }
+
+        size_t probe_limit() const
+        {
+            return m_probe_limit == SIZE_MAX ? 0 : m_probe_limit;
+        }
+
+        // Seed mixed into every hash of this map: passed to hashers that take one as a second
+        // argument (the GxHash family), and used to remix the output of any other hasher. 0,
+        // the default, keeps the hasher's plain output and makes lookups the same in every run
+        uint64_t seed() const
+        {
+            return m_seed;
+        }
+
+        // Rehashes every entry under seed, at the same capacity. A map that takes keys from
+        // untrusted input should call reseed() on construction to draw a random seed, so that
+        // colliding keys cannot be precomputed. Copies share the seed of their source, since
+        // the table is copied as is; entries inserted from another map are always rehashed
+        // under this map's seed, whatever the source's seed or cached hashes
+        void reseed(uint64_t seed)
+        {
+            m_seed = seed;
+            if (m_size == 0)
             {
-                return iterator(this, result.index);
+                return;
             }
 
-            return end();
+            if constexpr (StoreHash)
+            {
+                for (size_t i = 0; i < m_capacity; ++i)
+                {
+                    if (detail::is_full(m_ctrl[i]))
+                    {
+                        m_buckets[i].hash = hash_key(m_buckets[i].first);
+                    }
+                }
+            }
+            resize_and_rehash(m_capacity);
         }
 
-        const_iterator find(const Key& key) const
+        void reseed()
         {
-            const size_t full_hash = Hash{}(key);
-            const auto result = find_impl(key, full_hash);
+            reseed(detail::random_seed());
+        }
 
-            if (result.found)
+        // Builds a map from a random access range of key-value pairs, hashing and placing the
+        // entries on up to threads threads. Equivalent to emplacing the pairs in order: for a
+        // repeated key, the first pair wins
+        template <std::ranges::random_access_range R>
+            requires std::ranges::sized_range<R>
+        static HashMap from_range(
+                const R& range,
+                size_t threads = std::thread::hardware_concurrency(),
+                const Allocator& alloc = Allocator()
+        )
+        {
+            HashMap map(0, alloc);
+            const size_t count = static_cast<size_t>(std::ranges::size(range));
+            if (count == 0)
             {
-                return const_iterator(this, result.index);
+                return map;
             }
 
-            return end();
+            map.allocate_and_initialize(capacity_for(count));
+            RangeSource<R> source{range, &map};
+            map.place_parallel(source, std::max<size_t>(threads, 1), true);
+            return map;
         }
 
-        iterator erase(iterator it)
+        // Writes the table to out: a versioned header, then the table block byte for byte.
+        // Nothing is rehashed on either side; the file only loads into the same map type built
+        // with the same group width. Throws std::runtime_error on write failure
+        void write_to(std::ostream& out) const
+            requires kSerializable
         {
-            if (it == end())
+            detail::TableFileHeader header = file_header_for(m_capacity);
+            header.size = m_size;
+            header.tombstones = m_tombstones;
+            header.hash_seed = m_seed;
+            char padded_header[detail::kTableFileHeaderBytes] = {};
+            std::memcpy(padded_header, &header, sizeof(header));
+            out.write(padded_header, sizeof(padded_header));
+            if (m_capacity > 0)
             {
-                return end();
+                out.write(reinterpret_cast<const char*>(m_ctrl), header.block_bytes);
+            }
+            if (!out)
+            {
+                throw std::runtime_error("Failed to write OptiMap table");
             }
-            erase(it->first);
-            return ++it;
         }
 
-        iterator erase(const_iterator it)
+        void save(const std::string& path) const
+            requires kSerializable
         {
-            if (it == end())
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out)
             {
-                return end();
+                throw std::runtime_error("Cannot open " + path + " for writing");
             }
-            erase(it->first);
-            // Need to return a non-const iterator. Just return end() for now. Better implementation
-            // would find the next element and return an iterator to it. I'm dumb and lazy so that's
-            // not getting fixed right now. Hopefully I remember to come back to this.
-            return end();
+            write_to(out);
         }
 
-        bool erase(const Key& key)
+        // Reads a table written by write_to into memory from alloc. Throws std::runtime_error if
+        // the stream is truncated or was written by a different map type
+        static HashMap read_from(std::istream& in, const Allocator& alloc = Allocator())
+            requires kSerializable
         {
-            const size_t full_hash = Hash{}(key);
-            const auto result = find_impl(key, full_hash);
-
-            if (result.found) [[likely]]
+            char padded_header[detail::kTableFileHeaderBytes];
+            if (!in.read(padded_header, sizeof(padded_header)))
             {
-                m_buckets[result.index].~Entry();
-                m_ctrl[result.index] = kDeleted;
-
-                // Update sentinel if within bounds
-                size_t sentinel_index = result.index + capacity();
-
-                if (sentinel_index < capacity() + kGroupWidth)
-                {
-                    m_ctrl[sentinel_index] = kDeleted;
-                }
-
-                m_size--;
-
-                // Check if the group is now empty and clear the bit if so
-                const size_t group_index = result.index / kGroupWidth;
-                const size_t group_start_index = group_index * kGroupWidth;
-
-                Group group(&m_ctrl[group_start_index]);
+                throw std::runtime_error("Truncated OptiMap table");
+            }
+            detail::TableFileHeader header;
+            std::memcpy(&header, padded_header, sizeof(header));
+            validate_file_header(header);
 
-                if ((~group.match_empty_or_deleted().mask & 0xFFFF) == 0)
+            HashMap map(0, alloc);
+            if (header.capacity > 0)
+            {
+                map.allocate_table(header.capacity);
+                if (!in.read(reinterpret_cast<char*>(map.m_ctrl), header.block_bytes))
                 {
-                    m_group_mask[group_index / 64] &= ~(UINT64_C(1) << (group_index % 64));
+                    throw std::runtime_error("Truncated OptiMap table");
                 }
-
-                return true;
+                map.m_size = header.size;
+                map.m_tombstones = header.tombstones;
             }
-
-            return false;
+            map.m_seed = header.hash_seed;
+            return map;
         }
 
-        node_type extract(const Key& key)
+#if defined(OPTIMAP_HAVE_MMAP)
+        // A table mapped read-only from a file saved with save(). Lookups and iteration run
+        // directly on the page cache, which processes mapping the same file share. Dereference
+        // for the const HashMap interface; copy it (HashMap copy = *mapped) for a private,
+        // writable map in ordinary memory
+        class Mapped
         {
-            auto it = find(key);
-            if (it == end())
+          public:
+            const HashMap& operator*() const noexcept
             {
-                return node_type{};
+                return m_map;
             }
-            return extract(it);
-        }
 
-        node_type extract(const_iterator it)
-        {
-            if (it == end())
+            const HashMap* operator->() const noexcept
             {
-                return node_type{};
+                return &m_map;
             }
 
-            node_type node(std::move(const_cast<Entry&>(*it)));
-            erase(it);
-            return node;
-        }
+          private:
+            friend class HashMap;
 
-        void insert(node_type&& node)
-        {
-            if (!node.empty())
-            {
-                emplace(std::move(node.key()), std::move(node.mapped()));
-            }
-        }
+            explicit Mapped(HashMap&& map) : m_map(std::move(map)) {}
 
-        size_t size() const
+            HashMap m_map;
+        };
+
+        // Maps a file written by save() and uses it as a read-only table without reading or
+        // rehashing it. Throws std::runtime_error if the file cannot be mapped or was written
+        // by a different map type
+        static Mapped open_mapped(const std::string& path)
+            requires kSerializable
         {
-            return m_size;
+            return Mapped(map_file(path, false));
         }
-        size_t capacity() const
+
+        // Maps a file written by save() privately: the map is fully writable, and pages are
+        // copied on first write, so the file itself never changes. Growth moves the table into
+        // memory from the allocator and releases the mapping
+        static HashMap open_mapped_copy_on_write(const std::string& path)
+            requires kSerializable
         {
-            return m_capacity;
+            return map_file(path, true);
         }
+#endif
+
 
+        // Removes every entry but keeps the table, so refilling a cleared map does not allocate
         void clear()
         {
-            const size_t old_capacity = m_capacity;
-            destroy_and_deallocate();
-            allocate_and_initialize(old_capacity);
+            if (m_capacity == 0)
+            {
+                return;
+            }
+
+            destroy_entries();
+            reset_ctrl();
+            m_size = 0;
         }
 
         iterator begin()
@@ -857,105 +3024,182 @@ namespace optimap
 
         bool contains(const Key& key) const
         {
-            return find(key) != end();
+            return lookup(key).found;
         }
 
-        Value& at(const Key& key)
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        bool contains(const K& key) const
         {
-            const size_t full_hash = Hash{}(key);
-            const auto result = find_impl(key, full_hash);
-
-            if (result.found)
-            {
-                return m_buckets[result.index].second;
-            }
+            return lookup(key).found;
+        }
 
-            throw std::out_of_range("Key not found in HashMap");
+        // Looks up every key in keys, writing one iterator per key (end() on a miss) to out.
+        // Faster than calling find() in a loop on tables that do not fit in cache
+        template <typename OutputIt> OutputIt find_many(std::span<const Key> keys, OutputIt out)
+        {
+            probe_many(keys, [&](const FindResult& result) {
+                *out++ = result.found ? iterator(this, result.index) : end();
+            });
+            return out;
         }
 
-        const Value& at(const Key& key) const
+        template <typename OutputIt>
+        OutputIt find_many(std::span<const Key> keys, OutputIt out) const
         {
-            const size_t full_hash = Hash{}(key);
-            const auto result = find_impl(key, full_hash);
+            probe_many(keys, [&](const FindResult& result) {
+                *out++ = result.found ? const_iterator(this, result.index) : end();
+            });
+            return out;
+        }
 
-            if (result.found)
-            {
-                return m_buckets[result.index].second;
-            }
+        // Writes one bool per key to out, true if the key is present
+        template <typename OutputIt>
+        OutputIt contains_many(std::span<const Key> keys, OutputIt out) const
+        {
+            probe_many(keys, [&](const FindResult& result) { *out++ = result.found; });
+            return out;
+        }
 
-            throw std::out_of_range("Key not found in HashMap");
+        Value& at(const Key& key)
+        {
+            return m_buckets[index_of_or_throw(key)].second;
         }
 
-        Value& operator[](const Key& key)
+        const Value& at(const Key& key) const
         {
-            // Reuse find_impl to get the correct index for insertion or retrieval
-            if (capacity() == 0 || m_size >= capacity() * 0.875) [[unlikely]]
-            {
-                resize_and_rehash();
-            }
+            return m_buckets[index_of_or_throw(key)].second;
+        }
 
-            const size_t full_hash = Hash{}(key);
-            const auto result = find_impl(key, full_hash);
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        Value& at(const K& key)
+        {
+            return m_buckets[index_of_or_throw(key)].second;
+        }
 
-            if (result.found)
-            {
-                return m_buckets[result.index].second;
-            }
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        const Value& at(const K& key) const
+        {
+            return m_buckets[index_of_or_throw(key)].second;
+        }
 
-            // Key not found, insert new element at returned slot
-            const int8_t hash2_val = h2(full_hash);
+        // Inserts an entry for key with a Value constructed from args, unless the key is already
+        // present. The value is only constructed when the insertion happens. Returns an iterator
+        // to the entry with that key and whether it was inserted
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+        {
+            const auto [index, inserted] = try_emplace_impl(key, std::forward<Args>(args)...);
+            return {iterator(this, index), inserted};
+        }
 
-            new (&m_buckets[result.index]) Entry{key, Value{}};
-            m_ctrl[result.index] = hash2_val;
+        template <typename... Args> std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args)
+        {
+            const auto [index, inserted] =
+                    try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+            return {iterator(this, index), inserted};
+        }
 
-            // Update sentinel
-            size_t sentinel_index = result.index + capacity();
+        // Heterogeneous try_emplace: a Key is constructed from key only on insertion
+        template <typename K, typename... Args>
+            requires detail::transparent_key<Hash, Key, K> && std::is_constructible_v<Key, K&&>
+        std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+        {
+            const auto [index, inserted] =
+                    try_emplace_impl(std::forward<K>(key), std::forward<Args>(args)...);
+            return {iterator(this, index), inserted};
+        }
 
-            if (sentinel_index < capacity() + kGroupWidth)
-            {
-                m_ctrl[sentinel_index] = hash2_val;
-            }
+        // Inserts key -> value unless key is present, in which case nothing changes. Returns an
+        // iterator to the entry with that key and whether it was inserted, so no second lookup
+        // is needed to reach it
+        template <typename K, typename V> std::pair<iterator, bool> emplace(K&& key, V&& value)
+        {
+            const auto [index, inserted] =
+                    try_emplace_impl(std::forward<K>(key), std::forward<V>(value));
+            return {iterator(this, index), inserted};
+        }
 
-            const size_t group_index = result.index / kGroupWidth;
-            m_group_mask[group_index / 64] |= (UINT64_C(1) << (group_index % 64));
+        // Inserts key -> value, or assigns value to the existing entry. Returns an iterator to
+        // the entry and whether it was inserted
+        template <typename V> std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value)
+        {
+            const auto [index, inserted] = insert_or_assign_impl(key, std::forward<V>(value));
+            return {iterator(this, index), inserted};
+        }
 
-            m_size++;
-            return m_buckets[result.index].second;
+        template <typename V> std::pair<iterator, bool> insert_or_assign(Key&& key, V&& value)
+        {
+            const auto [index, inserted] =
+                    insert_or_assign_impl(std::move(key), std::forward<V>(value));
+            return {iterator(this, index), inserted};
         }
 
-        Value& operator[](Key&& key)
+        template <typename K, typename V>
+            requires detail::transparent_key<Hash, Key, K> && std::is_constructible_v<Key, K&&>
+        std::pair<iterator, bool> insert_or_assign(K&& key, V&& value)
         {
-            // Reuse find_impl to get the correct index for insertion or retrieval
-            if (capacity() == 0 || m_size >= capacity() * 0.875) [[unlikely]]
-            {
-                resize_and_rehash();
-            }
+            const auto [index, inserted] =
+                    insert_or_assign_impl(std::forward<K>(key), std::forward<V>(value));
+            return {iterator(this, index), inserted};
+        }
 
-            const size_t full_hash = Hash{}(key);
-            const auto result = find_impl(key, full_hash);
-            if (result.found)
-            {
-                return m_buckets[result.index].second;
-            }
+        // Value-initializes the value of a missing key
+        Value& operator[](const Key& key)
+        {
+            // Indexed in a second statement: the insertion may move m_buckets
+            const size_t index = try_emplace_impl(key).first;
+            return m_buckets[index].second;
+        }
 
-            // Key not found, insert a new element at the returned slot
-            const int8_t hash2_val = h2(full_hash);
+        Value& operator[](Key&& key)
+        {
+            const size_t index = try_emplace_impl(std::move(key)).first;
+            return m_buckets[index].second;
+        }
 
-            new (&m_buckets[result.index]) Entry{std::move(key), Value{}};
-            m_ctrl[result.index] = hash2_val;
+        // Inserts each key of keys that is not present yet, with a value-initialized Value, and
+        // returns how many were inserted. Like find_many, hashes and prefetches a block of keys
+        // before probing for any of them, so the cache misses of neighbouring insertions overlap
+        size_t insert_many(std::span<const Key> keys)
+            requires std::is_default_constructible_v<Value>
+        {
+            size_t inserted = 0;
+            size_t hashes[kPrefetchBlock];
 
-            // Update sentinel
-            size_t sentinel_index = result.index + capacity();
-            if (sentinel_index < capacity() + kGroupWidth)
+            for (size_t block_start = 0; block_start < keys.size(); block_start += kPrefetchBlock)
             {
-                m_ctrl[sentinel_index] = hash2_val;
-            }
+                const size_t block_size = std::min(kPrefetchBlock, keys.size() - block_start);
+                const uint64_t block_seed = m_seed;
 
-            const size_t group_index = result.index / kGroupWidth;
-            m_group_mask[group_index / 64] |= (UINT64_C(1) << (group_index % 64));
+                for (size_t i = 0; i < block_size; ++i)
+                {
+                    hashes[i] = hash_key(keys[block_start + i]);
+                    if (capacity() > 0) [[likely]]
+                    {
+                        const size_t index = probe_sequence(hashes[i]).offset();
+                        prefetch(&m_ctrl[index]);
+                        prefetch(&m_buckets[index]);
+                    }
+                }
 
-            m_size++;
-            return m_buckets[result.index].second;
+                for (size_t i = 0; i < block_size; ++i)
+                {
+                    const Key& key = keys[block_start + i];
+                    // A reseed by the watchdog invalidates the hashes of the rest of the block
+                    size_t full_hash = m_seed == block_seed ? hashes[i] : hash_key(key);
+                    const FindResult result = find_or_prepare_insert_hashed(key, full_hash);
+                    if (!result.found)
+                    {
+                        construct_entry(result.index, full_hash, key, Value());
+                        occupy_slot(result.index, h2(full_hash));
+                        ++inserted;
+                    }
+                }
+            }
+            return inserted;
         }
 
         // For mutable and constant iterators
@@ -1034,13 +3278,13 @@ namespace optimap
                 // Check current group from m_index onwards
                 Group group(&m_map->m_ctrl[group_index * kGroupWidth]);
                 // Get mask of occupied slots
-                uint32_t occupied_mask = ~group.match_empty_or_deleted().mask;
+                BitMask occupied_mask = group.match_full();
                 // Mask out bits before current index
-                occupied_mask &= (0xFFFFFFFF << (m_index % kGroupWidth));
+                occupied_mask.skip_before(m_index % kGroupWidth);
 
                 if (occupied_mask) [[likely]]
                 {
-                    m_index = group_index * kGroupWidth + BitMask(occupied_mask).next();
+                    m_index = group_index * kGroupWidth + occupied_mask.next();
                     return;
                 }
 
@@ -1066,8 +3310,7 @@ namespace optimap
                         group_index = mask_word_index * 64 + BitMask::ctzll(mask_word);
                         Group first_group(&m_map->m_ctrl[group_index * kGroupWidth]);
 
-                        occupied_mask = ~first_group.match_empty_or_deleted().mask;
-                        m_index = group_index * kGroupWidth + BitMask(occupied_mask).next();
+                        m_index = group_index * kGroupWidth + first_group.match_full().next();
 
                         return;
                     }
@@ -1091,4 +3334,20 @@ namespace optimap
         };
     };
 
+    namespace pmr
+    {
+        // HashMap whose table is allocated from a std::pmr::memory_resource
+        template <
+                typename Key,
+                typename Value,
+                typename Hash = GxHash<Key>,
+                bool StoreHash = false>
+        using HashMap = optimap::HashMap<
+                Key,
+                Value,
+                Hash,
+                StoreHash,
+                std::pmr::polymorphic_allocator<std::pair<const Key, Value>>>;
+    } // namespace pmr
+
 } // namespace optimap
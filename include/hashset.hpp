@@ -0,0 +1,251 @@
+#pragma once
+
+#include "hashmap.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace optimap
+{
+
+    namespace detail
+    {
+        // Value of the table behind HashSet. Empty, so with HashMap's OPTIMAP_NO_UNIQUE_ADDRESS
+        // value member a slot is exactly a Key
+        struct SetValue
+        {
+            bool operator==(const SetValue&) const = default;
+        };
+    } // namespace detail
+
+    // Set of keys on the same SwissTable as HashMap: control bytes, probing, growth, tombstone
+    // cleanup and the group mask are shared, and slots hold the bare key. A HashSet<uint32_t>
+    // therefore takes 4 bytes per slot, where a map to an empty struct used to take 8.
+    //
+    // Iterators yield const Key&, since changing a key in place would break the table.
+    // insert_many and contains_many hash and prefetch blocks of keys ahead of probing, which
+    // pays off on sets that do not fit in cache
+    template <
+            typename Key,
+            typename Hash = GxHash<Key>,
+            bool StoreHash = false,
+            typename Allocator = AlignedAllocator<Key, 64>,
+            typename ProbePolicy = LinearProbing>
+    class HashSet
+    {
+        using table_type =
+                HashMap<Key, detail::SetValue, Hash, StoreHash, Allocator, ProbePolicy>;
+
+      public:
+        using key_type = Key;
+        using value_type = Key;
+        using allocator_type = Allocator;
+
+        class const_iterator
+        {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Key;
+            using difference_type = std::ptrdiff_t;
+            using reference = const Key&;
+            using pointer = const Key*;
+
+            const_iterator() = default;
+
+            reference operator*() const
+            {
+                return m_it->first;
+            }
+
+            pointer operator->() const
+            {
+                return &m_it->first;
+            }
+
+            const_iterator& operator++()
+            {
+                ++m_it;
+                return *this;
+            }
+
+            const_iterator operator++(int)
+            {
+                const_iterator tmp = *this;
+                ++m_it;
+                return tmp;
+            }
+
+            friend bool operator==(const const_iterator& a, const const_iterator& b)
+            {
+                return a.m_it == b.m_it;
+            }
+
+          private:
+            friend class HashSet;
+
+            explicit const_iterator(typename table_type::const_iterator it) : m_it(it) {}
+
+            typename table_type::const_iterator m_it;
+        };
+
+        // Keys are immutable, so both iterator kinds are the same
+        using iterator = const_iterator;
+
+        explicit HashSet(size_t capacity = 0, const Allocator& alloc = Allocator())
+            : m_table(capacity, alloc)
+        {
+        }
+
+        explicit HashSet(const Allocator& alloc) : m_table(0, alloc) {}
+
+        // Returns true if the key was inserted, false if it was already present
+        bool insert(const Key& key)
+        {
+            return m_table.try_emplace(key).second;
+        }
+
+        bool insert(Key&& key)
+        {
+            return m_table.try_emplace(std::move(key)).second;
+        }
+
+        // Constructs a Key from args unless an equal key is present. Returns an iterator to the
+        // key and whether it was inserted
+        template <typename... Args> std::pair<iterator, bool> emplace(Args&&... args)
+        {
+            auto [it, inserted] = m_table.try_emplace(Key(std::forward<Args>(args)...));
+            return {iterator(it), inserted};
+        }
+
+        // Inserts every key of keys that is missing and returns how many were inserted
+        size_t insert_many(std::span<const Key> keys)
+        {
+            return m_table.insert_many(keys);
+        }
+
+        iterator find(const Key& key) const
+        {
+            return iterator(m_table.find(key));
+        }
+
+        bool contains(const Key& key) const
+        {
+            return m_table.contains(key);
+        }
+
+        // Writes one bool per key to out, true if the key is present
+        template <typename OutputIt>
+        OutputIt contains_many(std::span<const Key> keys, OutputIt out) const
+        {
+            return m_table.contains_many(keys, out);
+        }
+
+        bool erase(const Key& key)
+        {
+            return m_table.erase(key);
+        }
+
+        // Heterogeneous overloads, available when Hash is transparent
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        iterator find(const K& key) const
+        {
+            return iterator(m_table.find(key));
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        bool contains(const K& key) const
+        {
+            return m_table.contains(key);
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        bool erase(const K& key)
+        {
+            return m_table.erase(key);
+        }
+
+        // Erases the key it points to and returns an iterator to the next one
+        iterator erase(const_iterator it)
+        {
+            return iterator(m_table.erase(it.m_it));
+        }
+
+        // Erases every key for which pred(key) is true and returns how many were erased
+        template <typename Pred> size_t erase_if(Pred pred)
+        {
+            return m_table.erase_if([&pred](const auto& entry) { return pred(entry.first); });
+        }
+
+        void clear()
+        {
+            m_table.clear();
+        }
+
+        void reserve(size_t n)
+        {
+            m_table.reserve(n);
+        }
+
+        size_t size() const
+        {
+            return m_table.size();
+        }
+
+        bool empty() const
+        {
+            return m_table.size() == 0;
+        }
+
+        size_t capacity() const
+        {
+            return m_table.capacity();
+        }
+
+        // See HashMap::seed() and HashMap::reseed()
+        uint64_t seed() const
+        {
+            return m_table.seed();
+        }
+
+        void reseed(uint64_t seed)
+        {
+            m_table.reseed(seed);
+        }
+
+        void reseed()
+        {
+            m_table.reseed();
+        }
+
+        TableStats stats(size_t sample_size = 1024) const
+        {
+            return m_table.stats(sample_size);
+        }
+
+        allocator_type get_allocator() const noexcept
+        {
+            return m_table.get_allocator();
+        }
+
+        iterator begin() const
+        {
+            return iterator(m_table.begin());
+        }
+
+        iterator end() const
+        {
+            return iterator(m_table.end());
+        }
+
+      private:
+        table_type m_table;
+    };
+
+} // namespace optimap
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#if defined(__linux__)
+#include <linux/mman.h> // MAP_HUGE_2MB and MAP_HUGE_1GB, which glibc's sys/mman.h leaves out
+#endif
+#endif
+
+namespace optimap
+{
+
+    // Allocator for very large tables. Memory comes straight from the OS as anonymous mappings,
+    // rounded up to whole 2 MiB pages (1 GiB pages from 16 GiB up, wasting at most 1/16):
+    //
+    // 1. Explicit huge pages (MAP_HUGETLB) are tried first, 1 GiB pages where the size allows
+    //    and 2 MiB pages otherwise, always with the page size named (MAP_HUGE_1GB, MAP_HUGE_2MB)
+    //    so that the mapping is exactly the size deallocate() unmaps. These need pages reserved
+    //    by the administrator (vm.nr_hugepages), so the request may fail.
+    // 2. Otherwise a regular mapping is made and MADV_HUGEPAGE asks transparent huge pages to
+    //    back it.
+    //
+    // Huge pages cut the TLB misses of random probes into multi-GB tables. Fresh mappings are
+    // zero-filled, which HashMap uses to skip initializing the control bytes and group mask, so
+    // a table's pages are only faulted in as probes reach them.
+    //
+    //     optimap::HashMap<uint64_t, uint64_t, optimap::GxHash<uint64_t>, false,
+    //                      optimap::HugePageAllocator<std::pair<const uint64_t, uint64_t>>>
+    //
+    // Each allocation is its own mapping, so this is only worth it for tables of several MB
+    // and up. On Windows, VirtualAlloc with large pages is tried before regular pages.
+    template <typename T> struct HugePageAllocator
+    {
+        using value_type = T;
+
+        // Every allocation is a fresh anonymous mapping
+        static constexpr bool allocates_zeroed_memory = true;
+
+        static constexpr size_t kHugePageSize = size_t{2} << 20;
+        static constexpr size_t kGiantPageSize = size_t{1} << 30;
+
+        HugePageAllocator() = default;
+
+        template <typename U> constexpr HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+        bool operator==(const HugePageAllocator&) const noexcept
+        {
+            return true;
+        }
+
+        T* allocate(size_t n)
+        {
+            if (n > (std::numeric_limits<size_t>::max() - kGiantPageSize) / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+
+            const size_t bytes = mapping_size(n);
+            void* ptr = map_pages(bytes);
+            if (!ptr)
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(ptr);
+        }
+
+        void deallocate(T* p, size_t n) noexcept
+        {
+#if defined(_WIN32)
+            (void)n;
+            VirtualFree(p, 0, MEM_RELEASE);
+#else
+            munmap(p, mapping_size(n));
+#endif
+        }
+
+      private:
+        static constexpr size_t mapping_size(size_t n)
+        {
+            const size_t bytes = n * sizeof(T);
+            const size_t page = bytes >= 16 * kGiantPageSize ? kGiantPageSize : kHugePageSize;
+            return (bytes + page - 1) / page * page;
+        }
+
+        static void* map_pages(size_t bytes)
+        {
+#if defined(_WIN32)
+            // Large pages need SeLockMemoryPrivilege and a multiple of the large page size
+            const size_t large_page = GetLargePageMinimum();
+            if (large_page != 0 && bytes % large_page == 0)
+            {
+                if (void* ptr = VirtualAlloc(
+                            nullptr,
+                            bytes,
+                            MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                            PAGE_READWRITE
+                    ))
+                {
+                    return ptr;
+                }
+            }
+            return VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+            constexpr int kFlags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+#if defined(MAP_HUGETLB)
+#if defined(MAP_HUGE_1GB)
+            if (bytes % kGiantPageSize == 0)
+            {
+                void* ptr = mmap(
+                        nullptr,
+                        bytes,
+                        PROT_READ | PROT_WRITE,
+                        kFlags | MAP_HUGETLB | MAP_HUGE_1GB,
+                        -1,
+                        0
+                );
+                if (ptr != MAP_FAILED)
+                {
+                    return ptr;
+                }
+            }
+#endif
+            // The page size is always named. A plain MAP_HUGETLB takes the system default, e.g.
+            // 1 GiB with default_hugepagesz=1G or 512 MiB on 64K-page arm64: the kernel would
+            // round the mapping up past mapping_size(), and munmap() would then reject it
+#if defined(MAP_HUGE_2MB)
+            void* huge = mmap(
+                    nullptr,
+                    bytes,
+                    PROT_READ | PROT_WRITE,
+                    kFlags | MAP_HUGETLB | MAP_HUGE_2MB,
+                    -1,
+                    0
+            );
+            if (huge != MAP_FAILED)
+            {
+                return huge;
+            }
+#endif
+#endif
+
+            void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, kFlags, -1, 0);
+            if (ptr == MAP_FAILED)
+            {
+                return nullptr;
+            }
+#if defined(MADV_HUGEPAGE)
+            madvise(ptr, bytes, MADV_HUGEPAGE);
+#endif
+            return ptr;
+#endif
+        }
+    };
+
+} // namespace optimap
@@ -0,0 +1,477 @@
+#pragma once
+
+#include "hashmap.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace optimap
+{
+
+    // HashMap that grows without a stop-the-world rehash. When the table reaches its max load,
+    // a table twice the size of the live entries is allocated next to it and the old one is
+    // drained into it a few entries at a time:
+    //
+    // - Each mutating call (insertions, operator[], erase by key) first moves up to
+    //   kMigrationBatch entries from the draining table into the current one. The draining
+    //   table is freed once it is empty.
+    // - While a migration is running, lookups that miss the current table also probe the
+    //   draining one, and insertions check it for the key first. A key lives in one table only.
+    // - The new table holds twice the live entries, and each mutation adds at most one, so a
+    //   migration always finishes long before the new table fills up.
+    //
+    // The worst insertion then costs kMigrationBatch moves plus allocating and clearing the new
+    // table's control bytes, instead of rehashing every entry. With an allocator that hands out
+    // zeroed memory (HugePageAllocator) the clearing is skipped as well. Outside a migration,
+    // lookups run at HashMap speed; during one, misses pay a second probe.
+    //
+    // References and iterators are invalidated by every mutating call except erase(iterator),
+    // which does not migrate so that erase-while-iterating loops visit every entry.
+    template <
+            typename Key,
+            typename Value,
+            typename Hash = GxHash<Key>,
+            bool StoreHash = false,
+            typename Allocator = AlignedAllocator<std::pair<const Key, Value>, 64>>
+    class IncrementalHashMap
+    {
+        using table_type = HashMap<Key, Value, Hash, StoreHash, Allocator>;
+
+      public:
+        using Entry = typename table_type::Entry;
+
+        // Entries moved from the draining table per mutating call
+        static constexpr size_t kMigrationBatch = 16;
+
+        // Visits the current table, then the draining one
+        template <bool IsConst> class iterator_impl
+        {
+            using map_ptr =
+                    std::conditional_t<IsConst, const IncrementalHashMap*, IncrementalHashMap*>;
+            using table_iterator = std::conditional_t<
+                    IsConst,
+                    typename table_type::const_iterator,
+                    typename table_type::iterator>;
+
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Entry;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<IsConst, const Entry&, Entry&>;
+            using pointer = std::conditional_t<IsConst, const Entry*, Entry*>;
+
+            iterator_impl() = default;
+
+            // Mutable to constant conversion
+            template <bool WasConst>
+                requires(IsConst && !WasConst)
+            iterator_impl(const iterator_impl<WasConst>& other)
+                : m_map(other.m_map), m_it(other.m_it), m_in_draining(other.m_in_draining)
+            {
+            }
+
+            reference operator*() const
+            {
+                return *m_it;
+            }
+
+            pointer operator->() const
+            {
+                return &*m_it;
+            }
+
+            iterator_impl& operator++()
+            {
+                ++m_it;
+                skip_to_draining();
+                return *this;
+            }
+
+            iterator_impl operator++(int)
+            {
+                iterator_impl tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+
+            friend bool operator==(const iterator_impl& a, const iterator_impl& b)
+            {
+                return a.m_it == b.m_it;
+            }
+
+          private:
+            friend class IncrementalHashMap;
+            template <bool> friend class iterator_impl;
+
+            iterator_impl(map_ptr map, table_iterator it, bool in_draining)
+                : m_map(map), m_it(it), m_in_draining(in_draining)
+            {
+                skip_to_draining();
+            }
+
+            // The end of the current table continues at the start of the draining one
+            void skip_to_draining()
+            {
+                if (!m_in_draining && m_it == m_map->m_current.end())
+                {
+                    m_it = m_map->m_draining.begin();
+                    m_in_draining = true;
+                }
+            }
+
+            map_ptr m_map = nullptr;
+            table_iterator m_it;
+            bool m_in_draining = false;
+        };
+
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+
+        explicit IncrementalHashMap(size_t capacity = 0) : m_current(capacity) {}
+
+        // A copy of a map in the middle of a migration continues it from the same point
+        IncrementalHashMap(const IncrementalHashMap& other)
+            : m_current(other.m_current), m_draining(other.m_draining),
+              m_cursor(m_draining.begin())
+        {
+        }
+
+        IncrementalHashMap& operator=(const IncrementalHashMap& other)
+        {
+            if (this != &other)
+            {
+                IncrementalHashMap copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        // The cursor points into the moved table object, so it is found again from the start
+        // of the draining table. Everything before it has been migrated, which leaves it as the
+        // first entry
+        IncrementalHashMap(IncrementalHashMap&& other) noexcept
+            : m_current(std::move(other.m_current)), m_draining(std::move(other.m_draining)),
+              m_cursor(m_draining.begin())
+        {
+            other.m_cursor = other.m_draining.end();
+        }
+
+        IncrementalHashMap& operator=(IncrementalHashMap&& other) noexcept
+        {
+            if (this != &other)
+            {
+                m_current = std::move(other.m_current);
+                m_draining = std::move(other.m_draining);
+                m_cursor = m_draining.begin();
+                other.m_cursor = other.m_draining.end();
+            }
+            return *this;
+        }
+
+        ~IncrementalHashMap() = default;
+
+        // Inserts key with a Value constructed from args unless the key is already present. The
+        // value is only constructed when the insertion happens
+        template <typename K, typename... Args>
+            requires std::is_convertible_v<K&&, const Key&> ||
+                     (detail::transparent_key<Hash, Key, K> && std::is_constructible_v<Key, K&&>)
+        std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+        {
+            migrate_some();
+            if (migrating())
+            {
+                if (auto it = m_draining.find(key); it != m_draining.end())
+                {
+                    return {iterator(this, it, true), false};
+                }
+            }
+
+            // Only a new key can fill the table, and only then does a migration start
+            if (m_current.growth_left() == 0 && m_current.size() != 0 && !m_current.contains(key))
+            {
+                start_migration();
+            }
+
+            auto [it, inserted] =
+                    m_current.try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+            return {iterator(this, it, false), inserted};
+        }
+
+        template <typename K, typename V> std::pair<iterator, bool> emplace(K&& key, V&& value)
+        {
+            return try_emplace(std::forward<K>(key), std::forward<V>(value));
+        }
+
+        bool insert(const Key& key, const Value& value)
+        {
+            return emplace(key, value).second;
+        }
+
+        bool insert(Key&& key, Value&& value)
+        {
+            return emplace(std::move(key), std::move(value)).second;
+        }
+
+        // Inserts key -> value, or overwrites the value if key exists
+        template <typename V> std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value)
+        {
+            auto result = try_emplace(key, std::forward<V>(value));
+            if (!result.second)
+            {
+                result.first->second = std::forward<V>(value);
+            }
+            return result;
+        }
+
+        Value& operator[](const Key& key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        Value& operator[](Key&& key)
+        {
+            return try_emplace(std::move(key)).first->second;
+        }
+
+        iterator find(const Key& key)
+        {
+            return find_in_tables<iterator>(*this, key);
+        }
+
+        const_iterator find(const Key& key) const
+        {
+            return find_in_tables<const_iterator>(*this, key);
+        }
+
+        bool contains(const Key& key) const
+        {
+            return m_current.contains(key) || (migrating() && m_draining.contains(key));
+        }
+
+        Value& at(const Key& key)
+        {
+            return at_in_tables(*this, key);
+        }
+
+        const Value& at(const Key& key) const
+        {
+            return at_in_tables(*this, key);
+        }
+
+        bool erase(const Key& key)
+        {
+            migrate_some();
+            if (m_current.erase(key))
+            {
+                return true;
+            }
+            if (!migrating())
+            {
+                return false;
+            }
+
+            auto it = m_draining.find(key);
+            if (it == m_draining.end())
+            {
+                return false;
+            }
+            erase_draining(it);
+            release_drained_table();
+            return true;
+        }
+
+        // Heterogeneous overloads, available when Hash is transparent
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        iterator find(const K& key)
+        {
+            return find_in_tables<iterator>(*this, key);
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        const_iterator find(const K& key) const
+        {
+            return find_in_tables<const_iterator>(*this, key);
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        bool contains(const K& key) const
+        {
+            return m_current.contains(key) || (migrating() && m_draining.contains(key));
+        }
+
+        // Erases the entry it points to and returns an iterator to the next one. No entries
+        // are migrated, so the rest of an iteration is unaffected
+        iterator erase(const_iterator it)
+        {
+            if (it == end())
+            {
+                return end();
+            }
+
+            if (!it.m_in_draining)
+            {
+                return iterator(this, m_current.erase(it.m_it), false);
+            }
+            return iterator(this, erase_draining(it.m_it), true);
+        }
+
+        iterator erase(iterator it)
+        {
+            return erase(const_iterator(it));
+        }
+
+        // Moves every remaining entry of a running migration, e.g. before a read-mostly phase
+        void finish_migration()
+        {
+            while (migrating())
+            {
+                migrate_some();
+            }
+        }
+
+        bool migrating() const
+        {
+            return m_draining.size() != 0;
+        }
+
+        void clear()
+        {
+            m_current.clear();
+            m_draining = table_type();
+            m_cursor = m_draining.end();
+        }
+
+        void reserve(size_t n)
+        {
+            finish_migration();
+            m_current.reserve(n);
+        }
+
+        size_t size() const
+        {
+            return m_current.size() + m_draining.size();
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        // Capacity of the current table. A draining table is not counted
+        size_t capacity() const
+        {
+            return m_current.capacity();
+        }
+
+        iterator begin()
+        {
+            return iterator(this, m_current.begin(), false);
+        }
+
+        iterator end()
+        {
+            return iterator(this, m_draining.end(), true);
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator(this, m_current.begin(), false);
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator(this, m_draining.end(), true);
+        }
+
+      private:
+        using table_iterator = typename table_type::iterator;
+
+        template <typename Iterator, typename Self, typename K>
+        static Iterator find_in_tables(Self& self, const K& key)
+        {
+            if (auto it = self.m_current.find(key); it != self.m_current.end())
+            {
+                return Iterator(&self, it, false);
+            }
+            if (self.migrating())
+            {
+                if (auto it = self.m_draining.find(key); it != self.m_draining.end())
+                {
+                    return Iterator(&self, it, true);
+                }
+            }
+            return self.end();
+        }
+
+        template <typename Self, typename K> static auto& at_in_tables(Self& self, const K& key)
+        {
+            auto it = self.find(key);
+            if (it == self.end())
+            {
+                throw std::out_of_range("Key not found in IncrementalHashMap");
+            }
+            return it->second;
+        }
+
+        // The current table becomes the draining one. The new table is sized for twice the live
+        // entries: a full table doubles, and one that is mostly tombstones keeps its capacity
+        void start_migration()
+        {
+            finish_migration();
+            table_type next(0);
+            next.reserve(2 * m_current.size());
+            m_draining = std::exchange(m_current, std::move(next));
+            m_cursor = m_draining.begin();
+        }
+
+        void migrate_some()
+        {
+            if (!migrating())
+            {
+                return;
+            }
+
+            for (size_t moved = 0; moved < kMigrationBatch && m_cursor != m_draining.end();
+                 ++moved)
+            {
+                Entry& entry = *m_cursor;
+                m_current.try_emplace(std::move(entry.first), std::move(entry.second));
+                m_cursor = m_draining.erase(m_cursor);
+            }
+            release_drained_table();
+        }
+
+        // Erases from the draining table, moving the cursor along if it pointed at the entry
+        table_iterator erase_draining(typename table_type::const_iterator it)
+        {
+            const bool at_cursor = it == m_cursor;
+            table_iterator next = m_draining.erase(it);
+            if (at_cursor)
+            {
+                m_cursor = next;
+            }
+            return next;
+        }
+
+        void release_drained_table()
+        {
+            if (m_draining.size() == 0 && m_draining.capacity() != 0)
+            {
+                m_draining = table_type();
+                m_cursor = m_draining.end();
+            }
+        }
+
+        table_type m_current;
+        table_type m_draining;
+        // Next entry of m_draining to migrate. Every entry before it has been moved or erased
+        table_iterator m_cursor = m_draining.end();
+    };
+
+} // namespace optimap
@@ -0,0 +1,565 @@
+#pragma once
+
+#include "hashmap.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace optimap
+{
+
+    namespace detail
+    {
+        // Stable storage for values, addressed by a 32-bit index. Chunk c holds kFirstChunk << c
+        // values, so the chunk and offset of an index come from its bit width, and a value never
+        // moves once constructed. Erased cells are reused through a free list.
+        //
+        // The slab does not track which cells are live: its owner constructs and destroys values
+        // and must destroy every live one before the slab goes away.
+        template <typename Value> class ValueSlab
+        {
+            // At least 16 values or about 1 KiB in the first chunk
+            static constexpr size_t kFirstChunk =
+                    std::bit_ceil(std::max<size_t>(16, 1024 / sizeof(Value)));
+            static constexpr int kFirstChunkShift = std::countr_zero(kFirstChunk);
+
+            static constexpr size_t kMaxCells = UINT32_MAX;
+
+            struct Cell
+            {
+                alignas(Value) std::byte bytes[sizeof(Value)];
+            };
+
+          public:
+            ValueSlab() = default;
+
+            ValueSlab(const ValueSlab&) = delete;
+            ValueSlab& operator=(const ValueSlab&) = delete;
+
+            ValueSlab(ValueSlab&& other) noexcept
+                : m_chunks(std::move(other.m_chunks)), m_free(std::move(other.m_free)),
+                  m_used(std::exchange(other.m_used, 0))
+            {
+                other.m_chunks.clear();
+                other.m_free.clear();
+            }
+
+            ValueSlab& operator=(ValueSlab&& other) noexcept
+            {
+                m_chunks = std::move(other.m_chunks);
+                m_free = std::move(other.m_free);
+                m_used = std::exchange(other.m_used, 0);
+                other.m_chunks.clear();
+                other.m_free.clear();
+                return *this;
+            }
+
+            // Constructs a value in a free cell and returns the cell's index
+            template <typename... Args> uint32_t emplace(Args&&... args)
+            {
+                const uint32_t index = acquire();
+                try
+                {
+                    std::construct_at(address(index), std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    m_free.push_back(index);
+                    throw;
+                }
+                return index;
+            }
+
+            // Constructs a value in cell index, which must be allocated and neither live nor free
+            template <typename... Args> void construct_at(uint32_t index, Args&&... args)
+            {
+                std::construct_at(address(index), std::forward<Args>(args)...);
+            }
+
+            // Takes other's cell allocation and free list, with no values constructed. The owner
+            // then constructs a value in each of other's live cells, so every index keeps
+            // addressing the same value
+            void assign_cells_from(const ValueSlab& other)
+            {
+                reserve(other.m_used);
+                m_free = other.m_free;
+                m_used = other.m_used;
+            }
+
+            void erase(uint32_t index) noexcept
+            {
+                if constexpr (!std::is_trivially_destructible_v<Value>)
+                {
+                    std::destroy_at(address(index));
+                }
+                m_free.push_back(index);
+            }
+
+            Value& operator[](uint32_t index) noexcept
+            {
+                return *address(index);
+            }
+
+            const Value& operator[](uint32_t index) const noexcept
+            {
+                return *address(index);
+            }
+
+            // Forgets every cell without destroying values. The chunks are kept for reuse
+            void reset() noexcept
+            {
+                m_free.clear();
+                m_used = 0;
+            }
+
+            // Makes room for n values in total without further chunk allocations
+            void reserve(size_t n)
+            {
+                while (cells_allocated() < n)
+                {
+                    add_chunk();
+                }
+            }
+
+          private:
+            static size_t chunk_size(size_t chunk)
+            {
+                return kFirstChunk << chunk;
+            }
+
+            // Cells in chunks [0, n)
+            static size_t cells_before(size_t n)
+            {
+                return kFirstChunk * ((size_t{1} << n) - 1);
+            }
+
+            size_t cells_allocated() const
+            {
+                return cells_before(m_chunks.size());
+            }
+
+            void add_chunk()
+            {
+                m_chunks.push_back(std::make_unique<Cell[]>(chunk_size(m_chunks.size())));
+            }
+
+            uint32_t acquire()
+            {
+                if (!m_free.empty())
+                {
+                    const uint32_t index = m_free.back();
+                    m_free.pop_back();
+                    return index;
+                }
+                if (m_used == kMaxCells)
+                {
+                    throw std::length_error("IndirectHashMap holds at most 2^32 - 1 values");
+                }
+                if (m_used == cells_allocated())
+                {
+                    add_chunk();
+                }
+                return static_cast<uint32_t>(m_used++);
+            }
+
+            Value* address(uint32_t index) const noexcept
+            {
+                // Chunk c starts at kFirstChunk * (2^c - 1)
+                const size_t biased = (size_t{index} >> kFirstChunkShift) + 1;
+                const size_t chunk = std::bit_width(biased) - 1;
+                const size_t offset = index - cells_before(chunk);
+                return std::launder(reinterpret_cast<Value*>(m_chunks[chunk][offset].bytes));
+            }
+
+            std::vector<std::unique_ptr<Cell[]>> m_chunks;
+            std::vector<uint32_t> m_free;
+            size_t m_used = 0; // Cells handed out at least once since the last reset()
+        };
+    } // namespace detail
+
+    // HashMap for large mapped types. The table stores each key (and its hash, with StoreHash)
+    // next to a 32-bit index, and values live in a separate slab of stable chunks:
+    //
+    // - Probes only touch the compact key/index slots, so more candidates share a cache line
+    //   and a key comparison never drags in the value's cache lines.
+    // - Growth rehashes the keys and indices and never moves a value.
+    // - A pointer or reference to a value stays valid until its entry is erased, across any
+    //   number of insertions and rehashes. There is no need to box values in unique_ptr.
+    //
+    // The price is one extra dependent load (slot -> value) when a value is read. For values
+    // of a cache line or more that load would happen anyway, and for small values HashMap is
+    // the better choice.
+    template <typename Key, typename Value, typename Hash = GxHash<Key>, bool StoreHash = false>
+    class IndirectHashMap
+    {
+        using index_map = HashMap<Key, uint32_t, Hash, StoreHash>;
+
+      public:
+        // Pair of references to one entry, as returned by the iterators
+        template <bool IsConst> struct EntryRef
+        {
+            const Key& first;
+            std::conditional_t<IsConst, const Value&, Value&> second;
+
+            const EntryRef* operator->() const
+            {
+                return this;
+            }
+        };
+
+        template <bool IsConst> class iterator_impl
+        {
+            using map_ptr = std::conditional_t<IsConst, const IndirectHashMap*, IndirectHashMap*>;
+            using index_iterator = std::conditional_t<
+                    IsConst,
+                    typename index_map::const_iterator,
+                    typename index_map::iterator>;
+
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::pair<Key, Value>;
+            using difference_type = std::ptrdiff_t;
+            using reference = EntryRef<IsConst>;
+            using pointer = EntryRef<IsConst>;
+
+            iterator_impl() = default;
+
+            // Mutable to constant conversion
+            template <bool WasConst>
+                requires(IsConst && !WasConst)
+            iterator_impl(const iterator_impl<WasConst>& other)
+                : m_map(other.m_map), m_it(other.m_it)
+            {
+            }
+
+            reference operator*() const
+            {
+                return {m_it->first, m_map->m_values[m_it->second]};
+            }
+
+            pointer operator->() const
+            {
+                return operator*();
+            }
+
+            iterator_impl& operator++()
+            {
+                ++m_it;
+                return *this;
+            }
+
+            iterator_impl operator++(int)
+            {
+                iterator_impl tmp = *this;
+                ++m_it;
+                return tmp;
+            }
+
+            friend bool operator==(const iterator_impl& a, const iterator_impl& b)
+            {
+                return a.m_it == b.m_it;
+            }
+
+          private:
+            friend class IndirectHashMap;
+            template <bool> friend class iterator_impl;
+
+            iterator_impl(map_ptr map, index_iterator it) : m_map(map), m_it(it) {}
+
+            map_ptr m_map = nullptr;
+            index_iterator m_it;
+        };
+
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+
+        explicit IndirectHashMap(size_t capacity = 0) : m_index(capacity)
+        {
+            m_values.reserve(capacity);
+        }
+
+        // Copies the table as is and each live value into the same cell, so the copy has the
+        // same layout as the source and no key is rehashed
+        IndirectHashMap(const IndirectHashMap& other) : m_index(other.m_index)
+        {
+            m_values.assign_cells_from(other.m_values);
+            size_t constructed = 0;
+            try
+            {
+                for (const auto& entry : m_index)
+                {
+                    m_values.construct_at(entry.second, other.m_values[entry.second]);
+                    ++constructed;
+                }
+            }
+            catch (...)
+            {
+                if constexpr (!std::is_trivially_destructible_v<Value>)
+                {
+                    for (const auto& entry : m_index)
+                    {
+                        if (constructed-- == 0)
+                        {
+                            break;
+                        }
+                        std::destroy_at(&m_values[entry.second]);
+                    }
+                }
+                throw;
+            }
+        }
+
+        IndirectHashMap& operator=(const IndirectHashMap& other)
+        {
+            if (this != &other)
+            {
+                IndirectHashMap copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        IndirectHashMap(IndirectHashMap&& other) noexcept = default;
+
+        IndirectHashMap& operator=(IndirectHashMap&& other) noexcept
+        {
+            if (this != &other)
+            {
+                destroy_values();
+                m_index = std::move(other.m_index);
+                m_values = std::move(other.m_values);
+            }
+            return *this;
+        }
+
+        ~IndirectHashMap()
+        {
+            destroy_values();
+        }
+
+        // Inserts key with a Value constructed from args unless the key is already present. The
+        // value is only constructed when the insertion happens
+        template <typename K, typename... Args>
+            requires std::is_convertible_v<K&&, const Key&> ||
+                     (detail::transparent_key<Hash, Key, K> && std::is_constructible_v<Key, K&&>)
+        std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+        {
+            auto [it, inserted] = m_index.try_emplace(std::forward<K>(key), uint32_t{0});
+            if (inserted)
+            {
+                try
+                {
+                    it->second = m_values.emplace(std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    m_index.erase(it);
+                    throw;
+                }
+            }
+            return {iterator(this, it), inserted};
+        }
+
+        template <typename K, typename V> bool emplace(K&& key, V&& value)
+        {
+            return try_emplace(std::forward<K>(key), std::forward<V>(value)).second;
+        }
+
+        bool insert(const Key& key, const Value& value)
+        {
+            return emplace(key, value);
+        }
+
+        bool insert(Key&& key, Value&& value)
+        {
+            return emplace(std::move(key), std::move(value));
+        }
+
+        // Inserts key -> value, or overwrites the value if key exists. Returns true on insertion
+        template <typename V> bool insert_or_assign(const Key& key, V&& value)
+        {
+            auto [it, inserted] = try_emplace(key, std::forward<V>(value));
+            if (!inserted)
+            {
+                it->second = std::forward<V>(value);
+            }
+            return inserted;
+        }
+
+        Value& operator[](const Key& key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        iterator find(const Key& key)
+        {
+            return iterator(this, m_index.find(key));
+        }
+
+        const_iterator find(const Key& key) const
+        {
+            return const_iterator(this, m_index.find(key));
+        }
+
+        bool contains(const Key& key) const
+        {
+            return m_index.contains(key);
+        }
+
+        Value& at(const Key& key)
+        {
+            return m_values[m_index.at(key)];
+        }
+
+        const Value& at(const Key& key) const
+        {
+            return m_values[m_index.at(key)];
+        }
+
+        bool erase(const Key& key)
+        {
+            auto it = m_index.find(key);
+            if (it == m_index.end())
+            {
+                return false;
+            }
+            m_values.erase(it->second);
+            m_index.erase(it);
+            return true;
+        }
+
+        // Heterogeneous overloads, available when Hash is transparent
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        iterator find(const K& key)
+        {
+            return iterator(this, m_index.find(key));
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        const_iterator find(const K& key) const
+        {
+            return const_iterator(this, m_index.find(key));
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        bool contains(const K& key) const
+        {
+            return m_index.contains(key);
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        Value& at(const K& key)
+        {
+            return m_values[m_index.at(key)];
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        const Value& at(const K& key) const
+        {
+            return m_values[m_index.at(key)];
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        bool erase(const K& key)
+        {
+            auto it = m_index.find(key);
+            if (it == m_index.end())
+            {
+                return false;
+            }
+            m_values.erase(it->second);
+            m_index.erase(it);
+            return true;
+        }
+
+        iterator erase(iterator it)
+        {
+            if (it == end())
+            {
+                return end();
+            }
+            m_values.erase(it.m_it->second);
+            return iterator(this, m_index.erase(it.m_it));
+        }
+
+        // Destroys every value and empties the table. Table capacity and value chunks are kept
+        void clear()
+        {
+            destroy_values();
+            m_index.clear();
+        }
+
+        void reserve(size_t n)
+        {
+            m_index.reserve(n);
+            m_values.reserve(n);
+        }
+
+        size_t size() const
+        {
+            return m_index.size();
+        }
+
+        bool empty() const
+        {
+            return m_index.size() == 0;
+        }
+
+        size_t capacity() const
+        {
+            return m_index.capacity();
+        }
+
+        iterator begin()
+        {
+            return iterator(this, m_index.begin());
+        }
+
+        iterator end()
+        {
+            return iterator(this, m_index.end());
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator(this, m_index.begin());
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator(this, m_index.end());
+        }
+
+      private:
+        void destroy_values() noexcept
+        {
+            if constexpr (!std::is_trivially_destructible_v<Value>)
+            {
+                for (const auto& entry : m_index)
+                {
+                    std::destroy_at(&m_values[entry.second]);
+                }
+            }
+            m_values.reset();
+        }
+
+        index_map m_index;
+        detail::ValueSlab<Value> m_values;
+    };
+
+} // namespace optimap
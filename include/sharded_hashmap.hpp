@@ -0,0 +1,256 @@
+#pragma once
+
+#include "hashmap.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+
+namespace optimap
+{
+
+    // Thread-safe hash map built from Shards independent HashMaps, each behind its own
+    // reader-writer lock. Writers to different shards never contend, and readers of the same
+    // shard proceed in parallel.
+    //
+    // The shard is picked from the hash bits just below the 7 that HashMap uses for h2. Inside a
+    // shard, h1 takes the low bits, so the bits that pick the shard do not bias the slots or
+    // fingerprints used inside it.
+    //
+    // Each operation hashes its key once: the shard comes from HashMap::unseeded_hash and the
+    // shard's map takes that hash through its *_prehashed entry points.
+    //
+    // Lookups return copies (or run a callback under the lock) instead of iterators, since an
+    // iterator would outlive the lock that protects it.
+    template <typename Key, typename Value, typename Hash = GxHash<Key>, size_t Shards = 64>
+    class ShardedHashMap
+    {
+        static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0, "Shards must be a power of 2");
+        static_assert(Shards <= 512, "Shard bits must not overlap h1 in typical tables");
+
+      public:
+        using map_type = HashMap<Key, Value, Hash>;
+
+        ShardedHashMap() = default;
+
+        // Pre-sizes every shard for an even share of n elements
+        explicit ShardedHashMap(size_t n)
+        {
+            reserve(n);
+        }
+
+        ShardedHashMap(const ShardedHashMap&) = delete;
+        ShardedHashMap& operator=(const ShardedHashMap&) = delete;
+
+        void reserve(size_t n)
+        {
+            const size_t per_shard = (n + Shards - 1) / Shards;
+            for (auto& shard : m_shards)
+            {
+                std::unique_lock lock(shard.mutex);
+                shard.map.reserve(per_shard);
+            }
+        }
+
+        // Inserts key -> value if key is absent. Returns false if the key already exists
+        template <typename K, typename V> bool emplace(K&& key, V&& value)
+        {
+            if constexpr (std::is_same_v<std::remove_cvref_t<K>, Key>)
+            {
+                const size_t hash = map_type::unseeded_hash(key);
+                auto& shard = m_shards[shard_of_hash(hash)];
+                std::unique_lock lock(shard.mutex);
+                return shard.map
+                        .try_emplace_prehashed(std::forward<K>(key), hash, std::forward<V>(value))
+                        .second;
+            }
+            else
+            {
+                return emplace(Key(std::forward<K>(key)), std::forward<V>(value));
+            }
+        }
+
+        bool insert(const Key& key, const Value& value)
+        {
+            return emplace(key, value);
+        }
+
+        bool insert(Key&& key, Value&& value)
+        {
+            return emplace(std::move(key), std::move(value));
+        }
+
+        // Inserts key -> value, or overwrites the value if key exists. Returns true on insertion
+        template <typename V> bool insert_or_assign(const Key& key, V&& value)
+        {
+            const size_t hash = map_type::unseeded_hash(key);
+            auto& shard = m_shards[shard_of_hash(hash)];
+            std::unique_lock lock(shard.mutex);
+            auto [it, inserted] =
+                    shard.map.try_emplace_prehashed(key, hash, std::forward<V>(value));
+            if (!inserted)
+            {
+                it->second = std::forward<V>(value);
+            }
+            return inserted;
+        }
+
+        // Returns a copy of the value for key, if present
+        std::optional<Value> find(const Key& key) const
+        {
+            const size_t hash = map_type::unseeded_hash(key);
+            const auto& shard = m_shards[shard_of_hash(hash)];
+            std::shared_lock lock(shard.mutex);
+            auto it = shard.map.find_prehashed(key, hash);
+            if (it == shard.map.end())
+            {
+                return std::nullopt;
+            }
+            return it->second;
+        }
+
+        bool contains(const Key& key) const
+        {
+            const size_t hash = map_type::unseeded_hash(key);
+            const auto& shard = m_shards[shard_of_hash(hash)];
+            std::shared_lock lock(shard.mutex);
+            return shard.map.find_prehashed(key, hash) != shard.map.end();
+        }
+
+        bool erase(const Key& key)
+        {
+            const size_t hash = map_type::unseeded_hash(key);
+            auto& shard = m_shards[shard_of_hash(hash)];
+            std::unique_lock lock(shard.mutex);
+            return shard.map.erase_prehashed(key, hash);
+        }
+
+        // Runs fn(Value&) on the value for key while holding its shard's exclusive lock, so the
+        // value can be read and updated atomically. Returns false if key is absent. fn must not
+        // call back into this map
+        template <typename F> bool visit(const Key& key, F&& fn)
+        {
+            const size_t hash = map_type::unseeded_hash(key);
+            auto& shard = m_shards[shard_of_hash(hash)];
+            std::unique_lock lock(shard.mutex);
+            auto it = shard.map.find_prehashed(key, hash);
+            if (it == shard.map.end())
+            {
+                return false;
+            }
+            fn(it->second);
+            return true;
+        }
+
+        // Read-only visit under the shard's shared lock
+        template <typename F> bool visit(const Key& key, F&& fn) const
+        {
+            const size_t hash = map_type::unseeded_hash(key);
+            const auto& shard = m_shards[shard_of_hash(hash)];
+            std::shared_lock lock(shard.mutex);
+            auto it = shard.map.find_prehashed(key, hash);
+            if (it == shard.map.end())
+            {
+                return false;
+            }
+            fn(std::as_const(it->second));
+            return true;
+        }
+
+        // Calls fn(const Key&, Value&) for every entry, one shard at a time under its exclusive
+        // lock. Entries inserted into other shards concurrently may or may not be seen
+        template <typename F> void for_each(F&& fn)
+        {
+            for (auto& shard : m_shards)
+            {
+                std::unique_lock lock(shard.mutex);
+                for (auto& entry : shard.map)
+                {
+                    fn(std::as_const(entry.first), entry.second);
+                }
+            }
+        }
+
+        // Calls fn(const Key&, const Value&) for every entry under each shard's shared lock
+        template <typename F> void for_each(F&& fn) const
+        {
+            for (const auto& shard : m_shards)
+            {
+                std::shared_lock lock(shard.mutex);
+                for (const auto& entry : shard.map)
+                {
+                    fn(entry.first, entry.second);
+                }
+            }
+        }
+
+        // Sum of the shard sizes. Not a snapshot when writers are active
+        size_t size() const
+        {
+            size_t total = 0;
+            for (const auto& shard : m_shards)
+            {
+                std::shared_lock lock(shard.mutex);
+                total += shard.map.size();
+            }
+            return total;
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        void clear()
+        {
+            for (auto& shard : m_shards)
+            {
+                std::unique_lock lock(shard.mutex);
+                shard.map.clear();
+            }
+        }
+
+        static constexpr size_t shard_count() noexcept
+        {
+            return Shards;
+        }
+
+        // Index of the shard that holds key
+        static size_t shard_index(const Key& key)
+        {
+            return shard_of_hash(map_type::unseeded_hash(key));
+        }
+
+      private:
+        static constexpr int kShardBits = std::countr_zero(Shards);
+
+        // Bits [57 - kShardBits, 57) of the hash, just below h2
+        static constexpr size_t shard_of_hash(size_t hash)
+        {
+            if constexpr (Shards == 1)
+            {
+                return 0;
+            }
+            else
+            {
+                return (hash >> (sizeof(size_t) * 8 - 7 - kShardBits)) & (Shards - 1);
+            }
+        }
+
+        // Each shard is padded to its own cache lines so that taking one shard's lock does not
+        // invalidate the line holding its neighbour's
+        struct alignas(64) Shard
+        {
+            mutable std::shared_mutex mutex;
+            map_type map;
+        };
+
+        std::array<Shard, Shards> m_shards;
+    };
+
+} // namespace optimap
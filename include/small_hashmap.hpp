@@ -0,0 +1,533 @@
+#pragma once
+
+#include "hashmap.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace optimap
+{
+
+    // HashMap with room for its first InlineCapacity entries inside the object. Until the map
+    // holds more than that, nothing is allocated: entries sit in an inline array, packed at the
+    // front in insertion order (an erase moves the last entry into the hole), and a lookup
+    // checks them all at once:
+    //
+    // - Keys with a cheap equality (integers, enums, pointers) are compared directly, without
+    //   hashing.
+    // - Other keys are hashed, and one Group compare of the query's h2 against the inline
+    //   control bytes picks the entries whose key is compared.
+    //
+    // The insertion of entry InlineCapacity + 1 spills every entry into a HashMap table, which
+    // serves all operations from then on. clear() keeps that table for reuse, like
+    // HashMap::clear(). Maps that stay small never touch the allocator, so constructing,
+    // filling and destroying one costs a few stores.
+    template <
+            typename Key,
+            typename Value,
+            size_t InlineCapacity = 8,
+            typename Hash = GxHash<Key>,
+            bool StoreHash = false,
+            typename Allocator = AlignedAllocator<std::pair<const Key, Value>, 64>>
+    class SmallHashMap
+    {
+        using table_type = HashMap<Key, Value, Hash, StoreHash, Allocator>;
+
+        static_assert(InlineCapacity > 0 && InlineCapacity <= detail::kGroupWidth,
+                      "InlineCapacity must fit one control group");
+
+        static constexpr bool kLinearSearch =
+                std::is_arithmetic_v<Key> || std::is_enum_v<Key> || std::is_pointer_v<Key>;
+
+      public:
+        using Entry = typename table_type::Entry;
+
+        template <bool IsConst> class iterator_impl
+        {
+            using map_ptr = std::conditional_t<IsConst, const SmallHashMap*, SmallHashMap*>;
+            using table_iterator = std::conditional_t<
+                    IsConst,
+                    typename table_type::const_iterator,
+                    typename table_type::iterator>;
+
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Entry;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<IsConst, const Entry&, Entry&>;
+            using pointer = std::conditional_t<IsConst, const Entry*, Entry*>;
+
+            iterator_impl() = default;
+
+            // Mutable to constant conversion
+            template <bool WasConst>
+                requires(IsConst && !WasConst)
+            iterator_impl(const iterator_impl<WasConst>& other)
+                : m_map(other.m_map), m_index(other.m_index), m_it(other.m_it)
+            {
+            }
+
+            reference operator*() const
+            {
+                return m_map->m_spilled ? *m_it : m_map->m_inline[m_index].entry;
+            }
+
+            pointer operator->() const
+            {
+                return &operator*();
+            }
+
+            iterator_impl& operator++()
+            {
+                if (m_map->m_spilled)
+                {
+                    ++m_it;
+                }
+                else
+                {
+                    ++m_index;
+                }
+                return *this;
+            }
+
+            iterator_impl operator++(int)
+            {
+                iterator_impl tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+
+            friend bool operator==(const iterator_impl& a, const iterator_impl& b)
+            {
+                return a.m_map == b.m_map && a.m_index == b.m_index && a.m_it == b.m_it;
+            }
+
+          private:
+            friend class SmallHashMap;
+            template <bool> friend class iterator_impl;
+
+            iterator_impl(map_ptr map, size_t index) : m_map(map), m_index(index) {}
+            iterator_impl(map_ptr map, table_iterator it) : m_map(map), m_it(it) {}
+
+            map_ptr m_map = nullptr;
+            size_t m_index = 0;  // Inline slot, while the map has not spilled
+            table_iterator m_it; // Table position, once it has
+        };
+
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+
+        SmallHashMap() = default;
+
+        SmallHashMap(const SmallHashMap& other)
+            : m_table(other.m_table), m_spilled(other.m_spilled)
+        {
+            for (; m_inline_size < other.m_inline_size; ++m_inline_size)
+            {
+                std::construct_at(&m_inline[m_inline_size].entry,
+                                  other.m_inline[m_inline_size].entry);
+                m_inline_ctrl[m_inline_size] = other.m_inline_ctrl[m_inline_size];
+            }
+        }
+
+        SmallHashMap(SmallHashMap&& other) noexcept(std::is_nothrow_move_constructible_v<Entry>)
+            : m_table(std::move(other.m_table)), m_spilled(other.m_spilled)
+        {
+            for (; m_inline_size < other.m_inline_size; ++m_inline_size)
+            {
+                std::construct_at(&m_inline[m_inline_size].entry,
+                                  std::move(other.m_inline[m_inline_size].entry));
+                m_inline_ctrl[m_inline_size] = other.m_inline_ctrl[m_inline_size];
+            }
+            other.clear_inline();
+        }
+
+        SmallHashMap& operator=(const SmallHashMap& other)
+        {
+            if (this != &other)
+            {
+                SmallHashMap copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        SmallHashMap& operator=(SmallHashMap&& other) noexcept(
+                std::is_nothrow_move_constructible_v<Entry>
+        )
+        {
+            if (this != &other)
+            {
+                clear_inline();
+                m_table = std::move(other.m_table);
+                m_spilled = other.m_spilled;
+                for (; m_inline_size < other.m_inline_size; ++m_inline_size)
+                {
+                    std::construct_at(&m_inline[m_inline_size].entry,
+                                      std::move(other.m_inline[m_inline_size].entry));
+                    m_inline_ctrl[m_inline_size] = other.m_inline_ctrl[m_inline_size];
+                }
+                other.clear_inline();
+            }
+            return *this;
+        }
+
+        ~SmallHashMap()
+        {
+            clear_inline();
+        }
+
+        // Inserts key with a Value constructed from args unless the key is already present. The
+        // value is only constructed when the insertion happens
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+        {
+            return try_emplace_impl(key, std::forward<Args>(args)...);
+        }
+
+        template <typename... Args> std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args)
+        {
+            return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+        }
+
+        // Heterogeneous try_emplace: a Key is constructed from key only on insertion
+        template <typename K, typename... Args>
+            requires detail::transparent_key<Hash, Key, K> && std::is_constructible_v<Key, K&&>
+        std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+        {
+            return try_emplace_impl(std::forward<K>(key), std::forward<Args>(args)...);
+        }
+
+        template <typename K, typename V> std::pair<iterator, bool> emplace(K&& key, V&& value)
+        {
+            return try_emplace(std::forward<K>(key), std::forward<V>(value));
+        }
+
+        bool insert(const Key& key, const Value& value)
+        {
+            return emplace(key, value).second;
+        }
+
+        bool insert(Key&& key, Value&& value)
+        {
+            return emplace(std::move(key), std::move(value)).second;
+        }
+
+        // Inserts key -> value, or overwrites the value if key exists
+        template <typename V> std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value)
+        {
+            auto result = try_emplace(key, std::forward<V>(value));
+            if (!result.second)
+            {
+                result.first->second = std::forward<V>(value);
+            }
+            return result;
+        }
+
+        Value& operator[](const Key& key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        Value& operator[](Key&& key)
+        {
+            return try_emplace(std::move(key)).first->second;
+        }
+
+        iterator find(const Key& key)
+        {
+            return find_any<iterator>(*this, key);
+        }
+
+        const_iterator find(const Key& key) const
+        {
+            return find_any<const_iterator>(*this, key);
+        }
+
+        bool contains(const Key& key) const
+        {
+            return find(key) != end();
+        }
+
+        Value& at(const Key& key)
+        {
+            return at_any(*this, key);
+        }
+
+        const Value& at(const Key& key) const
+        {
+            return at_any(*this, key);
+        }
+
+        bool erase(const Key& key)
+        {
+            if (m_spilled)
+            {
+                return m_table.erase(key);
+            }
+            const size_t index = find_inline(key, inline_h2(key));
+            if (index == m_inline_size)
+            {
+                return false;
+            }
+            erase_inline(index);
+            return true;
+        }
+
+        // Heterogeneous overloads, available when Hash is transparent
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        iterator find(const K& key)
+        {
+            return find_any<iterator>(*this, key);
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        const_iterator find(const K& key) const
+        {
+            return find_any<const_iterator>(*this, key);
+        }
+
+        template <typename K>
+            requires detail::transparent_key<Hash, Key, K>
+        bool contains(const K& key) const
+        {
+            return find(key) != end();
+        }
+
+        // Erases the entry it points to and returns an iterator to the next one. Inline, the
+        // last entry moves into the erased slot and is visited next
+        iterator erase(const_iterator it)
+        {
+            if (it == end())
+            {
+                return end();
+            }
+            if (m_spilled)
+            {
+                return iterator(this, m_table.erase(it.m_it));
+            }
+            erase_inline(it.m_index);
+            return iterator(this, it.m_index);
+        }
+
+        iterator erase(iterator it)
+        {
+            return erase(const_iterator(it));
+        }
+
+        void clear()
+        {
+            clear_inline();
+            m_table.clear();
+        }
+
+        // Spills into a table of n entries right away when n exceeds the inline capacity
+        void reserve(size_t n)
+        {
+            if (m_spilled)
+            {
+                m_table.reserve(n);
+            }
+            else if (n > InlineCapacity)
+            {
+                spill(n);
+            }
+        }
+
+        size_t size() const
+        {
+            return m_spilled ? m_table.size() : m_inline_size;
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        size_t capacity() const
+        {
+            return m_spilled ? m_table.capacity() : InlineCapacity;
+        }
+
+        // True once the entries live in a heap table
+        bool spilled() const
+        {
+            return m_spilled;
+        }
+
+        iterator begin()
+        {
+            return m_spilled ? iterator(this, m_table.begin()) : iterator(this, size_t{0});
+        }
+
+        iterator end()
+        {
+            return m_spilled ? iterator(this, m_table.end()) : iterator(this, m_inline_size);
+        }
+
+        const_iterator begin() const
+        {
+            return m_spilled ? const_iterator(this, m_table.begin())
+                             : const_iterator(this, size_t{0});
+        }
+
+        const_iterator end() const
+        {
+            return m_spilled ? const_iterator(this, m_table.end())
+                             : const_iterator(this, m_inline_size);
+        }
+
+      private:
+        // Lets the inline array hold entries without constructing them up front
+        union InlineSlot
+        {
+            InlineSlot() {}
+            ~InlineSlot() {}
+
+            Entry entry;
+        };
+
+        // Shared by the try_emplace overloads. Non-transparent keys arrive here already converted
+        // to Key, so the inline search hashes and compares the stored key type
+        template <typename K, typename... Args>
+        std::pair<iterator, bool> try_emplace_impl(K&& key, Args&&... args)
+        {
+            if (!m_spilled)
+            {
+                const int8_t hash2_val = inline_h2(key);
+                const size_t index = find_inline(key, hash2_val);
+                if (index != m_inline_size)
+                {
+                    return {iterator(this, index), false};
+                }
+                if (m_inline_size < InlineCapacity) [[likely]]
+                {
+                    std::construct_at(
+                            &m_inline[m_inline_size].entry,
+                            Entry{Key(std::forward<K>(key)), Value(std::forward<Args>(args)...)}
+                    );
+                    m_inline_ctrl[m_inline_size] = hash2_val;
+                    return {iterator(this, m_inline_size++), true};
+                }
+                spill(InlineCapacity + 1);
+            }
+
+            auto [it, inserted] =
+                    m_table.try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+            return {iterator(this, it), inserted};
+        }
+
+        template <typename K> static int8_t inline_h2(const K& key)
+        {
+            if constexpr (kLinearSearch)
+            {
+                return 0;
+            }
+            else
+            {
+                return detail::h2_of(Hash{}(key));
+            }
+        }
+
+        // Index of the inline entry equal to key, or m_inline_size
+        template <typename K> size_t find_inline(const K& key, int8_t hash2_val) const
+        {
+            if constexpr (kLinearSearch)
+            {
+                for (size_t index = 0; index < m_inline_size; ++index)
+                {
+                    if (m_inline[index].entry.first == key)
+                    {
+                        return index;
+                    }
+                }
+            }
+            else
+            {
+                // Unused control bytes are kEmpty, which no h2 matches
+                const detail::Group group(m_inline_ctrl);
+                for (auto match = group.match_h2(hash2_val); match; match.advance())
+                {
+                    const size_t index = match.next();
+                    if (m_inline[index].entry.first == key)
+                    {
+                        return index;
+                    }
+                }
+            }
+            return m_inline_size;
+        }
+
+        template <typename Iterator, typename Self, typename K>
+        static Iterator find_any(Self& self, const K& key)
+        {
+            if (self.m_spilled)
+            {
+                return Iterator(&self, self.m_table.find(key));
+            }
+            return Iterator(&self, self.find_inline(key, inline_h2(key)));
+        }
+
+        template <typename Self, typename K> static auto& at_any(Self& self, const K& key)
+        {
+            auto it = self.find(key);
+            if (it == self.end())
+            {
+                throw std::out_of_range("Key not found in SmallHashMap");
+            }
+            return it->second;
+        }
+
+        void erase_inline(size_t index)
+        {
+            const size_t last = m_inline_size - 1;
+            if (index != last)
+            {
+                m_inline[index].entry = std::move(m_inline[last].entry);
+                m_inline_ctrl[index] = m_inline_ctrl[last];
+            }
+            std::destroy_at(&m_inline[last].entry);
+            m_inline_ctrl[last] = detail::kEmpty;
+            m_inline_size = last;
+        }
+
+        void clear_inline() noexcept
+        {
+            for (size_t index = 0; index < m_inline_size; ++index)
+            {
+                std::destroy_at(&m_inline[index].entry);
+                m_inline_ctrl[index] = detail::kEmpty;
+            }
+            m_inline_size = 0;
+        }
+
+        // Moves the inline entries into a table sized for n entries
+        void spill(size_t n)
+        {
+            m_table.reserve(n);
+            for (size_t index = 0; index < m_inline_size; ++index)
+            {
+                Entry& entry = m_inline[index].entry;
+                m_table.try_emplace(std::move(entry.first), std::move(entry.second));
+            }
+            clear_inline();
+            m_spilled = true;
+        }
+
+        table_type m_table;
+        InlineSlot m_inline[InlineCapacity];
+        // h2 of each inline entry, kEmpty past the last. One group wide so that lookups load it
+        // with a single Group
+        alignas(detail::kGroupWidth) int8_t m_inline_ctrl[detail::kGroupWidth] = {};
+        uint8_t m_inline_size = 0;
+        bool m_spilled = false;
+    };
+
+} // namespace optimap
@@ -0,0 +1,448 @@
+#pragma once
+
+#include "hashmap.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace optimap
+{
+
+    namespace detail
+    {
+        // Bump allocator for key bytes. Strings are copied back to back into chunks that never
+        // move, so a stored pointer stays valid until clear() or destruction, which free every
+        // chunk at once. Nothing is freed per string.
+        class StringArena
+        {
+            static constexpr size_t kMinChunkSize = size_t{4} << 10;
+            static constexpr size_t kMaxChunkSize = size_t{1} << 20;
+
+          public:
+            StringArena() = default;
+
+            StringArena(const StringArena&) = delete;
+            StringArena& operator=(const StringArena&) = delete;
+
+            StringArena(StringArena&& other) noexcept
+                : m_chunks(std::move(other.m_chunks)),
+                  m_cursor(std::exchange(other.m_cursor, nullptr)),
+                  m_end(std::exchange(other.m_end, nullptr)),
+                  m_next_chunk_size(std::exchange(other.m_next_chunk_size, kMinChunkSize)),
+                  m_bytes_used(std::exchange(other.m_bytes_used, 0)),
+                  m_bytes_reserved(std::exchange(other.m_bytes_reserved, 0))
+            {
+                other.m_chunks.clear();
+            }
+
+            StringArena& operator=(StringArena&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    clear();
+                    std::swap(m_chunks, other.m_chunks);
+                    std::swap(m_cursor, other.m_cursor);
+                    std::swap(m_end, other.m_end);
+                    std::swap(m_next_chunk_size, other.m_next_chunk_size);
+                    std::swap(m_bytes_used, other.m_bytes_used);
+                    std::swap(m_bytes_reserved, other.m_bytes_reserved);
+                }
+                return *this;
+            }
+
+            // Copies text into the arena and returns the address of the copy. No terminator is
+            // appended. Empty strings get a non-null address, since some hashers treat a null
+            // empty view differently from any other empty view
+            const char* store(std::string_view text)
+            {
+                const size_t length = text.size();
+                if (length == 0)
+                {
+                    return "";
+                }
+
+                char* dest;
+                if (length > static_cast<size_t>(m_end - m_cursor))
+                {
+                    dest = allocate_chunk(length);
+                }
+                else
+                {
+                    dest = m_cursor;
+                    m_cursor += length;
+                }
+
+                std::memcpy(dest, text.data(), length);
+                m_bytes_used += length;
+                return dest;
+            }
+
+            void clear() noexcept
+            {
+                m_chunks.clear();
+                m_cursor = nullptr;
+                m_end = nullptr;
+                m_next_chunk_size = kMinChunkSize;
+                m_bytes_used = 0;
+                m_bytes_reserved = 0;
+            }
+
+            // Bytes of every string stored since the last clear(), erased ones included
+            size_t bytes_used() const noexcept
+            {
+                return m_bytes_used;
+            }
+
+            // Bytes held in chunks
+            size_t bytes_reserved() const noexcept
+            {
+                return m_bytes_reserved;
+            }
+
+          private:
+            // Chunks double up to 1 MiB. A string too large for a quarter of the next chunk gets
+            // a chunk of its own, so the current chunk keeps its free space
+            char* allocate_chunk(size_t length)
+            {
+                if (length > m_next_chunk_size / 4)
+                {
+                    m_chunks.push_back(std::make_unique_for_overwrite<char[]>(length));
+                    m_bytes_reserved += length;
+                    return m_chunks.back().get();
+                }
+
+                const size_t chunk_size = m_next_chunk_size;
+                m_next_chunk_size = std::min(chunk_size * 2, kMaxChunkSize);
+                m_chunks.push_back(std::make_unique_for_overwrite<char[]>(chunk_size));
+                m_bytes_reserved += chunk_size;
+
+                char* chunk = m_chunks.back().get();
+                m_cursor = chunk + length;
+                m_end = chunk + chunk_size;
+                return chunk;
+            }
+
+            std::vector<std::unique_ptr<char[]>> m_chunks;
+            char* m_cursor = nullptr;
+            char* m_end = nullptr;
+            size_t m_next_chunk_size = kMinChunkSize;
+            size_t m_bytes_used = 0;
+            size_t m_bytes_reserved = 0;
+        };
+
+        // First four bytes of a string, zero-padded, as one word
+        inline uint32_t string_prefix(std::string_view text)
+        {
+            uint32_t prefix = 0;
+            if (text.empty())
+            {
+                return prefix;
+            }
+            std::memcpy(&prefix, text.data(), std::min<size_t>(text.size(), sizeof(prefix)));
+            return prefix;
+        }
+
+        // A string being looked up or inserted, with its prefix computed once per operation.
+        // Converting it to an ArenaKey copies the bytes into arena, which only happens when the
+        // key is actually inserted
+        struct StringKeyRef
+        {
+            StringKeyRef(std::string_view text, StringArena* arena = nullptr)
+                : text(text), prefix(string_prefix(text)), arena(arena)
+            {
+            }
+
+            std::string_view text;
+            uint32_t prefix;
+            StringArena* arena;
+        };
+
+        // Key stored in a StringHashMap slot: a pointer to the bytes in the map's arena, the
+        // length and the first four bytes inline. Comparing against a query checks the length
+        // and prefix before touching the arena, and strings of up to four bytes are compared
+        // without touching it at all. 16 bytes, against 32 for a std::string
+        class ArenaKey
+        {
+          public:
+            ArenaKey() = default;
+
+            explicit ArenaKey(const StringKeyRef& ref)
+                : m_data(ref.arena->store(checked_text(ref.text))),
+                  m_size(static_cast<uint32_t>(ref.text.size())), m_prefix(ref.prefix)
+            {
+            }
+
+            std::string_view view() const noexcept
+            {
+                return {m_data, m_size};
+            }
+
+            operator std::string_view() const noexcept
+            {
+                return view();
+            }
+
+            size_t size() const noexcept
+            {
+                return m_size;
+            }
+
+            friend bool operator==(const ArenaKey& key, const StringKeyRef& query) noexcept
+            {
+                if (key.m_size != query.text.size() || key.m_prefix != query.prefix)
+                {
+                    return false;
+                }
+                return key.m_size <= sizeof(key.m_prefix) ||
+                       std::memcmp(
+                               key.m_data + sizeof(key.m_prefix),
+                               query.text.data() + sizeof(key.m_prefix),
+                               key.m_size - sizeof(key.m_prefix)
+                       ) == 0;
+            }
+
+            friend bool operator==(const ArenaKey& a, const ArenaKey& b) noexcept
+            {
+                return a.view() == b.view();
+            }
+
+          private:
+            static std::string_view checked_text(std::string_view text)
+            {
+                if (text.size() > UINT32_MAX)
+                {
+                    throw std::length_error("StringHashMap keys are limited to 4 GiB");
+                }
+                return text;
+            }
+
+            const char* m_data = nullptr;
+            uint32_t m_size = 0;
+            uint32_t m_prefix = 0;
+        };
+
+        // Hashes stored keys and queries by their characters with the user's string hasher
+        template <typename Hash> struct ArenaKeyHash
+        {
+            using is_transparent = void;
+
+            size_t operator()(const ArenaKey& key) const noexcept
+            {
+                return Hash{}(key.view());
+            }
+
+            size_t operator()(const StringKeyRef& query) const noexcept
+            {
+                return Hash{}(query.text);
+            }
+        };
+    } // namespace detail
+
+    // HashMap for string keys whose bytes live out of line, in a bump arena owned by the map.
+    // A slot holds only a pointer into the arena, the length and a four-byte inline prefix
+    // (16 bytes instead of a 32-byte std::string plus its own heap block), so more slots fit
+    // per cache line and most mismatches are rejected without reading the key bytes.
+    //
+    // Keys are taken and returned as std::string_view; std::string and const char* convert
+    // implicitly. Entries expose the key as an ArenaKey, which converts to std::string_view.
+    //
+    // Key bytes are not reclaimed on erase: the arena only grows until clear() or destruction,
+    // which free it in bulk. This suits caches that are filled, read and dropped as a whole;
+    // with heavy churn, arena_bytes() keeps growing and the map should be rebuilt or cleared.
+    //
+    //     optimap::StringHashMap<uint64_t> hits;
+    //     ++hits[url];
+    template <typename Value, typename Hash = GxHash<std::string_view>, bool StoreHash = false>
+    class StringHashMap
+    {
+      public:
+        using key_type = detail::ArenaKey;
+        using map_type = HashMap<key_type, Value, detail::ArenaKeyHash<Hash>, StoreHash>;
+        using iterator = typename map_type::iterator;
+        using const_iterator = typename map_type::const_iterator;
+
+        explicit StringHashMap(size_t capacity = 0) : m_map(capacity) {}
+
+        // Copies re-store every key in the new map's arena. Entry memory cannot be copied
+        // verbatim since the keys point into the source arena
+        StringHashMap(const StringHashMap& other) : m_map(other.size())
+        {
+            for (const auto& entry : other)
+            {
+                try_emplace(entry.first.view(), entry.second);
+            }
+        }
+
+        StringHashMap& operator=(const StringHashMap& other)
+        {
+            if (this != &other)
+            {
+                StringHashMap copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        // The arena's chunks never move, so moving the map keeps every key pointer valid
+        StringHashMap(StringHashMap&&) noexcept = default;
+
+        StringHashMap& operator=(StringHashMap&& other) noexcept
+        {
+            if (this != &other)
+            {
+                // The entries must go before the arena their keys point into
+                m_map = std::move(other.m_map);
+                m_arena = std::move(other.m_arena);
+            }
+            return *this;
+        }
+
+        // Inserts key with a Value constructed from args unless the key is present. The key bytes
+        // are copied into the arena only when the insertion happens
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(std::string_view key, Args&&... args)
+        {
+            return m_map.try_emplace(
+                    detail::StringKeyRef(key, &m_arena), std::forward<Args>(args)...
+            );
+        }
+
+        template <typename V> bool emplace(std::string_view key, V&& value)
+        {
+            return try_emplace(key, std::forward<V>(value)).second;
+        }
+
+        bool insert(std::string_view key, const Value& value)
+        {
+            return emplace(key, value);
+        }
+
+        bool insert(std::string_view key, Value&& value)
+        {
+            return emplace(key, std::move(value));
+        }
+
+        // Inserts key -> value, or overwrites the value if key exists. Returns true on insertion
+        template <typename V> bool insert_or_assign(std::string_view key, V&& value)
+        {
+            auto [it, inserted] = try_emplace(key, std::forward<V>(value));
+            if (!inserted)
+            {
+                it->second = std::forward<V>(value);
+            }
+            return inserted;
+        }
+
+        Value& operator[](std::string_view key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        iterator find(std::string_view key)
+        {
+            return m_map.find(detail::StringKeyRef(key));
+        }
+
+        const_iterator find(std::string_view key) const
+        {
+            return m_map.find(detail::StringKeyRef(key));
+        }
+
+        bool contains(std::string_view key) const
+        {
+            return m_map.contains(detail::StringKeyRef(key));
+        }
+
+        Value& at(std::string_view key)
+        {
+            return m_map.at(detail::StringKeyRef(key));
+        }
+
+        const Value& at(std::string_view key) const
+        {
+            return m_map.at(detail::StringKeyRef(key));
+        }
+
+        // Removes the entry. Its key bytes stay in the arena until clear()
+        bool erase(std::string_view key)
+        {
+            return m_map.erase(detail::StringKeyRef(key));
+        }
+
+        iterator erase(iterator it)
+        {
+            return m_map.erase(it);
+        }
+
+        // Removes every entry and frees the arena in one go. The table keeps its capacity
+        void clear()
+        {
+            m_map.clear();
+            m_arena.clear();
+        }
+
+        void reserve(size_t n)
+        {
+            m_map.reserve(n);
+        }
+
+        size_t size() const
+        {
+            return m_map.size();
+        }
+
+        bool empty() const
+        {
+            return m_map.size() == 0;
+        }
+
+        size_t capacity() const
+        {
+            return m_map.capacity();
+        }
+
+        // Bytes of key data stored in the arena, including keys erased since the last clear()
+        size_t arena_bytes() const noexcept
+        {
+            return m_arena.bytes_used();
+        }
+
+        // Bytes the arena has allocated, at least arena_bytes()
+        size_t arena_capacity() const noexcept
+        {
+            return m_arena.bytes_reserved();
+        }
+
+        iterator begin()
+        {
+            return m_map.begin();
+        }
+
+        iterator end()
+        {
+            return m_map.end();
+        }
+
+        const_iterator begin() const
+        {
+            return m_map.begin();
+        }
+
+        const_iterator end() const
+        {
+            return m_map.end();
+        }
+
+      private:
+        // Declared first so it outlives the entries pointing into it
+        detail::StringArena m_arena;
+        map_type m_map;
+    };
+
+} // namespace optimap
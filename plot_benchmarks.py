@@ -1,180 +1,127 @@
+import argparse
+import glob
+import json
 import os
+import re
 
 import matplotlib.pyplot as plt
 import polars as pl
 import seaborn as sns
 
-# Open the plots:
+# Plots the google-benchmark JSON output of OptiMapMapBenchmarks (see run_map_benchmarks.py):
+# one performance and one memory plot per scenario, averaged over the files and repetitions.
 # ```shell
-# open analysis/plots
+# python3 plot_benchmarks.py benchmark_results/*.json
 # ```
 
-
-def main():
-    # Create a directory to save the plots
-    output_dir = "analysis/plots"
-    os.makedirs(output_dir, exist_ok=True)
-
-    # Define the schema for the data
-    schema = {
-        "map_name": pl.Utf8,
-        "hash_name": pl.Utf8,
-        "benchmark": pl.Utf8,
-        "test_num": pl.Utf8,
-        "test_name": pl.Utf8,
-        "num_operations": pl.Utf8,  # Read as string to handle errors
-        "nanoseconds_per_op": pl.Utf8,  # Read as string to handle errors
-        "memory_usage_mb": pl.Utf8,  # Read as string to handle errors
-    }
-
-    # Read the data file line by line to handle errors
-    with open("data/all_new.txt", "r") as f:
-        lines = f.readlines()
-
-    # Filter out error lines
-    lines = [line for line in lines if "ERROR" not in line and "TIMEOUT" not in line]
-
-    # Create a new cleaned data file
-    cleaned_data_path = "data/all_new_cleaned.txt"
-    with open(cleaned_data_path, "w") as f:
-        f.writelines(lines)
-
-    # Read and clean the data
-    try:
-        df = pl.read_csv(
-            cleaned_data_path,
-            separator=";",
-            has_header=False,
-            new_columns=list(schema.keys()),
-            schema_overrides=schema,
-            ignore_errors=True,
-        )
-    except Exception as e:
-        print(f"Error reading the data file: {e}")
-        return
-
-    # Convert columns to numeric, coercing errors to null
-    df = df.with_columns(
-        [
-            pl.col("num_operations").str.strip_chars().cast(pl.Int64, strict=False),
-            pl.col("nanoseconds_per_op")
-            .str.strip_chars()
-            .cast(pl.Float64, strict=False),
-            pl.col("memory_usage_mb").str.strip_chars().cast(pl.Float64, strict=False),
-        ]
+# Time units google-benchmark may report real_time in
+NANOSECONDS_PER_UNIT = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+# "Copy<map_benchmark::OptiMap>/iterations:1" or "StringFind<map_benchmark::OptiMap>/8/..."
+NAME_PATTERN = re.compile(r"^(?P<scenario>[^<]+)<[^>]+>(?P<args>(/\d+)*)")
+
+
+def read_runs(paths):
+    rows = []
+    for path in paths:
+        with open(path, "r") as f:
+            data = json.load(f)
+
+        for run in data.get("benchmarks", []):
+            # Aggregates (mean, median, stddev) are recomputed here from the plain runs
+            if run.get("run_type") == "aggregate" or run.get("error_occurred"):
+                continue
+            match = NAME_PATTERN.match(run["name"])
+            if not match or "operations" not in run or "label" not in run:
+                continue
+
+            benchmark = match.group("scenario") + match.group("args").replace("/", "_")
+            nanoseconds = run["real_time"] * NANOSECONDS_PER_UNIT[run["time_unit"]]
+            rows.append(
+                {
+                    "benchmark": benchmark,
+                    "map_with_hash": run["label"],
+                    "nanoseconds_per_op": nanoseconds / max(run["operations"], 1),
+                    "memory_usage_mb": run["peak_bytes"] / (1024 * 1024),
+                    "bytes_per_element": run["bytes_per_element"],
+                }
+            )
+    return pl.DataFrame(rows)
+
+
+def bar_plot(bench_df, column, palette, title, xlabel, plot_path):
+    plt.figure(figsize=(12, 8))
+
+    agg_df = (
+        bench_df.group_by("map_with_hash")
+        .agg(pl.mean(column).alias(column))
+        .sort(column)
     )
 
-    # Clean up map and hash names by removing quotes and stripping whitespace
-    df = df.with_columns(
-        [
-            pl.col("map_name")
-            .str.replace_all('"', "")
-            .str.strip_chars()
-            .alias("map_name"),
-            pl.col("hash_name")
-            .str.replace_all('"', "")
-            .str.strip_chars()
-            .alias("hash_name"),
-            pl.col("benchmark")
-            .str.replace_all('"', "")
-            .str.strip_chars()
-            .alias("benchmark"),
-        ]
+    sns.barplot(
+        x=column,
+        y="map_with_hash",
+        data=agg_df.to_pandas(),
+        palette=palette,
     )
 
-    # Create a combined column for easier plotting
-    df = df.with_columns(
-        (pl.col("map_name") + " (" + pl.col("hash_name") + ")").alias("map_with_hash")
-    )
+    plt.title(title)
+    plt.xlabel(xlabel)
+    plt.ylabel("Map Type and Hash Function")
+    plt.tight_layout()
 
-    benchmarks = [
-        "Copy",
-        "CtorDtorEmptyMap",
-        "CtorDtorSingleEntryMap",
-        "InsertHugeInt",
-        "IterateIntegers",
-        "RandomDistinct2",
-        "RandomFind_200",
-        "RandomFind_2000",
-        "RandomFind_500000",
-        "RandomFindString",
-        "RandomFindString_1000000",
-        "RandomInsertErase",
-        "RandomInsertEraseStrings",
-    ]
-
-    for bench in benchmarks:
-        print(f"Generating plot for {bench}...")
-        bench_df = df.filter(pl.col("benchmark") == bench)
-
-        if bench_df.height == 0:
-            print(f"No data found for benchmark: {bench}")
-            continue
+    ax = plt.gca()
+    for label in ax.get_yticklabels():
+        if "optimap::HashMap" in label.get_text():
+            label.set_weight("bold")
 
-        plt.figure(figsize=(12, 8))
+    plt.savefig(plot_path)
+    plt.close()
+    print(f"Saved plot to {plot_path}")
 
-        # --- Performance Plot ---
-        plt.figure(figsize=(12, 8))
 
-        agg_df_perf = (
-            bench_df.group_by("map_with_hash")
-            .agg(pl.mean("nanoseconds_per_op").alias("mean_nanoseconds_per_op"))
-            .sort("mean_nanoseconds_per_op")
-        )
-
-        sns.barplot(
-            x="mean_nanoseconds_per_op",
-            y="map_with_hash",
-            data=agg_df_perf.to_pandas(),
-            palette="viridis",
-        )
-
-        plt.title(f"Performance Comparison for {bench}")
-        plt.xlabel("Mean Nanoseconds per Operation (lower is better)")
-        plt.ylabel("Map Type and Hash Function")
-        plt.tight_layout()
+def main():
+    parser = argparse.ArgumentParser(description="Plot OptiMapMapBenchmarks JSON results")
+    parser.add_argument(
+        "files",
+        nargs="*",
+        help="google-benchmark JSON files (default: benchmark_results/*.json)",
+    )
+    parser.add_argument("--output-dir", default="plots")
+    args = parser.parse_args()
 
-        ax = plt.gca()
-        for label in ax.get_yticklabels():
-            if "optimap::HashMap" in label.get_text():
-                label.set_weight("bold")
+    paths = args.files or sorted(glob.glob("benchmark_results/*.json"))
+    if not paths:
+        print("No benchmark JSON files given or found in benchmark_results/")
+        return
 
-        plot_path = os.path.join(output_dir, f"{bench}_performance.png")
-        plt.savefig(plot_path)
-        plt.close()
-        print(f"Saved plot to {plot_path}")
+    df = read_runs(paths)
+    if df.height == 0:
+        print("No map benchmark runs found in " + ", ".join(paths))
+        return
 
-        # --- Memory Usage Plot ---
-        plt.figure(figsize=(12, 8))
+    os.makedirs(args.output_dir, exist_ok=True)
+    for bench in sorted(df["benchmark"].unique().to_list()):
+        print(f"Generating plots for {bench}...")
+        bench_df = df.filter(pl.col("benchmark") == bench)
 
-        agg_df_mem = (
-            bench_df.group_by("map_with_hash")
-            .agg(pl.mean("memory_usage_mb").alias("mean_memory_usage_mb"))
-            .sort("mean_memory_usage_mb")
+        bar_plot(
+            bench_df,
+            "nanoseconds_per_op",
+            "viridis",
+            f"Performance Comparison for {bench}",
+            "Mean Nanoseconds per Operation (lower is better)",
+            os.path.join(args.output_dir, f"{bench}_performance.png"),
         )
-
-        sns.barplot(
-            x="mean_memory_usage_mb",
-            y="map_with_hash",
-            data=agg_df_mem.to_pandas(),
-            palette="plasma",
+        bar_plot(
+            bench_df,
+            "memory_usage_mb",
+            "plasma",
+            f"Memory Usage for {bench}",
+            "Mean Peak Memory Usage (MB)",
+            os.path.join(args.output_dir, f"{bench}_memory.png"),
         )
 
-        plt.title(f"Memory Usage for {bench}")
-        plt.xlabel("Mean Memory Usage (MB)")
-        plt.ylabel("Map Type and Hash Function")
-        plt.tight_layout()
-
-        ax = plt.gca()
-        for label in ax.get_yticklabels():
-            if "optimap::HashMap" in label.get_text():
-                label.set_weight("bold")
-
-        plot_path = os.path.join(output_dir, f"{bench}_memory.png")
-        plt.savefig(plot_path)
-        plt.close()
-        print(f"Saved plot to {plot_path}")
-
 
 if __name__ == "__main__":
     main()
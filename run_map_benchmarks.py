@@ -0,0 +1,73 @@
+import argparse
+import os
+import platform
+import subprocess
+import sys
+
+# Builds OptiMapMapBenchmarks in release mode, runs it with JSON output and plots the results.
+# Works the same on Linux, macOS and Windows, so CI can reproduce the published plots:
+# ```shell
+# python3 run_map_benchmarks.py --repetitions 5
+# python3 run_map_benchmarks.py --filter "Copy|CtorDtor" --no-plot
+# ```
+
+TARGET = "OptiMapMapBenchmarks"
+
+
+def find_executable(build_dir):
+    name = TARGET + (".exe" if platform.system() == "Windows" else "")
+    # Single-config generators put the binary in the build directory, multi-config ones
+    # (Visual Studio, Xcode) in a per-configuration subdirectory
+    for candidate in (
+        os.path.join(build_dir, name),
+        os.path.join(build_dir, "Release", name),
+    ):
+        if os.path.isfile(candidate):
+            return candidate
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Run the map_benchmark scenarios")
+    parser.add_argument("--build-dir", default="build")
+    parser.add_argument("--results-dir", default="benchmark_results")
+    parser.add_argument("--filter", default=".", help="google-benchmark filter regex")
+    parser.add_argument("--repetitions", type=int, default=1)
+    parser.add_argument("--no-build", action="store_true", help="use the existing binary")
+    parser.add_argument("--no-plot", action="store_true", help="skip plot_benchmarks.py")
+    args = parser.parse_args()
+
+    if not args.no_build:
+        subprocess.run(
+            ["cmake", "-S", ".", "-B", args.build_dir, "-DCMAKE_BUILD_TYPE=Release"],
+            check=True,
+        )
+        subprocess.run(
+            ["cmake", "--build", args.build_dir, "--config", "Release", "--target", TARGET],
+            check=True,
+        )
+
+    executable = find_executable(args.build_dir)
+    if executable is None:
+        sys.exit(f"{TARGET} not found in {args.build_dir}. Is Source/abseil-cpp present?")
+
+    os.makedirs(args.results_dir, exist_ok=True)
+    output = os.path.join(args.results_dir, "map_benchmark.json")
+    subprocess.run(
+        [
+            executable,
+            f"--benchmark_filter={args.filter}",
+            f"--benchmark_repetitions={args.repetitions}",
+            f"--benchmark_out={output}",
+            "--benchmark_out_format=json",
+        ],
+        check=True,
+    )
+    print(f"Results saved to {output}")
+
+    if not args.no_plot:
+        subprocess.run([sys.executable, "plot_benchmarks.py", output], check=True)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,181 @@
+#include "hashmap.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Memory resource that records every request and forwards it upstream
+class CountingResource : public std::pmr::memory_resource
+{
+  public:
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t live_bytes = 0;
+    size_t min_alignment = SIZE_MAX;
+
+  private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        ++allocations;
+        live_bytes += bytes;
+        min_alignment = std::min(min_alignment, alignment);
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        ++deallocations;
+        live_bytes -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+// Stateful allocator tagged with an id; copies propagate on every container operation
+template <typename T> struct TaggedAllocator
+{
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+
+    int id = 0;
+
+    TaggedAllocator() = default;
+    explicit TaggedAllocator(int tag) : id(tag) {}
+    template <typename U> TaggedAllocator(const TaggedAllocator<U>& other) : id(other.id) {}
+
+    T* allocate(size_t n)
+    {
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U> bool operator==(const TaggedAllocator<U>& other) const
+    {
+        return id == other.id;
+    }
+};
+
+TEST(AllocatorTest, PmrMapAllocatesFromResource)
+{
+    CountingResource resource;
+    {
+        optimap::pmr::HashMap<int, std::string> map(&resource);
+        EXPECT_EQ(map.get_allocator().resource(), &resource);
+        for (int i = 0; i < 10000; ++i)
+        {
+            map.insert(i, std::to_string(i));
+        }
+        EXPECT_EQ(map.at(1234), "1234");
+        EXPECT_GT(resource.allocations, 1);
+        EXPECT_GT(resource.live_bytes, map.capacity());
+    }
+
+    // Every table, including the ones replaced by growth, went back to the resource
+    EXPECT_EQ(resource.allocations, resource.deallocations);
+    EXPECT_EQ(resource.live_bytes, 0);
+    EXPECT_GE(resource.min_alignment, 64);
+}
+
+TEST(AllocatorTest, PmrMapInMonotonicArena)
+{
+    std::vector<std::byte> buffer(1 << 20);
+    std::pmr::monotonic_buffer_resource arena(
+            buffer.data(),
+            buffer.size(),
+            std::pmr::null_memory_resource()
+    );
+
+    optimap::pmr::HashMap<uint64_t, uint64_t> map(&arena);
+    map.reserve(1000);
+    for (uint64_t i = 0; i < 1000; ++i)
+    {
+        map.emplace(i, i * i);
+    }
+    for (uint64_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(map.at(i), i * i);
+    }
+}
+
+TEST(AllocatorTest, PmrCopyAndMoveFollowContainerRules)
+{
+    CountingResource first;
+    CountingResource second;
+    optimap::pmr::HashMap<int, int> map(&first);
+    for (int i = 0; i < 100; ++i)
+    {
+        map.insert(i, -i);
+    }
+
+    // Plain copies use the default resource; the extended constructor takes one explicitly
+    optimap::pmr::HashMap<int, int> copy(map);
+    EXPECT_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+    optimap::pmr::HashMap<int, int> copy_in_second(map, &second);
+    EXPECT_EQ(copy_in_second.get_allocator().resource(), &second);
+    EXPECT_EQ(copy_in_second.at(42), -42);
+
+    // polymorphic_allocator does not propagate on move assignment, so entries are moved one by
+    // one into a table owned by the target's resource
+    optimap::pmr::HashMap<int, int> target(&second);
+    target = std::move(map);
+    EXPECT_EQ(target.get_allocator().resource(), &second);
+    EXPECT_EQ(target.size(), 100);
+    EXPECT_EQ(target.at(99), -99);
+    EXPECT_EQ(first.live_bytes, 0);
+
+    // Same resource: the table is taken over without allocating
+    const size_t allocations = second.allocations;
+    optimap::pmr::HashMap<int, int> moved(std::move(target), &second);
+    EXPECT_EQ(second.allocations, allocations);
+    EXPECT_EQ(moved.at(7), -7);
+}
+
+TEST(AllocatorTest, StatefulAllocatorPropagates)
+{
+    using Map = optimap::HashMap<
+            int,
+            int,
+            optimap::GxHash<int>,
+            false,
+            TaggedAllocator<std::pair<const int, int>>>;
+
+    Map map(16, TaggedAllocator<std::pair<const int, int>>(1));
+    map.insert(1, 1);
+    Map other(TaggedAllocator<std::pair<const int, int>>(2));
+
+    other = map;
+    EXPECT_EQ(other.get_allocator().id, 1);
+    EXPECT_EQ(other.at(1), 1);
+
+    Map moved(TaggedAllocator<std::pair<const int, int>>(3));
+    moved = std::move(other);
+    EXPECT_EQ(moved.get_allocator().id, 1);
+    EXPECT_EQ(moved.at(1), 1);
+}
+
+TEST(AllocatorTest, FromRangeUsesAllocator)
+{
+    CountingResource resource;
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < 1000; ++i)
+    {
+        pairs.emplace_back(i, i);
+    }
+
+    auto map = optimap::pmr::HashMap<int, int>::from_range(pairs, 2, &resource);
+    EXPECT_EQ(map.size(), 1000);
+    EXPECT_EQ(map.get_allocator().resource(), &resource);
+    EXPECT_EQ(resource.allocations, 1);
+}
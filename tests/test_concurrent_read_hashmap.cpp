@@ -0,0 +1,153 @@
+#include "concurrent_read_hashmap.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+TEST(ConcurrentReadHashMapTest, BasicOperations)
+{
+    optimap::ConcurrentReadHashMap<int, int> map;
+    EXPECT_EQ(map.find(1), std::nullopt);
+    EXPECT_FALSE(map.erase(1));
+
+    EXPECT_TRUE(map.insert(1, 10));
+    EXPECT_FALSE(map.insert(1, 11));
+    EXPECT_EQ(map.find(1), 10);
+
+    EXPECT_FALSE(map.insert_or_assign(1, 12));
+    EXPECT_TRUE(map.insert_or_assign(2, 20));
+    EXPECT_EQ(map.find(1), 12);
+    EXPECT_EQ(map.size(), 2);
+
+    EXPECT_TRUE(map.erase(1));
+    EXPECT_FALSE(map.contains(1));
+    EXPECT_TRUE(map.contains(2));
+    EXPECT_EQ(map.size(), 1);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(2), std::nullopt);
+}
+
+TEST(ConcurrentReadHashMapTest, RandomOperationsMatchReference)
+{
+    optimap::ConcurrentReadHashMap<uint64_t, uint64_t> map;
+    std::unordered_map<uint64_t, uint64_t> reference;
+    std::mt19937_64 rng(11);
+
+    for (int step = 0; step < 100000; ++step)
+    {
+        const uint64_t key = rng() % 2000;
+        switch (rng() % 3)
+        {
+        case 0:
+            EXPECT_EQ(map.insert(key, step), reference.emplace(key, step).second);
+            break;
+        case 1:
+            EXPECT_EQ(map.insert_or_assign(key, step), !reference.contains(key));
+            reference[key] = step;
+            break;
+        default:
+            EXPECT_EQ(map.erase(key), reference.erase(key) == 1);
+            break;
+        }
+        ASSERT_EQ(map.size(), reference.size());
+    }
+
+    for (uint64_t key = 0; key < 2000; ++key)
+    {
+        auto ref = reference.find(key);
+        if (ref == reference.end())
+        {
+            EXPECT_EQ(map.find(key), std::nullopt);
+        }
+        else
+        {
+            EXPECT_EQ(map.find(key), ref->second);
+        }
+    }
+}
+
+TEST(ConcurrentReadHashMapTest, ChurnDoesNotGrowWithoutBound)
+{
+    optimap::ConcurrentReadHashMap<int, int> map;
+    for (int key = 0; key < 1000; ++key)
+    {
+        map.insert(key, key);
+    }
+    const size_t initial_capacity = map.capacity();
+
+    for (int key = 1000; key < 100000; ++key)
+    {
+        ASSERT_TRUE(map.erase(key - 1000));
+        ASSERT_TRUE(map.insert(key, key));
+    }
+    EXPECT_EQ(map.capacity(), initial_capacity);
+    EXPECT_EQ(map.find(99999), 99999);
+}
+
+// Readers must never observe a torn entry or lose a key that stays present, even while the
+// writer overwrites values, erases other keys and grows the table under them
+TEST(ConcurrentReadHashMapTest, ReadersSeeConsistentEntriesDuringWrites)
+{
+    struct Payload
+    {
+        uint64_t key;
+        uint64_t a;
+        uint64_t b;
+
+        bool operator==(const Payload&) const = default;
+    };
+
+    optimap::ConcurrentReadHashMap<uint64_t, Payload> map;
+    constexpr uint64_t kStableKeys = 256;
+    for (uint64_t key = 0; key < kStableKeys; ++key)
+    {
+        map.insert(key, Payload{key, 0, 0});
+    }
+
+    std::atomic<bool> stop = false;
+    std::atomic<uint64_t> errors = 0;
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t)
+    {
+        readers.emplace_back([&, t] {
+            std::mt19937_64 rng(t);
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                const uint64_t key = rng() % kStableKeys;
+                const auto value = map.find(key);
+                // Stable keys are never erased; every write keeps a == b
+                if (!value || value->key != key || value->a != value->b)
+                {
+                    errors.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    for (uint64_t round = 1; round <= 20000; ++round)
+    {
+        const uint64_t key = round % kStableKeys;
+        map.insert_or_assign(key, Payload{key, round, round});
+
+        // Transient keys force growth and tombstone cleanup while readers run
+        map.insert(kStableKeys + round, Payload{kStableKeys + round, 0, 0});
+        if (round > 100)
+        {
+            map.erase(kStableKeys + round - 100);
+        }
+    }
+    stop = true;
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_EQ(map.size(), kStableKeys + 100);
+}
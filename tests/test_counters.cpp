@@ -0,0 +1,89 @@
+// Built as its own executable with OPTIMAP_ENABLE_COUNTERS, which must not be mixed with
+// translation units compiled without it
+#include "hashmap.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+
+static_assert(optimap::detail::kCountersEnabled);
+
+namespace
+{
+    struct ConstantHash
+    {
+        size_t operator()(uint64_t) const noexcept
+        {
+            return 0;
+        }
+    };
+} // namespace
+
+TEST(OperationCountersTest, CountsLookupsProbesAndComparisons)
+{
+    optimap::HashMap<uint64_t, uint64_t> map;
+    map.reserve(1000);
+    for (uint64_t key = 0; key < 1000; ++key)
+    {
+        map.insert(key, key);
+    }
+    map.reset_counters();
+
+    for (uint64_t key = 0; key < 1000; ++key)
+    {
+        ASSERT_TRUE(map.contains(key));
+    }
+    const auto hits = map.counters();
+    EXPECT_EQ(hits.lookups, 1000);
+    EXPECT_GE(hits.probes, 1000);
+    EXPECT_GE(hits.key_comparisons, 1000);
+    EXPECT_EQ(hits.key_comparisons - hits.h2_false_positives, 1000);
+    EXPECT_EQ(hits.rehashes, 0);
+
+    map.reset_counters();
+    EXPECT_EQ(map.counters().lookups, 0);
+    for (uint64_t key = 1000; key < 2000; ++key)
+    {
+        ASSERT_FALSE(map.contains(key));
+    }
+    // Every comparison on a miss is a fingerprint false positive, and 7-bit fingerprints keep
+    // them rare
+    const auto misses = map.counters();
+    EXPECT_EQ(misses.lookups, 1000);
+    EXPECT_EQ(misses.key_comparisons, misses.h2_false_positives);
+    EXPECT_LT(misses.h2_false_positives, 200);
+}
+
+TEST(OperationCountersTest, CountsRehashesAndCollisions)
+{
+    optimap::HashMap<uint64_t, uint64_t, ConstantHash> map;
+    for (uint64_t key = 0; key < 64; ++key)
+    {
+        map.insert(key, key);
+    }
+    EXPECT_GT(map.counters().rehashes, 0);
+
+    // All keys share one fingerprint, so finding the last one compares against every other
+    map.reset_counters();
+    EXPECT_TRUE(map.contains(63));
+    const auto counters = map.counters();
+    EXPECT_EQ(counters.key_comparisons, 64);
+    EXPECT_EQ(counters.h2_false_positives, 63);
+    EXPECT_EQ(counters.probes, 64 / optimap::detail::kGroupWidth);
+
+    // Copies start from zero
+    const auto copy = map;
+    EXPECT_EQ(copy.counters().lookups, 0);
+}
+
+TEST(OperationCountersTest, WatchdogRehashesOncePerCapacity)
+{
+    optimap::HashMap<uint64_t, uint64_t, ConstantHash> map(1024);
+    map.set_probe_limit(2);
+    for (uint64_t key = 0; key < 800; ++key)
+    {
+        map.insert(key, key);
+    }
+    EXPECT_EQ(map.capacity(), 1024);
+    EXPECT_EQ(map.counters().rehashes, 1);
+    EXPECT_NE(map.seed(), 0);
+}
@@ -0,0 +1,181 @@
+#include "hashmap.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+    template <typename Map, typename Reference> void expect_same_entries(Map& map, Reference& ref)
+    {
+        ASSERT_EQ(map.size(), ref.size());
+        size_t visited = 0;
+        for (const auto& entry : map)
+        {
+            auto it = ref.find(entry.first);
+            ASSERT_NE(it, ref.end()) << entry.first;
+            EXPECT_EQ(entry.second, it->second);
+            ++visited;
+        }
+        EXPECT_EQ(visited, ref.size());
+        for (const auto& [key, value] : ref)
+        {
+            EXPECT_TRUE(map.contains(key)) << key;
+        }
+    }
+} // namespace
+
+TEST(EraseTest, EraseIteratorReturnsNextEntry)
+{
+    optimap::HashMap<int, int> map;
+    for (int i = 0; i < 1000; ++i)
+    {
+        map.insert(i, i);
+    }
+
+    auto it = map.begin();
+    auto expected_next = it;
+    ++expected_next;
+    EXPECT_EQ(map.erase(it), expected_next);
+
+    optimap::HashMap<int, int>::const_iterator cit = expected_next;
+    ++expected_next;
+    EXPECT_EQ(map.erase(cit), expected_next);
+    EXPECT_EQ(map.size(), 998);
+
+    EXPECT_EQ(map.erase(map.end()), map.end());
+}
+
+TEST(EraseTest, EraseWhileIterating)
+{
+    optimap::HashMap<uint64_t, std::string> map;
+    std::unordered_map<uint64_t, std::string> reference;
+    for (uint64_t i = 0; i < 5000; ++i)
+    {
+        map.insert(i, std::to_string(i));
+        reference.emplace(i, std::to_string(i));
+    }
+
+    for (auto it = map.begin(); it != map.end();)
+    {
+        if (it->first % 3 == 0)
+        {
+            it = map.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    std::erase_if(reference, [](const auto& entry) { return entry.first % 3 == 0; });
+
+    expect_same_entries(map, reference);
+}
+
+TEST(EraseTest, EraseIfMatchesReference)
+{
+    optimap::HashMap<uint64_t, std::string, optimap::GxHash<uint64_t>, true> map;
+    std::unordered_map<uint64_t, std::string> reference;
+    std::mt19937_64 rng(5);
+
+    for (int round = 0; round < 20; ++round)
+    {
+        for (int i = 0; i < 3000; ++i)
+        {
+            const uint64_t key = rng() % 20000;
+            map.insert(key, std::to_string(key));
+            reference.emplace(key, std::to_string(key));
+        }
+
+        const uint64_t modulus = 2 + round % 7;
+        const auto pred = [modulus](const auto& entry) { return entry.first % modulus == 0; };
+        const size_t expected = std::erase_if(reference, pred);
+        EXPECT_EQ(map.erase_if(pred), expected);
+        expect_same_entries(map, reference);
+    }
+
+    // The tombstones left behind are reclaimed like any others
+    EXPECT_FALSE(map.contains(20000));
+    EXPECT_TRUE(map.insert(20000, "20000"));
+    EXPECT_EQ(map.at(20000), "20000");
+}
+
+// Erasing from the first group must update the mirrored control bytes past the end, which
+// probes that wrap around read. A tiny table makes every probe wrap
+TEST(EraseTest, EraseIfInWrappedTable)
+{
+    optimap::HashMap<int, int> map;
+    std::unordered_map<int, int> reference;
+    for (int i = 0; i < 20; ++i)
+    {
+        map.insert(i, i);
+        reference.emplace(i, i);
+    }
+
+    EXPECT_EQ(map.erase_if([](const auto& entry) { return entry.second % 2 == 1; }), 10);
+    std::erase_if(reference, [](const auto& entry) { return entry.second % 2 == 1; });
+    expect_same_entries(map, reference);
+
+    for (int i = 20; i < 24; ++i)
+    {
+        EXPECT_TRUE(map.insert(i, i));
+        reference.emplace(i, i);
+    }
+    expect_same_entries(map, reference);
+}
+
+TEST(EraseTest, EraseIfEverythingResetsTable)
+{
+    optimap::HashMap<int, std::string> map;
+    for (int i = 0; i < 1000; ++i)
+    {
+        map.insert(i, std::to_string(i));
+    }
+    const size_t capacity = map.capacity();
+
+    EXPECT_EQ(map.erase_if([](const auto&) { return false; }), 0);
+    EXPECT_EQ(map.size(), 1000);
+
+    EXPECT_EQ(map.erase_if([](const auto&) { return true; }), 1000);
+    EXPECT_EQ(map.size(), 0);
+    EXPECT_EQ(map.begin(), map.end());
+    EXPECT_EQ(map.capacity(), capacity);
+    EXPECT_EQ(map.stats().tombstones, 0);
+    EXPECT_EQ(map.stats().occupied_groups, 0);
+
+    optimap::HashMap<int, int> empty;
+    EXPECT_EQ(empty.erase_if([](const auto&) { return true; }), 0);
+}
+
+TEST(EraseTest, ThrowingPredicateKeepsMapConsistent)
+{
+    optimap::HashMap<int, std::string> map;
+    for (int i = 0; i < 1000; ++i)
+    {
+        map.insert(i, std::to_string(i));
+    }
+
+    int calls = 0;
+    const auto pred = [&calls](const auto& entry) {
+        if (++calls == 500)
+        {
+            throw std::runtime_error("predicate failed");
+        }
+        return entry.first % 2 == 0;
+    };
+    EXPECT_THROW(map.erase_if(pred), std::runtime_error);
+
+    // Entries tested before the throw may be gone, every other one is still reachable
+    size_t visited = 0;
+    for (const auto& entry : map)
+    {
+        EXPECT_EQ(map.at(entry.first), std::to_string(entry.first));
+        ++visited;
+    }
+    EXPECT_EQ(visited, map.size());
+    EXPECT_LT(map.size(), 1000);
+    EXPECT_GT(map.size(), 500);
+}
@@ -0,0 +1,111 @@
+#include "hashmap.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+TEST(FindManyTest, MixedHitsAndMisses)
+{
+    optimap::HashMap<uint64_t, uint64_t> map;
+    for (uint64_t key = 0; key < 1000; key += 2)
+    {
+        map.insert(key, key * 3);
+    }
+
+    // More keys than one prefetch block, with a partial block at the end
+    std::vector<uint64_t> keys;
+    for (uint64_t key = 0; key < 101; ++key)
+    {
+        keys.push_back(key);
+    }
+
+    std::vector<optimap::HashMap<uint64_t, uint64_t>::iterator> results;
+    map.find_many(keys, std::back_inserter(results));
+
+    ASSERT_EQ(results.size(), keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        if (keys[i] % 2 == 0)
+        {
+            ASSERT_NE(results[i], map.end());
+            EXPECT_EQ(results[i]->first, keys[i]);
+            EXPECT_EQ(results[i]->second, keys[i] * 3);
+        }
+        else
+        {
+            EXPECT_EQ(results[i], map.end());
+        }
+    }
+}
+
+TEST(FindManyTest, ResultsAreMutable)
+{
+    optimap::HashMap<int, int> map;
+    map.insert(1, 10);
+    map.insert(2, 20);
+
+    const std::vector<int> keys = {2, 1};
+    std::vector<optimap::HashMap<int, int>::iterator> results(keys.size());
+    map.find_many(keys, results.begin());
+
+    results[0]->second = 200;
+    EXPECT_EQ(map.at(2), 200);
+    EXPECT_EQ(map.at(1), 10);
+}
+
+TEST(FindManyTest, ConstMapAndStrings)
+{
+    optimap::HashMap<std::string, int> map;
+    map.insert("alpha", 1);
+    map.insert("beta", 2);
+    const auto& cmap = map;
+
+    const std::vector<std::string> keys = {"beta", "gamma", "alpha"};
+    std::vector<optimap::HashMap<std::string, int>::const_iterator> results;
+    cmap.find_many(keys, std::back_inserter(results));
+
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_EQ(results[0]->second, 2);
+    EXPECT_EQ(results[1], cmap.end());
+    EXPECT_EQ(results[2]->second, 1);
+}
+
+TEST(ContainsManyTest, MatchesContains)
+{
+    optimap::HashMap<uint32_t, uint32_t> map;
+    for (uint32_t key = 0; key < 5000; key += 3)
+    {
+        map.insert(key, key);
+    }
+
+    std::vector<uint32_t> keys(777);
+    for (uint32_t i = 0; i < keys.size(); ++i)
+    {
+        keys[i] = i * 7;
+    }
+
+    std::vector<bool> results;
+    map.contains_many(keys, std::back_inserter(results));
+
+    ASSERT_EQ(results.size(), keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        EXPECT_EQ(results[i], map.contains(keys[i])) << "key " << keys[i];
+    }
+}
+
+TEST(ContainsManyTest, EmptyMapAndEmptyInput)
+{
+    optimap::HashMap<int, int> map;
+    const std::vector<int> keys = {1, 2, 3};
+
+    std::vector<bool> results;
+    map.contains_many(keys, std::back_inserter(results));
+    EXPECT_EQ(results, std::vector<bool>({false, false, false}));
+
+    results.clear();
+    map.contains_many(std::span<const int>{}, std::back_inserter(results));
+    EXPECT_TRUE(results.empty());
+}
@@ -0,0 +1,163 @@
+#include "hashmap.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using Map = optimap::HashMap<uint64_t, uint64_t>;
+
+    // Map of keys to key * 3 with every third key erased again, so that some flagged groups
+    // are left sparse by tombstones
+    Map make_map(uint64_t count)
+    {
+        Map map;
+        for (uint64_t key = 0; key < count; ++key)
+        {
+            map.insert(key, key * 3);
+        }
+        for (uint64_t key = 0; key < count; key += 3)
+        {
+            map.erase(key);
+        }
+        return map;
+    }
+
+    uint64_t expected_sum(const Map& map)
+    {
+        uint64_t sum = 0;
+        for (const auto& entry : map)
+        {
+            sum += entry.second;
+        }
+        return sum;
+    }
+} // namespace
+
+TEST(ForEachTest, VisitsEveryEntryOnce)
+{
+    for (const uint64_t count : {uint64_t{0}, uint64_t{1}, uint64_t{100}, uint64_t{50000}})
+    {
+        Map map = make_map(count);
+        std::unordered_map<uint64_t, int> visits;
+        map.for_each([&visits](const auto& entry) { ++visits[entry.first]; });
+        ASSERT_EQ(visits.size(), map.size());
+        for (const auto& [key, times] : visits)
+        {
+            ASSERT_EQ(times, 1) << key;
+            ASSERT_NE(key % 3, 0) << key;
+        }
+
+        // Values can be updated in place
+        map.for_each([](auto& entry) { entry.second += 1; });
+        const Map& const_map = map;
+        size_t visited = 0;
+        const_map.for_each([&visited](const Map::Entry& entry) {
+            EXPECT_EQ(entry.second, entry.first * 3 + 1);
+            ++visited;
+        });
+        EXPECT_EQ(visited, map.size());
+    }
+}
+
+TEST(ForEachTest, GroupsMatchTheirSlots)
+{
+    const Map map = make_map(20000);
+    size_t visited = 0;
+    size_t previous_first_slot = 0;
+    bool first_group = true;
+    map.for_each_group([&](const Map::const_group_entries& group) {
+        EXPECT_EQ(group.first_slot() % optimap::detail::kGroupWidth, 0);
+        if (!first_group)
+        {
+            EXPECT_GT(group.first_slot(), previous_first_slot);
+        }
+        first_group = false;
+        previous_first_slot = group.first_slot();
+
+        size_t in_group = 0;
+        for (const auto& entry : group)
+        {
+            EXPECT_EQ(map.at(entry.first), entry.second);
+            ++in_group;
+        }
+        EXPECT_GT(in_group, 0);
+        EXPECT_LE(in_group, optimap::detail::kGroupWidth);
+        visited += in_group;
+    });
+    EXPECT_EQ(visited, map.size());
+}
+
+// Chunks split the table without overlap, also when there are more chunks than mask words
+TEST(ForEachTest, ChunksPartitionTheTable)
+{
+    Map map = make_map(200000);
+    const uint64_t sum = expected_sum(map);
+    for (const size_t chunks : {size_t{1}, size_t{3}, size_t{8}, size_t{1000}})
+    {
+        uint64_t chunked_sum = 0;
+        size_t visited = 0;
+        for (size_t chunk = 0; chunk < chunks; ++chunk)
+        {
+            map.for_each_in_chunk(chunk, chunks, [&](const auto& entry) {
+                chunked_sum += entry.second;
+                ++visited;
+            });
+        }
+        EXPECT_EQ(visited, map.size()) << chunks;
+        EXPECT_EQ(chunked_sum, sum) << chunks;
+    }
+}
+
+TEST(ForEachTest, ParallelForEach)
+{
+    for (const uint64_t count : {uint64_t{0}, uint64_t{10}, uint64_t{300000}})
+    {
+        Map map = make_map(count);
+        const uint64_t sum = expected_sum(map);
+        for (const size_t threads : {size_t{1}, size_t{4}, size_t{64}})
+        {
+            std::atomic<uint64_t> parallel_sum{0};
+            std::atomic<size_t> visited{0};
+            std::as_const(map).parallel_for_each(
+                    [&](const auto& entry) {
+                        parallel_sum.fetch_add(entry.second, std::memory_order_relaxed);
+                        visited.fetch_add(1, std::memory_order_relaxed);
+                    },
+                    threads
+            );
+            EXPECT_EQ(visited.load(), map.size());
+            EXPECT_EQ(parallel_sum.load(), sum);
+        }
+
+        std::vector<uint64_t> partials(4, 0);
+        map.parallel_for_each(
+                [&partials](const auto& entry, size_t worker) { partials[worker] += entry.second; },
+                4
+        );
+        EXPECT_EQ(partials[0] + partials[1] + partials[2] + partials[3], sum);
+
+        // Each entry is handed to one thread only, so writes to it do not race
+        map.parallel_for_each([](auto& entry) { entry.second = entry.first; }, 4);
+        map.for_each([](const auto& entry) { EXPECT_EQ(entry.second, entry.first); });
+    }
+}
+
+TEST(ForEachTest, StoredHashSlots)
+{
+    optimap::HashMap<std::string, int, optimap::GxHash<std::string>, true> map;
+    for (int i = 0; i < 5000; ++i)
+    {
+        map.insert(std::to_string(i), i);
+    }
+    std::atomic<int64_t> sum{0};
+    map.parallel_for_each([&sum](const auto& entry) { sum += entry.second; }, 3);
+    EXPECT_EQ(sum.load(), int64_t{4999} * 5000 / 2);
+
+    map.for_each([](auto& entry) { EXPECT_EQ(std::stoi(entry.first), entry.second); });
+}
@@ -0,0 +1,103 @@
+#include "frozen_hashmap.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+TEST(FrozenHashMapTest, MatchesSourceMap)
+{
+    optimap::HashMap<uint64_t, uint64_t> source;
+    std::mt19937_64 rng(5);
+    for (int i = 0; i < 100000; ++i)
+    {
+        source.insert(rng(), i);
+    }
+
+    const optimap::FrozenHashMap<uint64_t, uint64_t> frozen(source);
+    ASSERT_EQ(frozen.size(), source.size());
+    for (const auto& entry : source)
+    {
+        auto it = frozen.find(entry.first);
+        ASSERT_NE(it, frozen.end());
+        EXPECT_EQ(it->first, entry.first);
+        EXPECT_EQ(it->second, entry.second);
+    }
+    for (int i = 0; i < 10000; ++i)
+    {
+        const uint64_t missing = rng();
+        EXPECT_EQ(frozen.contains(missing), source.contains(missing));
+    }
+
+    // Packed close to full, compared with the 87.5% max load of the source
+    EXPECT_GT(static_cast<double>(frozen.size()) / frozen.capacity(), 0.9);
+}
+
+TEST(FrozenHashMapTest, BuildsFromRangeFirstPairWins)
+{
+    const std::vector<std::pair<std::string, int>> pairs = {
+            {"alpha", 1},
+            {"beta", 2},
+            {"alpha", 3},
+            {"gamma", 4},
+    };
+    const optimap::FrozenHashMap<std::string, int> frozen(pairs);
+
+    EXPECT_EQ(frozen.size(), 3);
+    EXPECT_EQ(frozen.at("alpha"), 1);
+    EXPECT_EQ(frozen.at(std::string_view("gamma")), 4);
+    EXPECT_TRUE(frozen.contains("beta"));
+    EXPECT_FALSE(frozen.contains("delta"));
+    EXPECT_THROW(frozen.at("delta"), std::out_of_range);
+
+    int sum = 0;
+    for (const auto& entry : frozen)
+    {
+        sum += entry.second;
+    }
+    EXPECT_EQ(sum, 7);
+}
+
+TEST(FrozenHashMapTest, EmptyAndTinyMaps)
+{
+    const optimap::FrozenHashMap<int, int> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_FALSE(empty.contains(0));
+    EXPECT_EQ(empty.begin(), empty.end());
+
+    const optimap::FrozenHashMap<int, int> single(std::vector<std::pair<int, int>>{{7, 49}});
+    EXPECT_EQ(single.size(), 1);
+    EXPECT_EQ(single.at(7), 49);
+    EXPECT_FALSE(single.contains(8));
+}
+
+// Distinct keys whose hashes are all equal can never share one group beyond its width
+struct ConstantHash
+{
+    size_t operator()(int) const
+    {
+        return 42;
+    }
+};
+
+TEST(FrozenHashMapTest, CollidingHashes)
+{
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < static_cast<int>(optimap::detail::kGroupWidth); ++i)
+    {
+        pairs.emplace_back(i, -i);
+    }
+    const optimap::FrozenHashMap<int, int, ConstantHash> full_group(pairs);
+    for (int i = 0; i < static_cast<int>(pairs.size()); ++i)
+    {
+        EXPECT_EQ(full_group.at(i), -i);
+    }
+
+    pairs.emplace_back(-1, 1);
+    using Frozen = optimap::FrozenHashMap<int, int, ConstantHash>;
+    EXPECT_THROW(Frozen{pairs}, std::invalid_argument);
+}
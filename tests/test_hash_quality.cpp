@@ -0,0 +1,180 @@
+#include "hashmap.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Largest deviation from 1/2, over every (input bit, output bit) pair, of the probability
+    // that flipping the input bit flips the output bit
+    template <typename T> double worst_avalanche_bias(int samples)
+    {
+        constexpr int kInputBits = sizeof(T) * 8;
+        std::mt19937_64 rng(17);
+        std::vector<int> flips(kInputBits * 64, 0);
+        const optimap::GxHash<T> hash;
+
+        for (int s = 0; s < samples; ++s)
+        {
+            const T key = static_cast<T>(rng());
+            const uint64_t base = hash(key);
+            for (int bit = 0; bit < kInputBits; ++bit)
+            {
+                const T flipped = static_cast<T>(key ^ (T{1} << bit));
+                const uint64_t diff = base ^ hash(flipped);
+                for (int out = 0; out < 64; ++out)
+                {
+                    flips[bit * 64 + out] += (diff >> out) & 1;
+                }
+            }
+        }
+
+        double worst = 0;
+        for (const int count : flips)
+        {
+            worst = std::max(worst, std::abs(static_cast<double>(count) / samples - 0.5));
+        }
+        return worst;
+    }
+
+    // Chi-squared statistic of keys spread over 2^bits buckets taken from the hash at shift
+    double chi_squared(const std::vector<uint64_t>& keys, int shift, int bits)
+    {
+        std::vector<size_t> buckets(size_t{1} << bits, 0);
+        const optimap::GxHash<uint64_t> hash;
+        for (const uint64_t key : keys)
+        {
+            ++buckets[(hash(key) >> shift) & (buckets.size() - 1)];
+        }
+
+        const double expected = static_cast<double>(keys.size()) / buckets.size();
+        double chi = 0;
+        for (const size_t count : buckets)
+        {
+            chi += (count - expected) * (count - expected) / expected;
+        }
+        return chi;
+    }
+
+    // Keys with structure that a weak integer hash maps to few slots: consecutive values,
+    // and values that differ only in high bits
+    std::vector<std::vector<uint64_t>> structured_key_sets()
+    {
+        std::vector<std::vector<uint64_t>> sets;
+        for (const int stride_shift : {0, 12, 32, 48})
+        {
+            std::vector<uint64_t> keys;
+            for (uint64_t i = 0; i < (1 << 16); ++i)
+            {
+                keys.push_back(i << stride_shift);
+            }
+            sets.push_back(std::move(keys));
+        }
+        return sets;
+    }
+} // namespace
+
+TEST(HashQualityTest, IntegerAvalanche)
+{
+    EXPECT_LT(worst_avalanche_bias<uint64_t>(4000), 0.05);
+    EXPECT_LT(worst_avalanche_bias<uint32_t>(4000), 0.05);
+    EXPECT_LT(worst_avalanche_bias<uint16_t>(4000), 0.05);
+}
+
+// h1 uses the low bits of the hash and h2 the top 7. Both must stay uniform for structured keys.
+// With 1023 and 127 degrees of freedom, a uniform spread stays far below these bounds
+TEST(HashQualityTest, StructuredIntegersSpreadOverSlotsAndFingerprints)
+{
+    for (const auto& keys : structured_key_sets())
+    {
+        EXPECT_LT(chi_squared(keys, 0, 10), 1300) << "low bits, stride " << keys[1];
+        EXPECT_LT(chi_squared(keys, 57, 7), 200) << "top bits, stride " << keys[1];
+        EXPECT_LT(chi_squared(keys, 32, 10), 1300) << "middle bits, stride " << keys[1];
+    }
+}
+
+TEST(HashQualityTest, IntegerHashIsWidthIndependentAndDistinct)
+{
+    EXPECT_EQ(optimap::GxHash<int32_t>{}(-5), optimap::GxHash<int64_t>{}(-5));
+    EXPECT_EQ(optimap::GxHash<uint8_t>{}(200), optimap::GxHash<uint64_t>{}(200));
+
+    // No collisions among the first 2^20 integers
+    std::vector<uint64_t> hashes;
+    for (uint64_t key = 0; key < (1 << 20); ++key)
+    {
+        hashes.push_back(optimap::GxHash<uint64_t>{}(key));
+    }
+    std::sort(hashes.begin(), hashes.end());
+    EXPECT_EQ(std::adjacent_find(hashes.begin(), hashes.end()), hashes.end());
+}
+
+#if defined(GXHASH_HAVE_AES_INTRINSICS)
+// The dispatched entry point, the 8-lane AES path and the VAES path are one hash function
+TEST(HashQualityTest, AesImplementationsAgree)
+{
+    if (!gxhash::detail::cpu_supports_aes())
+    {
+        GTEST_SKIP() << "CPU has no AES instructions";
+    }
+
+    std::mt19937_64 rng(3);
+    std::vector<uint8_t> bytes(5000);
+    for (auto& byte : bytes)
+    {
+        byte = static_cast<uint8_t>(rng());
+    }
+
+    for (size_t len = 0; len < bytes.size(); len += len < 300 ? 1 : 97)
+    {
+        const uint64_t expected = gxhash::detail::gxhash64_aes(bytes.data() + 1, len, len);
+        ASSERT_EQ(gxhash::gxhash64(bytes.data() + 1, len, len), expected) << len;
+#if defined(GXHASH_HAVE_VAES)
+        if (__builtin_cpu_supports("vaes") && __builtin_cpu_supports("avx2"))
+        {
+            ASSERT_EQ(gxhash::detail::gxhash64_vaes(bytes.data() + 1, len, len), expected)
+                    << len;
+        }
+#endif
+    }
+}
+#endif
+
+// Long keys go through independent lanes. Moving a block to another lane or stripe, and
+// flipping any bit, must still change the hash
+TEST(HashQualityTest, LongKeysDependOnEveryBlockAndItsPosition)
+{
+    std::mt19937_64 rng(9);
+    std::vector<uint8_t> key(1024);
+    for (auto& byte : key)
+    {
+        byte = static_cast<uint8_t>(rng());
+    }
+    const uint64_t base = gxhash::gxhash64(key.data(), key.size());
+
+    // Swap 16-byte blocks 0 and 1 (neighbouring lanes), then 0 and 8 (same lane, next stripe)
+    for (const size_t other : {size_t{1}, size_t{8}})
+    {
+        std::vector<uint8_t> swapped = key;
+        std::swap_ranges(swapped.begin(), swapped.begin() + 16, swapped.begin() + other * 16);
+        EXPECT_NE(gxhash::gxhash64(swapped.data(), swapped.size()), base) << other;
+    }
+
+    int worst_flips = 64;
+    int best_flips = 0;
+    for (size_t bit = 0; bit < key.size() * 8; bit += 7)
+    {
+        std::vector<uint8_t> flipped = key;
+        flipped[bit / 8] ^= static_cast<uint8_t>(1 << (bit % 8));
+        const int flips =
+                std::popcount(base ^ gxhash::gxhash64(flipped.data(), flipped.size()));
+        worst_flips = std::min(worst_flips, flips);
+        best_flips = std::max(best_flips, flips);
+    }
+    EXPECT_GT(worst_flips, 12);
+    EXPECT_LT(best_flips, 52);
+}
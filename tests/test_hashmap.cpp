@@ -4,6 +4,7 @@
 #include <numeric>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // Basic functionality tests
@@ -336,6 +337,30 @@ TEST(IteratorTest, IterationWithOverflow)
     EXPECT_EQ(found_keys, expected_keys);
 }
 
+TEST(IteratorTest, SparseIterationVisitsOnlyEntries)
+{
+    // Few entries spread over many groups: the scan must not stop on empty slots that follow
+    // the last entry of a group
+    optimap::HashMap<int, int> map(1024);
+    std::set<int> expected_keys = {1, 2, 3, 4, 5};
+    for (int key : expected_keys)
+    {
+        map.insert(key, key * 10);
+    }
+
+    std::set<int> found_keys;
+    size_t visited = 0;
+    for (const auto& entry : map)
+    {
+        EXPECT_EQ(entry.second, entry.first * 10);
+        found_keys.insert(entry.first);
+        ++visited;
+    }
+
+    EXPECT_EQ(visited, 5);
+    EXPECT_EQ(found_keys, expected_keys);
+}
+
 // Rule of 5 and Move Semantics Tests
 TEST(LifecycleTest, CopyConstructor)
 {
@@ -403,6 +428,100 @@ TEST(LifecycleTest, MoveAssignment)
     EXPECT_EQ(map1.size(), 0);
 }
 
+TEST(LifecycleTest, CopyTrivialEntriesWithTombstones)
+{
+    // int -> int entries are copied as one block, tombstones included
+    optimap::HashMap<int, int> map1;
+    for (int i = 0; i < 1000; ++i)
+    {
+        map1.insert(i, i * 2);
+    }
+    for (int i = 0; i < 1000; i += 3)
+    {
+        map1.erase(i);
+    }
+
+    optimap::HashMap<int, int> map2(map1);
+    optimap::HashMap<int, int> map3;
+    map3 = map1;
+    for (const auto* copy : {&map2, &map3})
+    {
+        EXPECT_EQ(copy->size(), map1.size());
+        EXPECT_EQ(copy->capacity(), map1.capacity());
+        for (int i = 0; i < 1000; ++i)
+        {
+            EXPECT_EQ(copy->contains(i), i % 3 != 0);
+        }
+    }
+
+    // The copy's tombstones are reusable like the original's
+    map2.insert(0, -1);
+    EXPECT_EQ(map2.at(0), -1);
+    EXPECT_FALSE(map1.contains(0));
+}
+
+// Counts live instances to check that clear() and the destructor destroy every entry once
+struct LiveCounted
+{
+    static inline int live = 0;
+
+    int value;
+
+    explicit LiveCounted(int v = 0) : value(v)
+    {
+        ++live;
+    }
+    LiveCounted(const LiveCounted& other) : value(other.value)
+    {
+        ++live;
+    }
+    LiveCounted(LiveCounted&& other) noexcept : value(other.value)
+    {
+        ++live;
+    }
+    LiveCounted& operator=(const LiveCounted&) = default;
+    ~LiveCounted()
+    {
+        --live;
+    }
+};
+
+TEST(LifecycleTest, ClearKeepsTableAndDestroysEntries)
+{
+    LiveCounted::live = 0;
+    {
+        optimap::HashMap<int, LiveCounted> map;
+        for (int i = 0; i < 500; ++i)
+        {
+            map.emplace(i, LiveCounted(i));
+        }
+        for (int i = 0; i < 500; i += 2)
+        {
+            map.erase(i);
+        }
+        EXPECT_EQ(LiveCounted::live, 250);
+
+        const size_t capacity = map.capacity();
+        map.clear();
+        EXPECT_EQ(LiveCounted::live, 0);
+        EXPECT_EQ(map.size(), 0);
+        EXPECT_EQ(map.capacity(), capacity);
+        EXPECT_EQ(map.begin(), map.end());
+        EXPECT_FALSE(map.contains(1));
+
+        for (int i = 0; i < 100; ++i)
+        {
+            map.emplace(i, LiveCounted(i));
+        }
+        EXPECT_EQ(map.capacity(), capacity);
+        EXPECT_EQ(map.at(42).value, 42);
+
+        auto copy = map;
+        EXPECT_EQ(LiveCounted::live, 200);
+    }
+    EXPECT_EQ(LiveCounted::live, 0);
+}
+
 // Test with move-only types
 struct MoveOnly
 {
@@ -477,6 +596,90 @@ TEST(EmplaceTest, TryEmplace)
     EXPECT_EQ(val_a->second, RegularType(1, "b")); // Value should not have changed
 }
 
+TEST(EmplaceTest, EmplaceReturnsIteratorToEntry)
+{
+    optimap::HashMap<std::string, int> map;
+    auto [it, inserted] = map.emplace("a", 1);
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->first, "a");
+
+    // The existing entry comes back without a second lookup, and a counter update is one probe
+    auto [again, inserted_again] = map.emplace("a", 2);
+    EXPECT_FALSE(inserted_again);
+    EXPECT_EQ(again, it);
+    ++again->second;
+    EXPECT_EQ(map.at("a"), 2);
+}
+
+TEST(EmplaceTest, InsertOrAssign)
+{
+    optimap::HashMap<std::string, std::string> map;
+    auto [it, inserted] = map.insert_or_assign("k", std::string("first"));
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->second, "first");
+
+    std::string second = "second";
+    auto [same, inserted_again] = map.insert_or_assign(std::string("k"), std::move(second));
+    EXPECT_FALSE(inserted_again);
+    EXPECT_EQ(same, it);
+    EXPECT_EQ(map.at("k"), "second");
+    EXPECT_EQ(map.size(), 1);
+
+    // Heterogeneous key, only converted to std::string on insertion
+    map.insert_or_assign(std::string_view("view"), "v");
+    EXPECT_EQ(map.at("view"), "v");
+}
+
+// A full table only grows when an insertion needs a fresh slot
+TEST(EmplaceTest, ExistingKeysAtMaxLoadDoNotGrow)
+{
+    optimap::HashMap<int, int> map(16);
+    for (int i = 0; i < 14; ++i) // 14 is the max load of 16 slots
+    {
+        map.insert(i, i);
+    }
+    ASSERT_EQ(map.capacity(), 16);
+
+    EXPECT_FALSE(map.emplace(3, 0).second);
+    EXPECT_FALSE(map.try_emplace(4, 0).second);
+    EXPECT_FALSE(map.insert_or_assign(5, 50).second);
+    map[6] += 1;
+    EXPECT_EQ(map.capacity(), 16);
+    EXPECT_EQ(map.at(5), 50);
+    EXPECT_EQ(map.at(6), 7);
+
+    EXPECT_TRUE(map.insert(14, 14));
+    EXPECT_EQ(map.capacity(), 32);
+    for (int i = 0; i < 15; ++i)
+    {
+        EXPECT_TRUE(map.contains(i));
+    }
+}
+
+// Counts constructions to check that try_emplace builds no value for an existing key
+struct ConstructionCounted
+{
+    static inline int constructed = 0;
+
+    explicit ConstructionCounted(int v) : value(v)
+    {
+        ++constructed;
+    }
+
+    int value;
+};
+
+TEST(EmplaceTest, TryEmplaceConstructsValueOnlyOnInsert)
+{
+    using Counted = ConstructionCounted;
+    optimap::HashMap<int, Counted> map;
+    map.try_emplace(1, 10);
+    map.try_emplace(1, 20);
+    map.try_emplace(2, 30);
+    EXPECT_EQ(Counted::constructed, 2);
+    EXPECT_EQ(map.at(1).value, 10);
+}
+
 // Tests for C++17 extract functionality
 TEST(ExtractTest, ExtractAndInsertNode)
 {
@@ -0,0 +1,156 @@
+#include "hashset.hpp"
+#include "test_util.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+    using test_util::expect_set_matches;
+
+    struct Empty
+    {
+        bool operator==(const Empty&) const = default;
+    };
+} // namespace
+
+// The empty value takes no space next to the key
+TEST(HashSetTest, SlotsHoldBareKeys)
+{
+    EXPECT_EQ(sizeof(optimap::HashMap<uint32_t, Empty>::Entry), sizeof(uint32_t));
+    EXPECT_EQ(sizeof(optimap::HashMap<uint64_t, Empty>::Entry), sizeof(uint64_t));
+    EXPECT_EQ(sizeof(optimap::HashMap<uint32_t, uint32_t>::Entry), 2 * sizeof(uint32_t));
+}
+
+TEST(HashSetTest, BasicOperations)
+{
+    optimap::HashSet<uint32_t> set;
+    EXPECT_TRUE(set.empty());
+    EXPECT_EQ(set.find(1), set.end());
+    EXPECT_EQ(set.begin(), set.end());
+
+    EXPECT_TRUE(set.insert(1));
+    EXPECT_FALSE(set.insert(1));
+    EXPECT_TRUE(set.emplace(2u).second);
+    EXPECT_EQ(*set.emplace(2u).first, 2);
+    EXPECT_EQ(set.size(), 2);
+    EXPECT_TRUE(set.contains(1));
+    EXPECT_FALSE(set.contains(3));
+    EXPECT_EQ(*set.find(2), 2);
+
+    EXPECT_TRUE(set.erase(1));
+    EXPECT_FALSE(set.erase(1));
+    EXPECT_EQ(set.size(), 1);
+
+    set.clear();
+    EXPECT_TRUE(set.empty());
+    EXPECT_TRUE(set.insert(7));
+}
+
+TEST(HashSetTest, RandomOperationsMatchReference)
+{
+    optimap::HashSet<uint64_t> set;
+    std::unordered_set<uint64_t> reference;
+    std::mt19937_64 rng(41);
+
+    for (int step = 0; step < 200000; ++step)
+    {
+        const uint64_t key = rng() % 20000;
+        if (rng() % 3 == 0)
+        {
+            ASSERT_EQ(set.erase(key), reference.erase(key) == 1);
+        }
+        else
+        {
+            ASSERT_EQ(set.insert(key), reference.insert(key).second);
+        }
+    }
+    expect_set_matches(set, reference);
+
+    for (auto it = set.begin(); it != set.end();)
+    {
+        it = *it % 2 == 0 ? set.erase(it) : ++it;
+    }
+    std::erase_if(reference, [](uint64_t key) { return key % 2 == 0; });
+    expect_set_matches(set, reference);
+
+    EXPECT_EQ(set.erase_if([](uint64_t key) { return key % 3 == 0; }),
+              std::erase_if(reference, [](uint64_t key) { return key % 3 == 0; }));
+    expect_set_matches(set, reference);
+}
+
+// insert_many counts only new keys, including duplicates within one batch
+TEST(HashSetTest, InsertManyAndContainsMany)
+{
+    std::vector<uint32_t> keys;
+    std::mt19937 rng(7);
+    for (int i = 0; i < 100000; ++i)
+    {
+        keys.push_back(rng() % 50000);
+    }
+
+    optimap::HashSet<uint32_t> set;
+    set.insert(keys[0]);
+    std::unordered_set<uint32_t> reference(keys.begin(), keys.end());
+    EXPECT_EQ(set.insert_many(keys), reference.size() - 1);
+    EXPECT_EQ(set.insert_many(keys), 0);
+    expect_set_matches(set, reference);
+
+    std::vector<uint32_t> queries;
+    for (uint32_t key = 0; key < 60000; ++key)
+    {
+        queries.push_back(key);
+    }
+    std::vector<bool> found;
+    set.contains_many(queries, std::back_inserter(found));
+    ASSERT_EQ(found.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        EXPECT_EQ(found[i], reference.contains(queries[i])) << queries[i];
+    }
+}
+
+// A batch that sends every key to one home slot trips the probe-length watchdog, which reseeds
+// the table partway through the batch
+TEST(HashSetTest, InsertManyAcrossWatchdogReseed)
+{
+    struct ClusteredHash
+    {
+        size_t operator()(uint64_t key) const
+        {
+            return static_cast<size_t>(key) << (sizeof(size_t) * 8 - 7);
+        }
+    };
+
+    std::vector<uint64_t> keys;
+    for (uint64_t key = 0; key < 5000; ++key)
+    {
+        keys.push_back(key * 0x9e3779b97f4a7c15ULL);
+    }
+
+    optimap::HashSet<uint64_t, ClusteredHash> set;
+    EXPECT_EQ(set.insert_many(keys), keys.size());
+    EXPECT_NE(set.seed(), 0);
+    expect_set_matches(set, std::unordered_set<uint64_t>(keys.begin(), keys.end()));
+}
+
+TEST(HashSetTest, StringKeysAndHeterogeneousLookup)
+{
+    optimap::HashSet<std::string, optimap::GxHash<std::string>, true> set;
+    for (int i = 0; i < 1000; ++i)
+    {
+        set.insert(std::to_string(i));
+    }
+    auto copy = set;
+    EXPECT_TRUE(copy.contains(std::string_view("999")));
+    EXPECT_FALSE(copy.contains(std::string_view("1000")));
+    EXPECT_EQ(*copy.find(std::string_view("42")), "42");
+    EXPECT_TRUE(copy.erase(std::string_view("42")));
+    EXPECT_EQ(copy.size(), 999);
+    EXPECT_EQ(set.size(), 1000);
+}
@@ -0,0 +1,157 @@
+#include "hashmap.hpp"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Key type that counts its constructions, to check that lookups by a transparent query type never
+// materialise a temporary key
+struct TrackedKey
+{
+    static inline int constructions = 0;
+
+    std::string value;
+
+    explicit TrackedKey(std::string_view v) : value(v)
+    {
+        ++constructions;
+    }
+    TrackedKey(const TrackedKey& other) : value(other.value)
+    {
+        ++constructions;
+    }
+    TrackedKey(TrackedKey&& other) noexcept : value(std::move(other.value))
+    {
+    }
+    TrackedKey& operator=(const TrackedKey&) = default;
+    TrackedKey& operator=(TrackedKey&&) noexcept = default;
+
+    bool operator==(const TrackedKey& other) const
+    {
+        return value == other.value;
+    }
+    bool operator==(std::string_view other) const
+    {
+        return value == other;
+    }
+};
+
+struct TrackedKeyHash
+{
+    using is_transparent = void;
+
+    size_t operator()(const TrackedKey& key) const
+    {
+        return optimap::GxHash<std::string_view>{}(key.value);
+    }
+    size_t operator()(std::string_view key) const
+    {
+        return optimap::GxHash<std::string_view>{}(key);
+    }
+};
+
+TEST(HeterogeneousLookupTest, StringKeysWithStringViewAndCharPointer)
+{
+    optimap::HashMap<std::string, int> map;
+    map.insert("alpha", 1);
+    map.insert("beta", 2);
+
+    const std::string_view alpha = "alpha";
+    const char* beta = "beta";
+
+    auto it = map.find(alpha);
+    ASSERT_NE(it, map.end());
+    EXPECT_EQ(it->second, 1);
+    EXPECT_TRUE(map.contains(beta));
+    EXPECT_TRUE(map.contains("alpha"));
+    EXPECT_FALSE(map.contains(std::string_view("gamma")));
+
+    map.at(beta) = 20;
+    EXPECT_EQ(map.at(std::string("beta")), 20);
+    EXPECT_THROW(map.at(std::string_view("gamma")), std::out_of_range);
+
+    const auto& cmap = map;
+    EXPECT_EQ(cmap.find(alpha)->second, 1);
+    EXPECT_EQ(cmap.at("alpha"), 1);
+
+    EXPECT_TRUE(map.erase(alpha));
+    EXPECT_FALSE(map.erase("alpha"));
+    EXPECT_EQ(map.size(), 1);
+}
+
+TEST(HeterogeneousLookupTest, HashesAgreeAcrossQueryTypes)
+{
+    const std::string key = "a somewhat longer key that spans several blocks of input";
+    EXPECT_EQ(optimap::GxHash<std::string>{}(key),
+              optimap::GxHash<std::string>{}(std::string_view(key)));
+    EXPECT_EQ(optimap::GxHash<std::string>{}(key),
+              optimap::GxHash<std::string>{}(key.c_str()));
+}
+
+TEST(HeterogeneousLookupTest, LookupsDoNotConstructKeys)
+{
+    optimap::HashMap<TrackedKey, int, TrackedKeyHash> map;
+    for (int i = 0; i < 100; ++i)
+    {
+        map.emplace(TrackedKey(std::to_string(i)), i);
+    }
+
+    TrackedKey::constructions = 0;
+    for (int i = 0; i < 200; ++i)
+    {
+        const std::string query = std::to_string(i);
+        const std::string_view view = query;
+        EXPECT_EQ(map.contains(view), i < 100);
+        if (i < 100)
+        {
+            EXPECT_EQ(map.find(view)->second, i);
+            EXPECT_EQ(map.at(view), i);
+        }
+    }
+    EXPECT_EQ(TrackedKey::constructions, 0);
+
+    EXPECT_TRUE(map.erase(std::string_view("42")));
+    EXPECT_EQ(TrackedKey::constructions, 0);
+}
+
+TEST(TryEmplaceTest, InsertsOnlyWhenAbsent)
+{
+    optimap::HashMap<std::string, std::string> map;
+
+    auto [it, inserted] = map.try_emplace("key", 3, 'x');
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->first, "key");
+    EXPECT_EQ(it->second, "xxx");
+
+    auto [again, inserted_again] = map.try_emplace(std::string("key"), "ignored");
+    EXPECT_FALSE(inserted_again);
+    EXPECT_EQ(again, it);
+    EXPECT_EQ(again->second, "xxx");
+    EXPECT_EQ(map.size(), 1);
+}
+
+TEST(TryEmplaceTest, DoesNotMoveFromKeyOnHit)
+{
+    optimap::HashMap<std::string, int> map;
+    map.insert("present", 1);
+
+    std::string key = "present";
+    auto [it, inserted] = map.try_emplace(std::move(key), 2);
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(it->second, 1);
+    EXPECT_EQ(key, "present"); // Left untouched because nothing was inserted
+}
+
+TEST(TryEmplaceTest, TransparentKeyConstructedOnlyOnInsert)
+{
+    optimap::HashMap<TrackedKey, int, TrackedKeyHash> map;
+
+    TrackedKey::constructions = 0;
+    EXPECT_TRUE(map.try_emplace(std::string_view("a"), 1).second);
+    EXPECT_EQ(TrackedKey::constructions, 1);
+
+    EXPECT_FALSE(map.try_emplace(std::string_view("a"), 2).second);
+    EXPECT_EQ(TrackedKey::constructions, 1);
+    EXPECT_EQ(map.at(std::string_view("a")), 1);
+}
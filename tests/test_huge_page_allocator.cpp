@@ -0,0 +1,92 @@
+#include "hashmap.hpp"
+#include "huge_page_allocator.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+    template <typename Key, typename Value>
+    using HugePageMap = optimap::HashMap<
+            Key,
+            Value,
+            optimap::GxHash<Key>,
+            false,
+            optimap::HugePageAllocator<std::pair<const Key, Value>>>;
+} // namespace
+
+static_assert(optimap::detail::allocates_zeroed_memory<optimap::HugePageAllocator<char>>);
+static_assert(!optimap::detail::allocates_zeroed_memory<AlignedAllocator<char, 64>>);
+
+TEST(HugePageAllocatorTest, AllocationsAreZeroedAndWritable)
+{
+    optimap::HugePageAllocator<uint64_t> allocator;
+    const size_t n = (size_t{3} << 20) / sizeof(uint64_t); // Spans two 2 MiB pages
+    uint64_t* p = allocator.allocate(n);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0);
+    for (size_t i = 0; i < n; i += 4096)
+    {
+        EXPECT_EQ(p[i], 0);
+        p[i] = i;
+    }
+    EXPECT_EQ(p[4096], 4096);
+    allocator.deallocate(p, n);
+}
+
+// The control bytes and group mask are never filled on this allocator, so this also checks
+// that zero-filled memory is a valid empty table
+TEST(HugePageAllocatorTest, MapOperationsMatchReference)
+{
+    HugePageMap<uint64_t, std::string> map;
+    std::unordered_map<uint64_t, std::string> reference;
+    for (uint64_t key = 0; key < 200000; ++key)
+    {
+        map.insert(key, std::to_string(key));
+        reference.emplace(key, std::to_string(key));
+        if (key % 3 == 0)
+        {
+            EXPECT_TRUE(map.erase(key / 2));
+            reference.erase(key / 2);
+        }
+    }
+
+    ASSERT_EQ(map.size(), reference.size());
+    for (const auto& [key, value] : reference)
+    {
+        ASSERT_EQ(map.at(key), value);
+    }
+    size_t visited = 0;
+    for (const auto& entry : map)
+    {
+        EXPECT_EQ(reference.at(entry.first), entry.second);
+        ++visited;
+    }
+    EXPECT_EQ(visited, reference.size());
+
+    auto copy = map;
+    EXPECT_EQ(copy.size(), map.size());
+    map.clear();
+    EXPECT_EQ(map.size(), 0);
+    EXPECT_FALSE(map.contains(2));
+    EXPECT_EQ(copy.at(2), "2");
+}
+
+TEST(HugePageAllocatorTest, ReservedMapStartsEmpty)
+{
+    HugePageMap<int, int> map;
+    map.reserve(1 << 20);
+    EXPECT_EQ(map.size(), 0);
+    EXPECT_EQ(map.begin(), map.end());
+    EXPECT_FALSE(map.contains(0));
+
+    for (int i = 0; i < (1 << 20); ++i)
+    {
+        map.emplace(i, i);
+    }
+    EXPECT_EQ(map.size(), 1 << 20);
+    EXPECT_EQ(map.at(12345), 12345);
+}
@@ -0,0 +1,205 @@
+#include "incremental_hashmap.hpp"
+#include "test_util.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+    using Map = optimap::IncrementalHashMap<uint64_t, std::string>;
+
+    using test_util::expect_matches;
+
+    // Inserts fresh keys until a migration of a table of over 1000 entries starts, and returns
+    // the next unused key
+    uint64_t fill_until_migrating(Map& map, uint64_t first_key)
+    {
+        uint64_t key = first_key;
+        while (map.size() < 1000 || !map.migrating())
+        {
+            map.insert(key, std::to_string(key));
+            ++key;
+        }
+        return key;
+    }
+} // namespace
+
+TEST(IncrementalHashMapTest, BasicOperations)
+{
+    Map map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(1), map.end());
+    EXPECT_EQ(map.begin(), map.end());
+
+    EXPECT_TRUE(map.insert(1, "one"));
+    EXPECT_FALSE(map.insert(1, "uno"));
+    EXPECT_TRUE(map.emplace(2, "two").second);
+    EXPECT_EQ(map.at(1), "one");
+    EXPECT_THROW(map.at(3), std::out_of_range);
+
+    EXPECT_FALSE(map.insert_or_assign(1, "uno").second);
+    map[4] = "four";
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map.at(1), "uno");
+
+    EXPECT_TRUE(map.erase(2));
+    EXPECT_FALSE(map.erase(2));
+    EXPECT_EQ(map.size(), 2);
+}
+
+// Growth moves entries over in batches instead of all at once
+TEST(IncrementalHashMapTest, GrowthMigratesInBatches)
+{
+    Map map;
+    const uint64_t keys = fill_until_migrating(map, 0);
+    const size_t capacity = map.capacity();
+    EXPECT_EQ(map.size(), keys);
+
+    uint64_t key = keys;
+    size_t mutations = 0;
+    while (map.migrating())
+    {
+        map.insert(key, std::to_string(key));
+        ++key;
+        ++mutations;
+    }
+    EXPECT_GE(mutations, (keys - 1) / Map::kMigrationBatch);
+    EXPECT_LE(mutations, keys / Map::kMigrationBatch + 1);
+    EXPECT_EQ(map.capacity(), capacity);
+
+    for (uint64_t k = 0; k < key; ++k)
+    {
+        ASSERT_EQ(map.at(k), std::to_string(k)) << k;
+    }
+}
+
+TEST(IncrementalHashMapTest, OperationsDuringMigration)
+{
+    Map map;
+    std::unordered_map<uint64_t, std::string> reference;
+    std::mt19937_64 rng(17);
+
+    for (int round = 0; round < 4; ++round)
+    {
+        const uint64_t base = static_cast<uint64_t>(round) << 32;
+        const uint64_t end = fill_until_migrating(map, base);
+        for (uint64_t key = base; key < end; ++key)
+        {
+            reference.emplace(key, std::to_string(key));
+        }
+
+        // Keys still in the draining table are found, updated and erased through the map
+        while (map.migrating())
+        {
+            const uint64_t key = base + rng() % (end - base + 100);
+            switch (rng() % 4)
+            {
+            case 0:
+                EXPECT_EQ(map.insert(key, "v"), reference.emplace(key, "v").second);
+                break;
+            case 1:
+                EXPECT_EQ(map.insert_or_assign(key, "w").second, !reference.contains(key));
+                reference[key] = "w";
+                break;
+            case 2:
+                EXPECT_EQ(map.erase(key), reference.erase(key) == 1);
+                break;
+            default:
+                map[key] += "x";
+                reference[key] += "x";
+                break;
+            }
+            ASSERT_EQ(map.size(), reference.size());
+        }
+        expect_matches(map, reference);
+    }
+}
+
+TEST(IncrementalHashMapTest, EraseWhileIteratingDuringMigration)
+{
+    Map map;
+    std::unordered_map<uint64_t, std::string> reference;
+    const uint64_t end = fill_until_migrating(map, 0);
+    for (int i = 0; i < 10; ++i)
+    {
+        map.insert(end + i, std::to_string(end + i));
+    }
+    ASSERT_TRUE(map.migrating());
+    for (uint64_t key = 0; key < end + 10; ++key)
+    {
+        reference.emplace(key, std::to_string(key));
+    }
+
+    for (auto it = map.begin(); it != map.end();)
+    {
+        if (it->first % 2 == 0)
+        {
+            it = map.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    std::erase_if(reference, [](const auto& entry) { return entry.first % 2 == 0; });
+    EXPECT_TRUE(map.migrating());
+    expect_matches(map, reference);
+
+    map.finish_migration();
+    EXPECT_FALSE(map.migrating());
+    expect_matches(map, reference);
+}
+
+TEST(IncrementalHashMapTest, CopyAndMoveDuringMigration)
+{
+    Map map;
+    const uint64_t end = fill_until_migrating(map, 0);
+    map.insert(end, std::to_string(end));
+    ASSERT_TRUE(map.migrating());
+
+    std::unordered_map<uint64_t, std::string> reference;
+    for (uint64_t key = 0; key <= end; ++key)
+    {
+        reference.emplace(key, std::to_string(key));
+    }
+
+    Map copy(map);
+    expect_matches(copy, reference);
+
+    Map moved(std::move(copy));
+    expect_matches(moved, reference);
+
+    // Finishing the migration of the moved map continues where the copy left off
+    for (uint64_t key = end + 1; moved.migrating(); ++key)
+    {
+        moved.insert(key, std::to_string(key));
+        reference.emplace(key, std::to_string(key));
+    }
+    expect_matches(moved, reference);
+
+    map = std::move(moved);
+    expect_matches(map, reference);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.migrating());
+    EXPECT_TRUE(map.insert(1, "one"));
+}
+
+TEST(IncrementalHashMapTest, HeterogeneousLookup)
+{
+    optimap::IncrementalHashMap<std::string, int> map;
+    for (int i = 0; i < 5000; ++i)
+    {
+        map.insert(std::to_string(i), i);
+    }
+    EXPECT_EQ(map.find(std::string_view("1234"))->second, 1234);
+    EXPECT_TRUE(map.contains(std::string_view("4999")));
+    EXPECT_FALSE(map.contains(std::string_view("5000")));
+}
@@ -0,0 +1,273 @@
+#include "indirect_hashmap.hpp"
+
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct LargeValue
+    {
+        explicit LargeValue(uint64_t seed = 0)
+        {
+            payload.fill(seed);
+        }
+
+        std::array<uint64_t, 56> payload;
+    };
+
+    // Counts live instances to check that every value is destroyed exactly once
+    struct Tracked
+    {
+        static inline int live = 0;
+
+        explicit Tracked(int v = 0) : value(v)
+        {
+            ++live;
+        }
+        Tracked(const Tracked& other) : value(other.value)
+        {
+            ++live;
+        }
+        ~Tracked()
+        {
+            --live;
+        }
+        Tracked& operator=(const Tracked&) = default;
+
+        int value;
+    };
+} // namespace
+
+TEST(IndirectHashMapTest, BasicOperations)
+{
+    optimap::IndirectHashMap<int, std::string> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(1), map.end());
+
+    EXPECT_TRUE(map.insert(1, "one"));
+    EXPECT_FALSE(map.insert(1, "uno"));
+    EXPECT_TRUE(map.emplace(2, "two"));
+    EXPECT_EQ(map.at(1), "one");
+    EXPECT_THROW(map.at(3), std::out_of_range);
+
+    EXPECT_FALSE(map.insert_or_assign(1, "uno"));
+    EXPECT_TRUE(map.insert_or_assign(3, "three"));
+    map[4] = "four";
+    EXPECT_EQ(map.size(), 4);
+    EXPECT_EQ(map.at(1), "uno");
+
+    auto it = map.find(2);
+    ASSERT_NE(it, map.end());
+    EXPECT_EQ(it->first, 2);
+    EXPECT_EQ(it->second, "two");
+    it->second = "dos";
+    EXPECT_EQ(map.at(2), "dos");
+
+    EXPECT_TRUE(map.erase(2));
+    EXPECT_FALSE(map.erase(2));
+    EXPECT_FALSE(map.contains(2));
+    EXPECT_EQ(map.size(), 3);
+
+    map.erase(map.find(3));
+    EXPECT_FALSE(map.contains(3));
+    EXPECT_EQ(map.size(), 2);
+}
+
+// The reason for the layout: references to values survive any amount of growth
+TEST(IndirectHashMapTest, ValueAddressesAreStableAcrossGrowth)
+{
+    optimap::IndirectHashMap<uint64_t, LargeValue> map;
+    std::vector<const LargeValue*> addresses;
+    for (uint64_t key = 0; key < 100; ++key)
+    {
+        map.try_emplace(key, key);
+        addresses.push_back(&map.at(key));
+    }
+
+    const size_t capacity = map.capacity();
+    for (uint64_t key = 100; key < 100000; ++key)
+    {
+        map.try_emplace(key, key);
+    }
+    ASSERT_GT(map.capacity(), capacity);
+
+    for (uint64_t key = 0; key < 100; ++key)
+    {
+        EXPECT_EQ(&map.at(key), addresses[key]);
+        EXPECT_EQ(map.at(key).payload[55], key);
+    }
+}
+
+TEST(IndirectHashMapTest, RandomOperationsMatchReference)
+{
+    optimap::IndirectHashMap<uint64_t, uint64_t> map;
+    std::unordered_map<uint64_t, uint64_t> reference;
+    std::mt19937_64 rng(31);
+
+    for (int step = 0; step < 100000; ++step)
+    {
+        const uint64_t key = rng() % 2000;
+        switch (rng() % 3)
+        {
+        case 0:
+            EXPECT_EQ(map.insert(key, step), reference.emplace(key, step).second);
+            break;
+        case 1:
+            EXPECT_EQ(map.insert_or_assign(key, step), !reference.contains(key));
+            reference[key] = step;
+            break;
+        default:
+            EXPECT_EQ(map.erase(key), reference.erase(key) == 1);
+            break;
+        }
+        ASSERT_EQ(map.size(), reference.size());
+    }
+
+    size_t visited = 0;
+    for (const auto& entry : map)
+    {
+        ASSERT_TRUE(reference.contains(entry.first));
+        EXPECT_EQ(entry.second, reference[entry.first]);
+        ++visited;
+    }
+    EXPECT_EQ(visited, reference.size());
+}
+
+TEST(IndirectHashMapTest, ValuesAreDestroyedExactlyOnce)
+{
+    {
+        optimap::IndirectHashMap<int, Tracked> map;
+        for (int i = 0; i < 1000; ++i)
+        {
+            map.try_emplace(i, i);
+        }
+        EXPECT_EQ(Tracked::live, 1000);
+
+        for (int i = 0; i < 500; ++i)
+        {
+            map.erase(i);
+        }
+        EXPECT_EQ(Tracked::live, 500);
+
+        // Erased cells are reused
+        for (int i = 0; i < 500; ++i)
+        {
+            map.try_emplace(i, i);
+        }
+        EXPECT_EQ(Tracked::live, 1000);
+
+        optimap::IndirectHashMap<int, Tracked> copy(map);
+        EXPECT_EQ(Tracked::live, 2000);
+        EXPECT_EQ(copy.at(999).value, 999);
+
+        copy.clear();
+        EXPECT_EQ(Tracked::live, 1000);
+        EXPECT_TRUE(copy.empty());
+
+        copy = map;
+        EXPECT_EQ(Tracked::live, 2000);
+
+        optimap::IndirectHashMap<int, Tracked> moved(std::move(copy));
+        EXPECT_EQ(Tracked::live, 2000);
+
+        moved = std::move(map);
+        EXPECT_EQ(Tracked::live, 1000);
+        EXPECT_EQ(moved.at(7).value, 7);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+TEST(IndirectHashMapTest, ThrowingValueConstructorLeavesNoEntry)
+{
+    struct Throws
+    {
+        explicit Throws(bool fail)
+        {
+            if (fail)
+            {
+                throw std::runtime_error("construction failed");
+            }
+        }
+    };
+
+    optimap::IndirectHashMap<int, Throws> map;
+    map.try_emplace(1, false);
+    EXPECT_THROW(map.try_emplace(2, true), std::runtime_error);
+    EXPECT_FALSE(map.contains(2));
+    EXPECT_EQ(map.size(), 1);
+    EXPECT_TRUE(map.try_emplace(2, false).second);
+}
+
+// The copy takes the source's table and cells as is, so it iterates in the same order, and a
+// value copy that throws destroys the values already copied
+TEST(IndirectHashMapTest, CopyKeepsLayout)
+{
+    struct CopyThrows : Tracked
+    {
+        using Tracked::Tracked;
+        CopyThrows(const CopyThrows& other) : Tracked(other)
+        {
+            if (other.value == 700)
+            {
+                throw std::runtime_error("copy failed");
+            }
+        }
+    };
+
+    using ThrowingMap = optimap::IndirectHashMap<int, CopyThrows>;
+
+    {
+        ThrowingMap map;
+        for (int i = 0; i < 1000; ++i)
+        {
+            map.try_emplace(i, i);
+        }
+        for (int i = 0; i < 1000; i += 3)
+        {
+            map.erase(i);
+        }
+
+        optimap::IndirectHashMap<int, Tracked> tracked;
+        for (const auto& entry : map)
+        {
+            tracked.try_emplace(entry.first, entry.second.value);
+        }
+        const optimap::IndirectHashMap<int, Tracked> copy(tracked);
+        auto it = copy.begin();
+        for (const auto& entry : tracked)
+        {
+            ASSERT_NE(it, copy.end());
+            EXPECT_EQ(it->first, entry.first);
+            EXPECT_EQ(it->second.value, entry.second.value);
+            ++it;
+        }
+        EXPECT_EQ(it, copy.end());
+
+        const int live = Tracked::live;
+        EXPECT_THROW(ThrowingMap{map}, std::runtime_error);
+        EXPECT_EQ(Tracked::live, live);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+TEST(IndirectHashMapTest, HeterogeneousLookup)
+{
+    optimap::IndirectHashMap<std::string, int> map;
+    map.insert("alpha", 1);
+    map.try_emplace(std::string_view("beta"), 2);
+
+    EXPECT_TRUE(map.contains(std::string_view("alpha")));
+    EXPECT_EQ(map.at("beta"), 2);
+    EXPECT_NE(map.find(std::string_view("beta")), map.end());
+    EXPECT_TRUE(map.erase(std::string_view("alpha")));
+    EXPECT_FALSE(map.contains("alpha"));
+}
@@ -0,0 +1,124 @@
+#include "hashmap.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Sends one key in 1024 to the last slot of the table, so its probe window wraps around the
+// end and can never be placed by a partition worker
+struct WrappingHash
+{
+    size_t operator()(uint64_t key) const
+    {
+        const size_t hash = optimap::GxHash<uint64_t>{}(key);
+        return key % 1024 == 0 ? hash | ((size_t{1} << 57) - 1) : hash;
+    }
+};
+
+template <typename Map, typename Reference>
+static void expect_same(const Map& map, const Reference& reference)
+{
+    ASSERT_EQ(map.size(), reference.size());
+    for (const auto& [key, value] : reference)
+    {
+        auto it = map.find(key);
+        ASSERT_NE(it, map.end());
+        EXPECT_EQ(it->second, value);
+    }
+
+    size_t visited = 0;
+    for (const auto& entry : map)
+    {
+        EXPECT_TRUE(reference.contains(entry.first));
+        ++visited;
+    }
+    EXPECT_EQ(visited, reference.size());
+}
+
+TEST(ParallelBuildTest, FromRangeMatchesSequentialEmplace)
+{
+    std::mt19937_64 rng(3);
+    std::vector<std::pair<uint64_t, uint64_t>> pairs;
+    std::unordered_map<uint64_t, uint64_t> reference;
+    for (uint64_t i = 0; i < 200000; ++i)
+    {
+        // Plenty of repeated keys: the first occurrence must win
+        const uint64_t key = rng() % 120000;
+        pairs.emplace_back(key, i);
+        reference.emplace(key, i);
+    }
+
+    for (size_t threads : {1, 2, 4, 7})
+    {
+        auto map = optimap::HashMap<uint64_t, uint64_t>::from_range(pairs, threads);
+        expect_same(map, reference);
+    }
+}
+
+TEST(ParallelBuildTest, FromRangeHandlesWrappingProbes)
+{
+    std::vector<std::pair<uint64_t, uint64_t>> pairs;
+    std::unordered_map<uint64_t, uint64_t> reference;
+    for (uint64_t key = 0; key < 100000; ++key)
+    {
+        pairs.emplace_back(key, key * 3);
+        reference.emplace(key, key * 3);
+    }
+
+    auto map = optimap::HashMap<uint64_t, uint64_t, WrappingHash>::from_range(pairs, 4);
+    expect_same(map, reference);
+
+    // The map stays fully usable after the bulk build
+    EXPECT_TRUE(map.erase(1024));
+    EXPECT_TRUE(map.insert(1024, 1));
+    EXPECT_EQ(map.at(1024), 1);
+}
+
+TEST(ParallelBuildTest, FromRangeOfStrings)
+{
+    std::vector<std::pair<std::string, int>> pairs;
+    for (int i = 0; i < 70000; ++i)
+    {
+        pairs.emplace_back("key_" + std::to_string(i % 50000), i);
+    }
+
+    using StoredHashMap = optimap::HashMap<std::string, int, optimap::GxHash<std::string>, true>;
+    auto map = StoredHashMap::from_range(pairs, 4);
+    ASSERT_EQ(map.size(), 50000);
+    EXPECT_EQ(map.at("key_0"), 0);
+    EXPECT_EQ(map.at("key_49999"), 49999);
+    EXPECT_FALSE(map.contains("key_50000"));
+
+    EXPECT_EQ(StoredHashMap::from_range(std::vector<std::pair<std::string, int>>{}, 4).size(), 0);
+}
+
+TEST(ParallelBuildTest, ParallelRehashOnGrowth)
+{
+    optimap::HashMap<uint64_t, std::string, WrappingHash> map;
+    map.set_rehash_threads(4);
+    EXPECT_EQ(map.rehash_threads(), 4);
+
+    std::unordered_map<uint64_t, std::string> reference;
+    for (uint64_t key = 0; key < 300000; ++key)
+    {
+        map.insert(key, std::to_string(key));
+        reference.emplace(key, std::to_string(key));
+        if (key % 5 == 0)
+        {
+            map.erase(key / 2);
+            reference.erase(key / 2);
+        }
+    }
+    expect_same(map, reference);
+
+    // Explicit rehash and copies keep the setting and the entries
+    map.rehash(map.capacity() * 2);
+    expect_same(map, reference);
+    auto copy = map;
+    EXPECT_EQ(copy.rehash_threads(), 4);
+    expect_same(copy, reference);
+}
@@ -0,0 +1,193 @@
+#include "hashmap.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    template <typename Policy>
+    using PolicyMap = optimap::HashMap<
+            uint64_t,
+            uint64_t,
+            optimap::GxHash<uint64_t>,
+            false,
+            AlignedAllocator<std::pair<const uint64_t, uint64_t>, 64>,
+            Policy>;
+
+    // Sends every key to one of a few home slots, so probes run long and wrap around
+    struct FewHomesHash
+    {
+        size_t operator()(uint64_t key) const
+        {
+            const size_t h2_part = static_cast<size_t>(key % 127) << (sizeof(size_t) * 8 - 7);
+            return h2_part | ((key % 3) * 1000003);
+        }
+    };
+
+    template <typename Map> void expect_matches(const Map& map, const auto& reference)
+    {
+        ASSERT_EQ(map.size(), reference.size());
+        size_t visited = 0;
+        for (const auto& entry : map)
+        {
+            ASSERT_EQ(reference.at(entry.first), entry.second);
+            ++visited;
+        }
+        EXPECT_EQ(visited, reference.size());
+        for (const auto& [key, value] : reference)
+        {
+            ASSERT_EQ(map.at(key), value) << key;
+        }
+    }
+
+    template <typename Map> void random_operations_match_reference()
+    {
+        Map map;
+        std::unordered_map<uint64_t, uint64_t> reference;
+        std::mt19937_64 rng(23);
+
+        for (int step = 0; step < 200000; ++step)
+        {
+            const uint64_t key = rng() % 5000;
+            if (rng() % 3 == 0)
+            {
+                ASSERT_EQ(map.erase(key), reference.erase(key) == 1);
+            }
+            else
+            {
+                ASSERT_EQ(map.insert(key, step), reference.emplace(key, step).second);
+            }
+        }
+        expect_matches(map, reference);
+    }
+
+    template <typename Policy> void sequence_visits_every_group()
+    {
+        constexpr size_t kCapacity = 64 * optimap::detail::kGroupWidth;
+        for (const size_t hash : {size_t{0}, size_t{5}, size_t{12345}, ~size_t{0}})
+        {
+            std::vector<int> visits(kCapacity / optimap::detail::kGroupWidth, 0);
+            typename Policy::Sequence seq(hash, kCapacity - 1);
+            for (size_t step = 0; step < visits.size(); ++step, seq.next())
+            {
+                const size_t group = seq.offset() / optimap::detail::kGroupWidth;
+                ++visits[group];
+                EXPECT_EQ(Policy::probe_length(hash, seq.offset(5), kCapacity - 1), step + 1);
+            }
+            for (const int count : visits)
+            {
+                EXPECT_EQ(count, 1) << hash;
+            }
+        }
+    }
+} // namespace
+
+TEST(ProbePolicyTest, SequencesVisitEveryGroupOnce)
+{
+    sequence_visits_every_group<optimap::LinearProbing>();
+    sequence_visits_every_group<optimap::TriangularProbing>();
+}
+
+TEST(ProbePolicyTest, TriangularGroupsAreAligned)
+{
+    optimap::TriangularProbing::Sequence seq(12345, 1023);
+    for (int step = 0; step < 64; ++step, seq.next())
+    {
+        EXPECT_EQ(seq.offset() % optimap::detail::kGroupWidth, 0);
+    }
+}
+
+TEST(ProbePolicyTest, RandomOperationsMatchReference)
+{
+    random_operations_match_reference<PolicyMap<optimap::LinearProbing>>();
+    random_operations_match_reference<PolicyMap<optimap::TriangularProbing>>();
+}
+
+// Long probes from a handful of home slots exercise wrap-around and tombstone cleanup
+TEST(ProbePolicyTest, ClusteredKeysWithChurn)
+{
+    optimap::HashMap<
+            uint64_t,
+            uint64_t,
+            FewHomesHash,
+            true,
+            AlignedAllocator<std::pair<const uint64_t, uint64_t>, 64>,
+            optimap::TriangularProbing>
+            map;
+    map.set_probe_limit(0);
+    std::unordered_map<uint64_t, uint64_t> reference;
+
+    for (uint64_t key = 0; key < 3000; ++key)
+    {
+        map.insert(key, key);
+        reference.emplace(key, key);
+    }
+    const size_t capacity = map.capacity();
+    for (uint64_t key = 3000; key < 30000; ++key)
+    {
+        ASSERT_TRUE(map.erase(key - 3000));
+        reference.erase(key - 3000);
+        ASSERT_TRUE(map.insert(key, key));
+        reference.emplace(key, key);
+    }
+    EXPECT_EQ(map.capacity(), capacity);
+    expect_matches(map, reference);
+
+    const optimap::TableStats stats = map.stats(100000);
+    EXPECT_EQ(stats.sampled_keys, map.size());
+    EXPECT_GT(stats.max_probe_length, 1);
+}
+
+TEST(ProbePolicyTest, ParallelPlacementWithTriangularProbing)
+{
+    std::vector<std::pair<uint64_t, uint64_t>> pairs;
+    std::mt19937_64 rng(3);
+    for (int i = 0; i < 300000; ++i)
+    {
+        const uint64_t key = rng() % 200000;
+        pairs.emplace_back(key, i);
+    }
+
+    using Map = PolicyMap<optimap::TriangularProbing>;
+    Map built = Map::from_range(pairs, 4);
+    std::unordered_map<uint64_t, uint64_t> reference;
+    for (const auto& [key, value] : pairs)
+    {
+        reference.emplace(key, value);
+    }
+    expect_matches(built, reference);
+
+    Map grown;
+    grown.set_rehash_threads(4);
+    for (const auto& [key, value] : pairs)
+    {
+        grown.insert(key, value);
+    }
+    expect_matches(grown, reference);
+}
+
+TEST(ProbePolicyTest, SavedTablesRecordThePolicy)
+{
+    PolicyMap<optimap::TriangularProbing> map;
+    for (uint64_t key = 0; key < 1000; ++key)
+    {
+        map.insert(key, key * 3);
+    }
+
+    std::stringstream stream;
+    map.write_to(stream);
+    const std::string bytes = stream.str();
+
+    std::stringstream same(bytes);
+    const auto loaded = PolicyMap<optimap::TriangularProbing>::read_from(same);
+    EXPECT_EQ(loaded.at(999), 2997);
+
+    std::stringstream other(bytes);
+    EXPECT_THROW(PolicyMap<optimap::LinearProbing>::read_from(other), std::runtime_error);
+}
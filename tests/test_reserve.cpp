@@ -0,0 +1,137 @@
+#include "hashmap.hpp"
+
+#include <gtest/gtest.h>
+
+// Counts how often the hash function runs to observe the number of rehash passes
+struct ReserveCountingHash
+{
+    static inline size_t calls = 0;
+
+    size_t operator()(int key) const
+    {
+        ++calls;
+        return optimap::GxHash<int>{}(key);
+    }
+};
+
+TEST(ReserveTest, ReserveEmptyMap)
+{
+    optimap::HashMap<int, int> map;
+    map.reserve(1000);
+
+    // 1000 / 0.875 rounds up to 1143, so the next power of 2 is 2048
+    EXPECT_EQ(map.capacity(), 2048);
+    EXPECT_EQ(map.size(), 0);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        map.insert(i, i);
+    }
+    EXPECT_EQ(map.capacity(), 2048); // No growth while filling the reserved space
+}
+
+TEST(ReserveTest, ReserveExactLoadLimit)
+{
+    optimap::HashMap<int, int> map;
+
+    // 14 elements fit exactly under the max load factor of 16 slots
+    map.reserve(14);
+    EXPECT_EQ(map.capacity(), 16);
+    map.reserve(15);
+    EXPECT_EQ(map.capacity(), 32);
+}
+
+TEST(ReserveTest, ReservePopulatedMapSingleMigration)
+{
+    optimap::HashMap<int, int, ReserveCountingHash> map;
+    for (int i = 0; i < 100; ++i)
+    {
+        map.insert(i, i * 2);
+    }
+
+    ReserveCountingHash::calls = 0;
+    map.reserve(100000);
+
+    // One migration hashes every live key exactly once
+    EXPECT_EQ(ReserveCountingHash::calls, 100);
+    EXPECT_EQ(map.capacity(), 131072);
+    EXPECT_EQ(map.size(), 100);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        auto it = map.find(i);
+        ASSERT_NE(it, map.end());
+        EXPECT_EQ(it->second, i * 2);
+    }
+}
+
+TEST(ReserveTest, ReserveNeverShrinks)
+{
+    optimap::HashMap<int, int> map(1024);
+    map.insert(1, 1);
+    map.reserve(10);
+    EXPECT_EQ(map.capacity(), 1024);
+}
+
+TEST(RehashTest, RehashGrowsToRequestedSlots)
+{
+    optimap::HashMap<int, int> map;
+    for (int i = 0; i < 10; ++i)
+    {
+        map.insert(i, i);
+    }
+
+    map.rehash(500);
+    EXPECT_EQ(map.capacity(), 512);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_TRUE(map.contains(i));
+    }
+}
+
+TEST(RehashTest, RehashShrinksToFit)
+{
+    optimap::HashMap<int, int> map;
+    for (int i = 0; i < 1000; ++i)
+    {
+        map.insert(i, i);
+    }
+    for (int i = 20; i < 1000; ++i)
+    {
+        map.erase(i);
+    }
+
+    map.rehash(0);
+    EXPECT_EQ(map.capacity(), 32);
+    EXPECT_EQ(map.size(), 20);
+    for (int i = 0; i < 20; ++i)
+    {
+        auto it = map.find(i);
+        ASSERT_NE(it, map.end());
+        EXPECT_EQ(it->second, i);
+    }
+    EXPECT_FALSE(map.contains(500));
+}
+
+TEST(RehashTest, RehashNeverDropsBelowSize)
+{
+    optimap::HashMap<int, int> map;
+    for (int i = 0; i < 100; ++i)
+    {
+        map.insert(i, i);
+    }
+
+    map.rehash(16);
+    EXPECT_EQ(map.capacity(), 128);
+    EXPECT_EQ(map.size(), 100);
+}
+
+TEST(RehashTest, RehashEmptyMapReleasesStorage)
+{
+    optimap::HashMap<int, int> map(256);
+    map.rehash(0);
+    EXPECT_EQ(map.capacity(), 0);
+
+    map.insert(7, 7);
+    EXPECT_TRUE(map.contains(7));
+}
@@ -0,0 +1,262 @@
+#include "hashmap.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    // Every key starts probing at slot 0, but the full hashes differ, so a seed can spread them
+    struct SameHomeHash
+    {
+        size_t operator()(uint64_t key) const noexcept
+        {
+            return static_cast<size_t>(key) << 32;
+        }
+    };
+
+    // Full collisions: no seed can help
+    struct ConstantHash
+    {
+        size_t operator()(uint64_t) const noexcept
+        {
+            return 0;
+        }
+    };
+} // namespace
+
+TEST(SeedingTest, SeededGxHashMatchesUnseededAtZero)
+{
+    const optimap::GxHash<uint64_t> hash;
+    EXPECT_EQ(hash(42, 0), hash(42));
+    EXPECT_NE(hash(42, 1), hash(42));
+
+    const optimap::GxHash<std::string> string_hash;
+    EXPECT_EQ(string_hash("forty-two", 0), string_hash(std::string("forty-two")));
+    EXPECT_NE(string_hash("forty-two", 7), string_hash("forty-two"));
+
+    optimap::HashMap<uint64_t, uint64_t> map;
+    EXPECT_EQ(map.seed(), 0);
+    EXPECT_EQ(map.probe_limit(), map.kDefaultProbeLimit);
+}
+
+TEST(SeedingTest, ReseedKeepsEveryEntry)
+{
+    optimap::HashMap<std::string, int, optimap::GxHash<std::string>, true> map;
+    for (int i = 0; i < 5000; ++i)
+    {
+        map.insert(std::to_string(i), i);
+    }
+    const size_t capacity = map.capacity();
+
+    map.reseed(12345);
+    EXPECT_EQ(map.seed(), 12345);
+    EXPECT_EQ(map.capacity(), capacity);
+    EXPECT_EQ(map.size(), 5000);
+    for (int i = 0; i < 5000; ++i)
+    {
+        auto it = map.find(std::to_string(i));
+        ASSERT_NE(it, map.end());
+        EXPECT_EQ(it->second, i);
+    }
+
+    // Copies take the seed along with the table; a moved-from map goes back to seed 0
+    auto copy = map;
+    EXPECT_EQ(copy.seed(), 12345);
+    EXPECT_TRUE(copy.contains("4999"));
+    auto moved = std::move(copy);
+    EXPECT_EQ(moved.seed(), 12345);
+    EXPECT_EQ(copy.seed(), 0);
+
+    map.reseed();
+    EXPECT_NE(map.seed(), 0);
+    EXPECT_NE(map.seed(), 12345);
+    EXPECT_TRUE(map.contains("0"));
+}
+
+TEST(SeedingTest, UnseededHashersAreRemixed)
+{
+    optimap::HashMap<uint64_t, uint64_t, SameHomeHash> map;
+    map.set_probe_limit(0);
+    for (uint64_t key = 0; key < 1000; ++key)
+    {
+        map.insert(key, key);
+    }
+    EXPECT_GT(map.stats(1000).max_probe_length, 10);
+
+    map.reseed(99);
+    EXPECT_LT(map.stats(1000).max_probe_length, 5);
+    for (uint64_t key = 0; key < 1000; ++key)
+    {
+        ASSERT_TRUE(map.contains(key));
+    }
+}
+
+TEST(SeedingTest, WatchdogReseedsClusteredTable)
+{
+    // Every key's home is slot 0, so key n lands in slot n and its probe loads
+    // n / kGroupWidth + 1 groups. The first insertion that loads probe_limit() groups fires
+    {
+        constexpr size_t kLimit = 4;
+        optimap::HashMap<uint64_t, uint64_t, SameHomeHash> boundary(1024);
+        boundary.set_probe_limit(kLimit);
+        const uint64_t below = (kLimit - 1) * optimap::detail::kGroupWidth;
+        for (uint64_t key = 0; key < below; ++key)
+        {
+            boundary.insert(key, key);
+        }
+        EXPECT_EQ(boundary.seed(), 0);
+        boundary.insert(below, below);
+        EXPECT_NE(boundary.seed(), 0);
+    }
+
+    optimap::HashMap<uint64_t, uint64_t, SameHomeHash> map;
+    map.set_probe_limit(4);
+    for (uint64_t key = 0; key < 1000; ++key)
+    {
+        map.insert(key, key);
+    }
+    EXPECT_NE(map.seed(), 0);
+    EXPECT_LT(map.stats(1000).max_probe_length, 8);
+    for (uint64_t key = 0; key < 1000; ++key)
+    {
+        ASSERT_TRUE(map.contains(key));
+    }
+
+    optimap::HashMap<uint64_t, uint64_t, SameHomeHash> unwatched;
+    unwatched.set_probe_limit(0);
+    EXPECT_EQ(unwatched.probe_limit(), 0);
+    for (uint64_t key = 0; key < 1000; ++key)
+    {
+        unwatched.insert(key, key);
+    }
+    EXPECT_EQ(unwatched.seed(), 0);
+}
+
+// The watchdog's record of the capacity it last fired at travels with the table, so a table
+// moved in, or the emptied source of a move, is still watched
+TEST(SeedingTest, WatchdogStateMovesWithTheTable)
+{
+    using Map = optimap::HashMap<uint64_t, uint64_t, SameHomeHash>;
+    const auto fill = [](Map& map) {
+        map.set_probe_limit(4);
+        for (uint64_t key = 0; key < 1000; ++key)
+        {
+            map.insert(key, key);
+        }
+    };
+
+    Map fired(4096);
+    fill(fired);
+    ASSERT_NE(fired.seed(), 0);
+
+    Map fresh(4096);
+    ASSERT_EQ(fresh.capacity(), fired.capacity());
+    fired = std::move(fresh);
+    fill(fired);
+    EXPECT_NE(fired.seed(), 0);
+
+    Map moved(std::move(fired));
+    fired.reserve(3000);
+    ASSERT_EQ(fired.capacity(), moved.capacity());
+    fill(fired);
+    EXPECT_NE(fired.seed(), 0);
+}
+
+// Reseeding cannot fix full collisions. The watchdog gives up after one try per capacity
+// instead of rehashing on every insertion (counted in test_counters.cpp)
+TEST(SeedingTest, WatchdogToleratesFullCollisions)
+{
+    optimap::HashMap<uint64_t, uint64_t, ConstantHash> map(1024);
+    map.set_probe_limit(2);
+    for (uint64_t key = 0; key < 800; ++key)
+    {
+        map.insert(key, key);
+    }
+    EXPECT_EQ(map.capacity(), 1024);
+    EXPECT_EQ(map.size(), 800);
+    for (uint64_t key = 0; key < 800; ++key)
+    {
+        ASSERT_TRUE(map.contains(key));
+    }
+}
+
+// Iterating a map and inserting into a new one hands the new map its keys sorted by their
+// home slot under the shared seed. The watchdog reseeds the new map before the clusters this
+// builds get long
+TEST(SeedingTest, CopyInIterationOrderIsReseeded)
+{
+    std::mt19937_64 rng(12345);
+    optimap::HashMap<uint64_t, uint64_t> source;
+    for (int i = 0; i < 90000; ++i)
+    {
+        source[rng()] = i;
+    }
+
+    optimap::HashMap<uint64_t, uint64_t> copy;
+    for (const auto& entry : source)
+    {
+        copy[entry.first] = entry.second;
+    }
+    EXPECT_NE(copy.seed(), 0);
+    EXPECT_EQ(copy.size(), source.size());
+    for (const auto& entry : source)
+    {
+        ASSERT_TRUE(copy.contains(entry.first));
+    }
+}
+
+TEST(SeedingTest, SerializationKeepsTheSeed)
+{
+    optimap::HashMap<uint64_t, uint64_t> map;
+    map.reseed(777);
+    for (uint64_t key = 0; key < 1000; ++key)
+    {
+        map.insert(key, key * 2);
+    }
+
+    std::stringstream stream;
+    map.write_to(stream);
+    const auto loaded = optimap::HashMap<uint64_t, uint64_t>::read_from(stream);
+    EXPECT_EQ(loaded.seed(), 777);
+    for (uint64_t key = 0; key < 1000; ++key)
+    {
+        ASSERT_EQ(loaded.at(key), key * 2);
+    }
+}
+
+// The prehashed entry points take the seed-0 hash and agree with the plain ones under any seed,
+// for seeded and remixed hashers alike
+template <typename Hash> static void expect_prehashed_matches_plain()
+{
+    using Map = optimap::HashMap<uint64_t, uint64_t, Hash>;
+    for (const uint64_t seed : {uint64_t{0}, uint64_t{0x1234567}})
+    {
+        Map map;
+        map.reseed(seed);
+        for (uint64_t key = 0; key < 1000; ++key)
+        {
+            EXPECT_TRUE(map.try_emplace_prehashed(key, Map::unseeded_hash(key), key).second);
+        }
+        EXPECT_FALSE(map.try_emplace_prehashed(uint64_t{7}, Map::unseeded_hash(7), 0).second);
+
+        map.reseed(seed + 1);
+        for (uint64_t key = 0; key < 1000; ++key)
+        {
+            ASSERT_NE(map.find(key), map.end()) << key;
+            EXPECT_EQ(map.find_prehashed(key, Map::unseeded_hash(key)), map.find(key));
+        }
+        EXPECT_TRUE(map.erase_prehashed(3, Map::unseeded_hash(3)));
+        EXPECT_FALSE(map.contains(3));
+        EXPECT_EQ(map.find_prehashed(3, Map::unseeded_hash(3)), map.end());
+        EXPECT_EQ(map.size(), 999);
+    }
+}
+
+TEST(SeedingTest, PrehashedEntryPointsMatchPlainOnes)
+{
+    expect_prehashed_matches_plain<optimap::GxHash<uint64_t>>();
+    expect_prehashed_matches_plain<SameHomeHash>();
+}
@@ -0,0 +1,170 @@
+#include "hashmap.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using U64Map = optimap::HashMap<uint64_t, uint64_t>;
+
+static U64Map make_map(uint64_t n)
+{
+    U64Map map;
+    for (uint64_t key = 0; key < n; ++key)
+    {
+        map.insert(key, key * 7);
+    }
+    // Tombstones are saved as they are
+    for (uint64_t key = 0; key < n; key += 5)
+    {
+        map.erase(key);
+    }
+    return map;
+}
+
+static void expect_contents(const U64Map& map, uint64_t n)
+{
+    for (uint64_t key = 0; key < n; ++key)
+    {
+        if (key % 5 == 0)
+        {
+            ASSERT_FALSE(map.contains(key));
+        }
+        else
+        {
+            ASSERT_EQ(map.at(key), key * 7);
+        }
+    }
+    size_t visited = 0;
+    for (const auto& entry : map)
+    {
+        EXPECT_EQ(entry.second, entry.first * 7);
+        ++visited;
+    }
+    EXPECT_EQ(visited, map.size());
+}
+
+class SerializationTest : public ::testing::Test
+{
+  protected:
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    std::string path = ::testing::TempDir() + "optimap_serialization_test.bin";
+};
+
+TEST_F(SerializationTest, StreamRoundTrip)
+{
+    const U64Map map = make_map(10000);
+    std::stringstream stream;
+    map.write_to(stream);
+
+    const U64Map loaded = U64Map::read_from(stream);
+    EXPECT_EQ(loaded.size(), map.size());
+    EXPECT_EQ(loaded.capacity(), map.capacity());
+    expect_contents(loaded, 10000);
+
+    std::stringstream empty_stream;
+    U64Map().write_to(empty_stream);
+    EXPECT_EQ(U64Map::read_from(empty_stream).size(), 0);
+}
+
+TEST_F(SerializationTest, OpenMappedReadsInPlace)
+{
+    make_map(100000).save(path);
+
+    auto mapped = U64Map::open_mapped(path);
+    EXPECT_EQ(mapped->size(), 80000);
+    expect_contents(*mapped, 100000);
+
+    // A copy is an ordinary writable map
+    U64Map copy = *mapped;
+    copy.insert(0, 1);
+    EXPECT_EQ(copy.at(0), 1);
+    EXPECT_FALSE(mapped->contains(0));
+}
+
+TEST_F(SerializationTest, CopyOnWriteLeavesFileUnchanged)
+{
+    make_map(1000).save(path);
+
+    {
+        U64Map map = U64Map::open_mapped_copy_on_write(path);
+        map.erase(1);
+        map.insert(0, 42);
+        EXPECT_EQ(map.at(0), 42);
+
+        // Growth moves the table off the mapping
+        for (uint64_t key = 1000; key < 20000; ++key)
+        {
+            map.insert(key, key * 7);
+        }
+        EXPECT_EQ(map.at(0), 42);
+        EXPECT_FALSE(map.contains(1));
+        EXPECT_EQ(map.at(19999), 19999 * 7);
+    }
+
+    auto mapped = U64Map::open_mapped(path);
+    expect_contents(*mapped, 1000);
+}
+
+TEST_F(SerializationTest, RejectsOtherMapTypesAndCorruptFiles)
+{
+    make_map(100).save(path);
+
+    using StoredHashMap = optimap::HashMap<uint64_t, uint64_t, optimap::GxHash<uint64_t>, true>;
+    EXPECT_THROW(StoredHashMap::open_mapped(path), std::runtime_error);
+    EXPECT_THROW((optimap::HashMap<uint32_t, uint32_t>::open_mapped(path)), std::runtime_error);
+
+    std::stringstream stream;
+    make_map(100).write_to(stream);
+    std::string bytes = stream.str();
+
+    std::stringstream truncated(bytes.substr(0, bytes.size() / 2));
+    EXPECT_THROW(U64Map::read_from(truncated), std::runtime_error);
+
+    bytes[0] = 'X';
+    std::stringstream bad_magic(bytes);
+    EXPECT_THROW(U64Map::read_from(bad_magic), std::runtime_error);
+
+    EXPECT_THROW(U64Map::open_mapped(path + ".missing"), std::runtime_error);
+
+    // Counts that leave no empty slot, or that only pass the fill check by wrapping, would make
+    // probes for absent keys run forever
+    const std::string good = stream.str();
+    const auto with_counts = [&good](uint64_t size, uint64_t tombstones) {
+        optimap::detail::TableFileHeader header;
+        std::memcpy(&header, good.data(), sizeof(header));
+        header.size = size;
+        header.tombstones = tombstones;
+        std::string corrupt = good;
+        std::memcpy(corrupt.data(), &header, sizeof(header));
+        return corrupt;
+    };
+    optimap::detail::TableFileHeader header;
+    std::memcpy(&header, good.data(), sizeof(header));
+    for (const auto& [size, tombstones] : {
+                 std::pair{header.capacity - header.tombstones, header.tombstones},
+                 std::pair{header.capacity - header.capacity / 8 + 1, uint64_t{0}},
+                 std::pair{UINT64_MAX, uint64_t{2}},
+         })
+    {
+        const std::string corrupt = with_counts(size, tombstones);
+        std::stringstream corrupt_stream(corrupt);
+        EXPECT_THROW(U64Map::read_from(corrupt_stream), std::runtime_error) << size;
+
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << corrupt;
+        EXPECT_THROW(U64Map::open_mapped(path), std::runtime_error) << size;
+    }
+
+    // At the max load the header is still accepted
+    std::stringstream full_stream(with_counts(header.capacity - header.capacity / 8, 0));
+    EXPECT_NO_THROW(U64Map::read_from(full_stream));
+}
@@ -0,0 +1,146 @@
+#include "sharded_hashmap.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ShardedHashMapTest, BasicOperations)
+{
+    optimap::ShardedHashMap<std::string, int> map;
+    EXPECT_TRUE(map.empty());
+
+    EXPECT_TRUE(map.insert("one", 1));
+    EXPECT_TRUE(map.insert("two", 2));
+    EXPECT_FALSE(map.insert("one", 100));
+    EXPECT_EQ(map.size(), 2);
+
+    EXPECT_EQ(map.find("one"), 1);
+    EXPECT_EQ(map.find("three"), std::nullopt);
+    EXPECT_TRUE(map.contains("two"));
+
+    EXPECT_FALSE(map.insert_or_assign("one", 10));
+    EXPECT_TRUE(map.insert_or_assign("three", 3));
+    EXPECT_EQ(map.find("one"), 10);
+
+    EXPECT_TRUE(map.visit("two", [](int& value) { value *= 10; }));
+    EXPECT_FALSE(map.visit("four", [](int&) { FAIL(); }));
+    EXPECT_EQ(map.find("two"), 20);
+
+    EXPECT_TRUE(map.erase("two"));
+    EXPECT_FALSE(map.erase("two"));
+    EXPECT_EQ(map.size(), 2);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+}
+
+TEST(ShardedHashMapTest, ForEachVisitsEveryShard)
+{
+    optimap::ShardedHashMap<int, int, optimap::GxHash<int>, 8> map(1000);
+    for (int i = 0; i < 1000; ++i)
+    {
+        map.insert(i, i);
+    }
+
+    std::vector<int> seen(1000, 0);
+    map.for_each([&](const int& key, int& value) {
+        ++seen[key];
+        value = -value;
+    });
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(seen[i], 1);
+        EXPECT_EQ(map.find(i), -i);
+    }
+
+    // Keys spread over all shards
+    std::vector<int> per_shard(map.shard_count(), 0);
+    for (int i = 0; i < 1000; ++i)
+    {
+        ++per_shard[decltype(map)::shard_index(i)];
+    }
+    for (int count : per_shard)
+    {
+        EXPECT_GT(count, 0);
+    }
+}
+
+TEST(ShardedHashMapTest, ConcurrentWritersAndReaders)
+{
+    optimap::ShardedHashMap<uint64_t, uint64_t> map;
+    constexpr int kThreads = 8;
+    constexpr uint64_t kKeysPerThread = 20000;
+
+    std::atomic<bool> stop = false;
+    std::atomic<uint64_t> bad_reads = 0;
+    std::thread reader([&] {
+        while (!stop.load())
+        {
+            for (uint64_t key = 0; key < 1000; ++key)
+            {
+                // Values are always 2 * key once visible
+                if (auto value = map.find(key); value && *value != 2 * key)
+                {
+                    bad_reads.fetch_add(1);
+                }
+            }
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        writers.emplace_back([&, t] {
+            for (uint64_t i = 0; i < kKeysPerThread; ++i)
+            {
+                const uint64_t key = i * kThreads + t;
+                map.insert(key, 2 * key);
+                // Counter shared between all writers, updated under the shard lock
+                map.insert_or_assign(UINT64_MAX, 0);
+            }
+        });
+    }
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+    stop = true;
+    reader.join();
+
+    EXPECT_EQ(bad_reads.load(), 0);
+    EXPECT_EQ(map.size(), kThreads * kKeysPerThread + 1);
+    for (uint64_t key = 0; key < kThreads * kKeysPerThread; ++key)
+    {
+        ASSERT_EQ(map.find(key), 2 * key);
+    }
+}
+
+TEST(ShardedHashMapTest, ConcurrentVisitIsAtomicPerKey)
+{
+    optimap::ShardedHashMap<int, int> map;
+    for (int key = 0; key < 16; ++key)
+    {
+        map.insert(key, 0);
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i)
+            {
+                map.visit(i % 16, [](int& value) { ++value; });
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    int total = 0;
+    map.for_each([&](const int&, const int& value) { total += value; });
+    EXPECT_EQ(total, 8 * 10000);
+}
@@ -0,0 +1,183 @@
+#include "small_hashmap.hpp"
+#include "test_util.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+using test_util::expect_matches;
+
+TEST(SmallHashMapTest, BasicOperations)
+{
+    optimap::SmallHashMap<uint64_t, std::string, 4> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(1), map.end());
+    EXPECT_EQ(map.begin(), map.end());
+    EXPECT_EQ(map.capacity(), 4);
+
+    EXPECT_TRUE(map.insert(1, "one"));
+    EXPECT_FALSE(map.insert(1, "uno"));
+    EXPECT_TRUE(map.emplace(2, "two").second);
+    EXPECT_EQ(map.at(1), "one");
+    EXPECT_THROW(map.at(3), std::out_of_range);
+
+    EXPECT_FALSE(map.insert_or_assign(1, "uno").second);
+    map[4] = "four";
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map.at(1), "uno");
+    EXPECT_FALSE(map.spilled());
+
+    EXPECT_TRUE(map.erase(2));
+    EXPECT_FALSE(map.erase(2));
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.at(4), "four");
+}
+
+// A wider key converts to Key before the inline search, as HashMap does, so 2^32 + 1 is the
+// uint32_t key 1 already stored
+TEST(SmallHashMapTest, NarrowingKeyConvertsBeforeLookup)
+{
+    optimap::SmallHashMap<uint32_t, int, 4> map;
+    uint64_t wide = (uint64_t{1} << 32) + 1;
+    EXPECT_TRUE(map.try_emplace(uint32_t{1}, 1).second);
+    EXPECT_FALSE(map.try_emplace(wide, 2).second);
+    EXPECT_FALSE(map.emplace(wide, 3).second);
+    EXPECT_EQ(map.size(), 1);
+    EXPECT_EQ(map.at(1), 1);
+}
+
+// Entry InlineCapacity + 1 moves everything into a table, which is kept after clear()
+TEST(SmallHashMapTest, SpillsPastInlineCapacity)
+{
+    optimap::SmallHashMap<uint64_t, uint64_t, 8> map;
+    std::unordered_map<uint64_t, uint64_t> reference;
+    for (uint64_t key = 0; key < 8; ++key)
+    {
+        map.insert(key * 7, key);
+        reference.emplace(key * 7, key);
+    }
+    EXPECT_FALSE(map.spilled());
+    expect_matches(map, reference);
+
+    EXPECT_TRUE(map.insert(1000, 1));
+    reference.emplace(1000, 1);
+    EXPECT_TRUE(map.spilled());
+    EXPECT_GE(map.capacity(), 16);
+    expect_matches(map, reference);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.spilled());
+    EXPECT_TRUE(map.insert(5, 5));
+    EXPECT_EQ(map.at(5), 5);
+
+    optimap::SmallHashMap<uint64_t, uint64_t, 8> reserved;
+    reserved.reserve(4);
+    EXPECT_FALSE(reserved.spilled());
+    reserved.reserve(100);
+    EXPECT_TRUE(reserved.spilled());
+    EXPECT_GE(reserved.capacity(), 100);
+}
+
+// Keys that are hashed use the inline control bytes to pick candidates
+TEST(SmallHashMapTest, RandomOperationsMatchReference)
+{
+    optimap::SmallHashMap<std::string, int, 8> map;
+    std::unordered_map<std::string, int> reference;
+    std::mt19937_64 rng(29);
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        const std::string key = std::to_string(rng() % 12);
+        if (rng() % 2 == 0)
+        {
+            ASSERT_EQ(map.erase(key), reference.erase(key) == 1);
+        }
+        else
+        {
+            ASSERT_EQ(map.insert(key, step), reference.emplace(key, step).second);
+        }
+        ASSERT_EQ(map.size(), reference.size());
+        if (!map.spilled())
+        {
+            expect_matches(map, reference);
+        }
+    }
+    expect_matches(map, reference);
+}
+
+TEST(SmallHashMapTest, EraseWhileIterating)
+{
+    for (const uint64_t count : {uint64_t{6}, uint64_t{40}})
+    {
+        optimap::SmallHashMap<uint64_t, uint64_t, 8> map;
+        std::unordered_map<uint64_t, uint64_t> reference;
+        for (uint64_t key = 0; key < count; ++key)
+        {
+            map.insert(key, key);
+            reference.emplace(key, key);
+        }
+
+        for (auto it = map.begin(); it != map.end();)
+        {
+            if (it->first % 2 == 0)
+            {
+                it = map.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        std::erase_if(reference, [](const auto& entry) { return entry.first % 2 == 0; });
+        expect_matches(map, reference);
+    }
+}
+
+TEST(SmallHashMapTest, CopyAndMove)
+{
+    for (const int count : {3, 20})
+    {
+        optimap::SmallHashMap<int, std::string, 4> map;
+        std::unordered_map<int, std::string> reference;
+        for (int key = 0; key < count; ++key)
+        {
+            map.insert(key, std::to_string(key));
+            reference.emplace(key, std::to_string(key));
+        }
+
+        auto copy = map;
+        expect_matches(copy, reference);
+
+        auto moved = std::move(copy);
+        expect_matches(moved, reference);
+        EXPECT_TRUE(copy.empty());
+
+        map.clear();
+        map = moved;
+        expect_matches(map, reference);
+        moved = std::move(map);
+        expect_matches(moved, reference);
+    }
+}
+
+TEST(SmallHashMapTest, HeterogeneousLookup)
+{
+    optimap::SmallHashMap<std::string, int> map;
+    for (int i = 0; i < 8; ++i)
+    {
+        map.insert(std::to_string(i), i);
+    }
+    EXPECT_EQ(map.find(std::string_view("5"))->second, 5);
+    EXPECT_FALSE(map.contains(std::string_view("8")));
+
+    map.insert("8", 8);
+    ASSERT_TRUE(map.spilled());
+    EXPECT_TRUE(map.contains(std::string_view("8")));
+    EXPECT_EQ(map.find(std::string_view("3"))->second, 3);
+}
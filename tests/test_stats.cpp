@@ -0,0 +1,89 @@
+#include "hashmap.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <numeric>
+
+namespace
+{
+    constexpr size_t kGroupWidth = optimap::detail::kGroupWidth;
+
+    // Sends every key to the same home slot
+    struct ConstantHash
+    {
+        size_t operator()(uint64_t) const noexcept
+        {
+            return 0;
+        }
+    };
+} // namespace
+
+TEST(TableStatsTest, EmptyTable)
+{
+    optimap::HashMap<uint64_t, uint64_t> map;
+    const auto stats = map.stats();
+    EXPECT_EQ(stats.size, 0);
+    EXPECT_EQ(stats.sampled_keys, 0);
+    EXPECT_EQ(stats.occupied_groups, 0);
+    EXPECT_EQ(stats.mean_probe_length, 0);
+}
+
+TEST(TableStatsTest, ReportsOccupancyAndTombstones)
+{
+    optimap::HashMap<uint64_t, uint64_t> map;
+    for (uint64_t key = 0; key < 10000; ++key)
+    {
+        map.insert(key, key);
+    }
+    for (uint64_t key = 0; key < 1000; ++key)
+    {
+        map.erase(key);
+    }
+
+    const auto stats = map.stats(100000);
+    EXPECT_EQ(stats.size, 9000);
+    EXPECT_EQ(stats.capacity, map.capacity());
+    EXPECT_DOUBLE_EQ(stats.load_factor, 9000.0 / map.capacity());
+    EXPECT_DOUBLE_EQ(stats.tombstone_factor, double(stats.tombstones) / map.capacity());
+    EXPECT_EQ(stats.groups, map.capacity() / kGroupWidth);
+    EXPECT_LE(stats.occupied_groups, stats.groups);
+    EXPECT_GT(stats.occupied_groups, stats.groups * 9 / 10);
+
+    // Every entry is sampled when the sample covers the table, and almost all are found in
+    // their home group with a good hash
+    EXPECT_EQ(stats.sampled_keys, 9000);
+    const auto& histogram = stats.probe_length_histogram;
+    EXPECT_EQ(std::accumulate(histogram.begin(), histogram.end(), size_t{0}), 9000);
+    EXPECT_GT(histogram[0], 9000 * 3 / 4);
+    EXPECT_GE(stats.mean_probe_length, 1.0);
+    EXPECT_LT(stats.mean_probe_length, 1.5);
+}
+
+TEST(TableStatsTest, SampleSizeBoundsTheScan)
+{
+    optimap::HashMap<uint64_t, uint64_t> map;
+    for (uint64_t key = 0; key < 50000; ++key)
+    {
+        map.insert(key, key);
+    }
+    EXPECT_EQ(map.stats(64).sampled_keys, 64);
+    EXPECT_EQ(map.stats(0).sampled_keys, 0);
+}
+
+// A degenerate hash shows up as long probes: the i-th colliding key sits i / group width groups
+// past the shared home slot
+TEST(TableStatsTest, CollidingHashProducesLongProbes)
+{
+    optimap::HashMap<uint64_t, uint64_t, ConstantHash> map;
+    const uint64_t count = kGroupWidth * 20;
+    for (uint64_t key = 0; key < count; ++key)
+    {
+        map.insert(key, key);
+    }
+
+    const auto stats = map.stats(count);
+    EXPECT_EQ(stats.max_probe_length, 20);
+    EXPECT_DOUBLE_EQ(stats.mean_probe_length, 10.5);
+    EXPECT_EQ(stats.probe_length_histogram[0], kGroupWidth);
+    EXPECT_EQ(stats.probe_length_histogram.back(), kGroupWidth * 5);
+}
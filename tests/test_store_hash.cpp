@@ -0,0 +1,141 @@
+#include "hashmap.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+// Counts hash calls to check that a StoreHash map never rehashes keys it already holds
+struct StoreHashCountingHash
+{
+    static inline size_t calls = 0;
+
+    size_t operator()(const std::string& key) const
+    {
+        ++calls;
+        return optimap::GxHash<std::string>{}(key);
+    }
+};
+
+// Key whose equality is counted, hashed so that every key shares one h2 fingerprint and probe
+// start. Only the cached full hash can then tell keys apart without calling ==
+struct ComparedKey
+{
+    static inline size_t comparisons = 0;
+
+    int value;
+
+    bool operator==(const ComparedKey& other) const
+    {
+        ++comparisons;
+        return value == other.value;
+    }
+};
+
+struct SameFingerprintHash
+{
+    size_t operator()(const ComparedKey& key) const
+    {
+        // Distinct low bits above the probe start, identical h1 low bits and h2
+        return static_cast<size_t>(key.value) << 20;
+    }
+};
+
+TEST(StoreHashTest, GrowthAndRehashDoNotCallHash)
+{
+    optimap::HashMap<std::string, int, StoreHashCountingHash, true> map;
+
+    StoreHashCountingHash::calls = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        map.insert("key number " + std::to_string(i), i);
+    }
+    // One hash per insert, none for the migrations in between
+    EXPECT_EQ(StoreHashCountingHash::calls, 1000);
+
+    StoreHashCountingHash::calls = 0;
+    map.rehash(map.capacity() * 4);
+    EXPECT_EQ(StoreHashCountingHash::calls, 0);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(map.at("key number " + std::to_string(i)), i);
+    }
+}
+
+TEST(StoreHashTest, CopyAndTombstoneCleanupDoNotCallHash)
+{
+    optimap::HashMap<std::string, int, StoreHashCountingHash, true> map;
+    for (int i = 0; i < 500; ++i)
+    {
+        map.insert(std::to_string(i), i);
+    }
+
+    StoreHashCountingHash::calls = 0;
+    const auto copy = map;
+    EXPECT_EQ(StoreHashCountingHash::calls, 0);
+    EXPECT_EQ(copy.size(), 500);
+
+    // Churn so that tombstones fill the table and get reclaimed in place
+    const size_t initial_capacity = map.capacity();
+    for (int i = 500; i < 20000; ++i)
+    {
+        map.erase(std::to_string(i - 500));
+        map.insert(std::to_string(i), i);
+    }
+    EXPECT_EQ(map.capacity(), initial_capacity);
+
+    // Each erase and insert hashes its argument once; reclaiming tombstones adds nothing
+    StoreHashCountingHash::calls = 0;
+    for (int i = 19500; i < 20000; ++i)
+    {
+        EXPECT_EQ(map.at(std::to_string(i)), i);
+    }
+    EXPECT_EQ(StoreHashCountingHash::calls, 500);
+}
+
+TEST(StoreHashTest, StoredHashFiltersKeyComparisons)
+{
+    optimap::HashMap<ComparedKey, int, SameFingerprintHash, true> stored;
+    optimap::HashMap<ComparedKey, int, SameFingerprintHash> plain;
+    for (int i = 0; i < 8; ++i)
+    {
+        stored.insert(ComparedKey{i}, i);
+        plain.insert(ComparedKey{i}, i);
+    }
+
+    ComparedKey::comparisons = 0;
+    EXPECT_EQ(stored.at(ComparedKey{7}), 7);
+    EXPECT_FALSE(stored.contains(ComparedKey{100}));
+    EXPECT_EQ(ComparedKey::comparisons, 1);
+
+    ComparedKey::comparisons = 0;
+    EXPECT_EQ(plain.at(ComparedKey{7}), 7);
+    EXPECT_GT(ComparedKey::comparisons, 1);
+}
+
+TEST(StoreHashTest, BehavesLikeDefaultMap)
+{
+    optimap::HashMap<int, int, optimap::GxHash<int>, true> map;
+    for (int i = 0; i < 10000; ++i)
+    {
+        map[i] = i * 2;
+    }
+    for (int i = 0; i < 10000; i += 2)
+    {
+        EXPECT_TRUE(map.erase(i));
+    }
+
+    EXPECT_EQ(map.size(), 5000);
+    for (int i = 0; i < 10000; ++i)
+    {
+        auto it = map.find(i);
+        if (i % 2 == 0)
+        {
+            EXPECT_EQ(it, map.end());
+        }
+        else
+        {
+            ASSERT_NE(it, map.end());
+            EXPECT_EQ(it->second, i * 2);
+        }
+    }
+}
@@ -0,0 +1,220 @@
+#include "string_hashmap.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+TEST(StringHashMapTest, BasicOperations)
+{
+    optimap::StringHashMap<int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find("a"), map.end());
+
+    EXPECT_TRUE(map.insert("alpha", 1));
+    EXPECT_FALSE(map.insert(std::string("alpha"), 2));
+    EXPECT_TRUE(map.insert(std::string_view("beta"), 2));
+    EXPECT_EQ(map.at("alpha"), 1);
+    EXPECT_THROW(map.at("gamma"), std::out_of_range);
+
+    EXPECT_FALSE(map.insert_or_assign("alpha", 10));
+    EXPECT_TRUE(map.insert_or_assign("gamma", 3));
+    EXPECT_EQ(map.at("alpha"), 10);
+
+    map["delta"] += 4;
+    map["delta"] += 4;
+    EXPECT_EQ(map.at("delta"), 8);
+    EXPECT_EQ(map.size(), 4);
+
+    auto it = map.find("beta");
+    ASSERT_NE(it, map.end());
+    EXPECT_EQ(it->first.view(), "beta");
+    const std::string_view key = it->first;
+    EXPECT_EQ(key, "beta");
+
+    EXPECT_TRUE(map.erase("beta"));
+    EXPECT_FALSE(map.erase("beta"));
+    EXPECT_FALSE(map.contains("beta"));
+    EXPECT_EQ(map.size(), 3);
+}
+
+// Keys that share a length and their first four bytes, and keys of up to four bytes whose
+// prefix is the whole key, must still be told apart
+TEST(StringHashMapTest, DistinguishesKeysWithEqualPrefixes)
+{
+    optimap::StringHashMap<int> map;
+    const std::vector<std::string> keys = {
+            "",
+            "a",
+            std::string("a\0", 2),
+            "ab",
+            "abcd",
+            "abce",
+            "abcdefgh",
+            "abcdefgi",
+            "abcd" + std::string(100, 'x'),
+            "abcd" + std::string(99, 'x') + "y",
+    };
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        ASSERT_TRUE(map.insert(keys[i], static_cast<int>(i))) << i;
+    }
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        auto it = map.find(keys[i]);
+        ASSERT_NE(it, map.end()) << i;
+        EXPECT_EQ(it->second, static_cast<int>(i));
+        EXPECT_EQ(it->first.view(), keys[i]);
+    }
+    EXPECT_FALSE(map.contains("abc"));
+    EXPECT_FALSE(map.contains("abcdefgj"));
+}
+
+TEST(StringHashMapTest, RandomOperationsMatchReference)
+{
+    optimap::StringHashMap<uint64_t> map;
+    std::unordered_map<std::string, uint64_t> reference;
+    std::mt19937_64 rng(23);
+
+    auto make_key = [&](uint64_t n) {
+        // Lengths from 0 to 80, so keys span short inline prefixes and several arena chunks
+        std::string key = "https://example.com/" + std::to_string(n);
+        key.resize(n % 81, '/');
+        return key;
+    };
+
+    for (int step = 0; step < 100000; ++step)
+    {
+        const std::string key = make_key(rng() % 3000);
+        switch (rng() % 3)
+        {
+        case 0:
+            EXPECT_EQ(map.insert(key, step), reference.emplace(key, step).second);
+            break;
+        case 1:
+            EXPECT_EQ(map.insert_or_assign(key, step), !reference.contains(key));
+            reference[key] = step;
+            break;
+        default:
+            EXPECT_EQ(map.erase(key), reference.erase(key) == 1);
+            break;
+        }
+        ASSERT_EQ(map.size(), reference.size());
+    }
+
+    for (const auto& [key, value] : reference)
+    {
+        auto it = map.find(key);
+        ASSERT_NE(it, map.end());
+        EXPECT_EQ(it->second, value);
+    }
+    for (const auto& entry : map)
+    {
+        EXPECT_TRUE(reference.contains(std::string(entry.first.view())));
+    }
+}
+
+TEST(StringHashMapTest, KeysSurviveGrowthAndMoves)
+{
+    optimap::StringHashMap<size_t> map;
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        keys.push_back(std::string(i % 300, 'k') + std::to_string(i));
+        map.insert(keys.back(), i);
+    }
+
+    optimap::StringHashMap<size_t> moved(std::move(map));
+    optimap::StringHashMap<size_t> assigned;
+    assigned.insert("stale", 0);
+    assigned = std::move(moved);
+
+    ASSERT_EQ(assigned.size(), keys.size());
+    EXPECT_FALSE(assigned.contains("stale"));
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        ASSERT_EQ(assigned.at(keys[i]), i);
+    }
+}
+
+// A copy owns its own arena: it stays valid after the source is destroyed
+TEST(StringHashMapTest, CopyStoresKeysInItsOwnArena)
+{
+    auto source = std::make_unique<optimap::StringHashMap<std::string>>();
+    for (int i = 0; i < 1000; ++i)
+    {
+        source->insert("key-" + std::to_string(i), std::to_string(i));
+    }
+
+    optimap::StringHashMap<std::string> copy(*source);
+    optimap::StringHashMap<std::string> assigned;
+    assigned = *source;
+    EXPECT_EQ(copy.arena_bytes(), source->arena_bytes());
+    source.reset();
+
+    ASSERT_EQ(copy.size(), 1000);
+    ASSERT_EQ(assigned.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(copy.at("key-" + std::to_string(i)), std::to_string(i));
+        EXPECT_EQ(assigned.at("key-" + std::to_string(i)), std::to_string(i));
+    }
+}
+
+TEST(StringHashMapTest, ArenaGrowsOnlyOnInsertionAndClearFreesIt)
+{
+    optimap::StringHashMap<int> map;
+    const std::string long_key(10000, 'L');
+
+    map.insert("hello", 1);
+    map.insert("hello", 2);
+    map.try_emplace("hello", 3);
+    map["hello"] = 4;
+    EXPECT_EQ(map.arena_bytes(), 5);
+
+    EXPECT_FALSE(map.contains("world"));
+    EXPECT_EQ(map.find("world"), map.end());
+    EXPECT_EQ(map.arena_bytes(), 5);
+
+    map.insert(long_key, 5);
+    EXPECT_EQ(map.arena_bytes(), 5 + long_key.size());
+    EXPECT_GE(map.arena_capacity(), map.arena_bytes());
+
+    // Erased keys keep their bytes until clear()
+    map.erase("hello");
+    EXPECT_EQ(map.arena_bytes(), 5 + long_key.size());
+
+    const size_t capacity = map.capacity();
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.arena_bytes(), 0);
+    EXPECT_EQ(map.arena_capacity(), 0);
+    EXPECT_EQ(map.capacity(), capacity);
+
+    EXPECT_TRUE(map.insert(long_key, 6));
+    EXPECT_EQ(map.at(long_key), 6);
+}
+
+TEST(StringHashMapTest, StoredHashVariant)
+{
+    optimap::StringHashMap<int, optimap::GxHash<std::string_view>, true> map;
+    for (int i = 0; i < 5000; ++i)
+    {
+        map.insert(std::to_string(i) + std::string(40, '.'), i);
+    }
+    for (int i = 0; i < 5000; ++i)
+    {
+        EXPECT_EQ(map.at(std::to_string(i) + std::string(40, '.')), i);
+    }
+}
+
+TEST(StringHashMapTest, SlotIsSmallerThanStdString)
+{
+    EXPECT_EQ(sizeof(optimap::StringHashMap<int>::key_type), 16);
+    EXPECT_LT(sizeof(optimap::StringHashMap<int>::key_type), sizeof(std::string));
+}
@@ -0,0 +1,109 @@
+#include "hashmap.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <unordered_map>
+
+// Sends keys to a handful of probe start positions so that relocation during tombstone cleanup
+// has to move entries across groups
+struct ClusteringHash
+{
+    size_t operator()(uint64_t key) const
+    {
+        const size_t h2_part = static_cast<size_t>(key % 127) << (sizeof(size_t) * 8 - 7);
+        return h2_part | ((key % 5) * 37);
+    }
+};
+
+TEST(TombstoneTest, SteadyStateChurnDoesNotGrow)
+{
+    optimap::HashMap<uint64_t, uint64_t> map;
+    const uint64_t live = 1000;
+
+    for (uint64_t key = 0; key < live; ++key)
+    {
+        map.insert(key, key);
+    }
+    const size_t initial_capacity = map.capacity();
+
+    // Sliding window: every step erases the oldest key and inserts a new one
+    for (uint64_t key = live; key < 200 * live; ++key)
+    {
+        ASSERT_TRUE(map.erase(key - live));
+        ASSERT_TRUE(map.insert(key, key));
+    }
+
+    EXPECT_EQ(map.size(), live);
+    EXPECT_EQ(map.capacity(), initial_capacity);
+
+    for (uint64_t key = 199 * live; key < 200 * live; ++key)
+    {
+        auto it = map.find(key);
+        ASSERT_NE(it, map.end());
+        EXPECT_EQ(it->second, key);
+    }
+
+    // Misses must still terminate once the table has been churned through many times
+    EXPECT_EQ(map.find(0), map.end());
+    EXPECT_FALSE(map.contains(live));
+}
+
+TEST(TombstoneTest, ChurnWithOperatorBracket)
+{
+    optimap::HashMap<int, int> map;
+    for (int key = 0; key < 100; ++key)
+    {
+        map[key] = key;
+    }
+    const size_t initial_capacity = map.capacity();
+
+    for (int key = 100; key < 100000; ++key)
+    {
+        map.erase(key - 100);
+        map[key] = key;
+    }
+
+    EXPECT_EQ(map.size(), 100);
+    EXPECT_EQ(map.capacity(), initial_capacity);
+    for (int key = 99900; key < 100000; ++key)
+    {
+        EXPECT_EQ(map.at(key), key);
+    }
+}
+
+TEST(TombstoneTest, RandomOperationsMatchReference)
+{
+    optimap::HashMap<uint64_t, uint64_t, ClusteringHash> map;
+    std::unordered_map<uint64_t, uint64_t> reference;
+    std::mt19937_64 rng(7);
+
+    for (int step = 0; step < 50000; ++step)
+    {
+        const uint64_t key = rng() % 300;
+        if (rng() % 2 == 0)
+        {
+            EXPECT_EQ(map.insert(key, step), reference.emplace(key, step).second);
+        }
+        else
+        {
+            EXPECT_EQ(map.erase(key), reference.erase(key) == 1);
+        }
+        ASSERT_EQ(map.size(), reference.size());
+    }
+
+    for (uint64_t key = 0; key < 300; ++key)
+    {
+        auto it = map.find(key);
+        auto ref = reference.find(key);
+        if (ref == reference.end())
+        {
+            EXPECT_EQ(it, map.end());
+        }
+        else
+        {
+            ASSERT_NE(it, map.end());
+            EXPECT_EQ(it->second, ref->second);
+        }
+    }
+}
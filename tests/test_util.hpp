@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <gtest/gtest.h>
+
+// Checks shared by the container tests against a std:: reference container
+namespace test_util
+{
+    // map holds exactly reference's entries, by iteration and by lookup
+    template <typename Map, typename Reference>
+    void expect_matches(const Map& map, const Reference& reference)
+    {
+        ASSERT_EQ(map.size(), reference.size());
+        size_t visited = 0;
+        for (const auto& entry : map)
+        {
+            auto it = reference.find(entry.first);
+            ASSERT_NE(it, reference.end()) << entry.first;
+            EXPECT_EQ(entry.second, it->second);
+            ++visited;
+        }
+        EXPECT_EQ(visited, reference.size());
+        for (const auto& [key, value] : reference)
+        {
+            ASSERT_TRUE(map.contains(key)) << key;
+            EXPECT_EQ(map.at(key), value);
+        }
+    }
+
+    // set holds exactly reference's keys, by iteration and by lookup
+    template <typename Set, typename Reference>
+    void expect_set_matches(const Set& set, const Reference& reference)
+    {
+        ASSERT_EQ(set.size(), reference.size());
+        size_t visited = 0;
+        for (const auto& key : set)
+        {
+            ASSERT_TRUE(reference.contains(key)) << key;
+            ++visited;
+        }
+        EXPECT_EQ(visited, reference.size());
+        for (const auto& key : reference)
+        {
+            ASSERT_TRUE(set.contains(key)) << key;
+        }
+    }
+} // namespace test_util